@@ -20,15 +20,20 @@
 #include "Backend.h"
 #include "LocaleUtils.h"
 #include "Log.h"
+#include "ScanRunner.h"
+#include "Trace.h"
 #include "platform/TerminalKbd.h"
 
 #include <QCommandLineParser>
 #include <QGuiApplication>
 #include <QIcon>
 #include <QSettings>
+#include <cstring>
 
 
-void handle_cli_args(QGuiApplication&);
+bool is_scan_only(int argc, char *argv[]);
+void set_app_info(QCoreApplication&);
+backend::ScanOptions handle_cli_args(QCoreApplication&);
 
 int main(int argc, char *argv[])
 {
@@ -38,11 +43,23 @@ int main(int argc, char *argv[])
     QCoreApplication::addLibraryPath(QStringLiteral("lib"));
     QSettings::setDefaultFormat(QSettings::IniFormat);
 
+    // the headless mode has to be known before creating the application
+    if (is_scan_only(argc, argv)) {
+        QCoreApplication app(argc, argv);
+        set_app_info(app);
+
+        backend::ScanOptions options = handle_cli_args(app);
+        Log::init();
+        AppSettings::load_config();
+
+        backend::ScanRunner runner(std::move(options));
+        runner.start();
+
+        return app.exec();
+    }
+
     QGuiApplication app(argc, argv);
-    app.setApplicationName(QStringLiteral("pegasus-frontend"));
-    app.setApplicationVersion(QStringLiteral(GIT_REVISION));
-    app.setOrganizationName(QStringLiteral("pegasus-frontend"));
-    app.setOrganizationDomain(QStringLiteral("pegasus-frontend.org"));
+    set_app_info(app);
     app.setWindowIcon(QIcon(QStringLiteral(":/icon.png")));
 
     handle_cli_args(app);
@@ -56,7 +73,24 @@ int main(int argc, char *argv[])
     return app.exec();
 }
 
-void handle_cli_args(QGuiApplication& app)
+bool is_scan_only(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--scan-only") == 0)
+            return true;
+    }
+    return false;
+}
+
+void set_app_info(QCoreApplication& app)
+{
+    app.setApplicationName(QStringLiteral("pegasus-frontend"));
+    app.setApplicationVersion(QStringLiteral(GIT_REVISION));
+    app.setOrganizationName(QStringLiteral("pegasus-frontend"));
+    app.setOrganizationDomain(QStringLiteral("pegasus-frontend.org"));
+}
+
+backend::ScanOptions handle_cli_args(QCoreApplication& app)
 {
     QCommandLineParser argparser;
     argparser.setApplicationDescription(tr_log(
@@ -72,6 +106,28 @@ void handle_cli_args(QGuiApplication& app)
         tr_log("Do not print log messages to the terminal"));
     argparser.addOption(arg_silent);
 
+    const QCommandLineOption arg_trace(QStringLiteral("trace-startup"),
+        tr_log("Record the duration of the startup steps, and write them to <file>\n"
+               "in the Chrome/Perfetto trace format"),
+        QStringLiteral("file"));
+    argparser.addOption(arg_trace);
+
+    const QCommandLineOption arg_scan_only(QStringLiteral("scan-only"),
+        tr_log("Search for the games without starting the user interface, then print\n"
+               "the duration of the search, the size of the library and the memory use"));
+    argparser.addOption(arg_scan_only);
+
+    const QCommandLineOption arg_repeat(QStringLiteral("repeat"),
+        tr_log("With --scan-only, run the search <count> times and print\n"
+               "the min/median/p95 durations"),
+        QStringLiteral("count"), QStringLiteral("1"));
+    argparser.addOption(arg_repeat);
+
+    const QCommandLineOption arg_dump_json(QStringLiteral("dump-json"),
+        tr_log("With --scan-only, write the found library to <file> as JSON"),
+        QStringLiteral("file"));
+    argparser.addOption(arg_dump_json);
+
     argparser.addHelpOption();
     argparser.addVersionOption();
     argparser.process(app); // may quit!
@@ -79,4 +135,12 @@ void handle_cli_args(QGuiApplication& app)
 
     AppSettings::general.portable = argparser.isSet(arg_portable);
     AppSettings::general.silent = argparser.isSet(arg_silent);
+
+    if (argparser.isSet(arg_trace))
+        Trace::start(argparser.value(arg_trace));
+
+    backend::ScanOptions scan_options;
+    scan_options.iterations = qMax(1, argparser.value(arg_repeat).toInt());
+    scan_options.json_path = argparser.value(arg_dump_json);
+    return scan_options;
 }
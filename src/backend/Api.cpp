@@ -17,14 +17,26 @@
 
 #include "Api.h"
 
+#include "AppSettings.h"
 #include "LocaleUtils.h"
+#include "Trace.h"
+#include "utils/MemoryUsage.h"
 
 
 ApiObject::ApiObject(QObject* parent)
     : QObject(parent)
+    , m_allGames(m_gameLibrary)
     , m_launch_game(nullptr)
     , m_providerman(this)
 {
+    m_providerman.setLazyAssetsEnabled(AppSettings::general.lazy_assets);
+
+    connect(&m_gameLibrary, &model::GameLibrary::launchRequested,
+            this, &ApiObject::onGameLaunchRequested);
+    // the favorites loaded in the background are not written back
+    connect(&m_gameLibrary, &model::GameLibrary::favoriteChanged,
+            this, &ApiObject::onGameFavoriteChanged, Qt::DirectConnection);
+
     connect(&m_memory, &model::Memory::dataChanged,
             this, &ApiObject::memoryChanged);
 
@@ -43,43 +55,87 @@ ApiObject::ApiObject(QObject* parent)
             &m_internal.meta(), &model::Meta::onSecondPhaseCompleted);
     connect(&m_providerman, &ProviderManager::staticDataReady,
             this, &ApiObject::onStaticDataLoaded);
+    connect(&m_providerman, &ProviderManager::thirdPhaseComplete,
+            &m_internal.meta(), &model::Meta::onThirdPhaseCompleted);
+    connect(&m_internal.meta(), &model::Meta::libraryRescanRequested,
+            this, &ApiObject::onRescanRequested);
+    connect(&m_providerman, &ProviderManager::thirdPhaseComplete,
+            this, &ApiObject::onScanFinished);
+    connect(&m_internal.meta(), &model::Meta::memoryUsageRefreshRequested,
+            this, &ApiObject::updateMemoryUsage);
 
     onThemeChanged();
 }
 
 void ApiObject::startScanning()
 {
+    m_internal.meta().onScanStarted();
     m_providerman.startSearch(m_allGames, m_collections);
 }
 
+void ApiObject::onRescanRequested()
+{
+    if (m_providerman.isSearching())
+        return;
+
+    m_internal.meta().onScanStarted();
+    m_providerman.startRescan();
+}
+
 void ApiObject::onStaticDataLoaded()
 {
     qInfo().noquote() << tr_log("%1 games found").arg(m_allGames.count());
 
-    for (model::Game* game : m_allGames) {
-        connect(game, &model::Game::launchRequested,
-                this, &ApiObject::onGameLaunchRequested);
-        connect(game, &model::Game::favoriteChanged,
-                this, &ApiObject::onGameFavoriteChanged);
-    }
+    updateMemoryUsage();
+    m_internal.meta().logMemoryUsage();
 
     m_internal.meta().onUiReady();
 }
 
-void ApiObject::onGameLaunchRequested()
+void ApiObject::onScanFinished()
+{
+    // the dynamic data has been added by now
+    updateMemoryUsage();
+
+    // the startup is complete when all data has been loaded; this slot is queued
+    // to the main thread after the search results have been applied there
+    Trace::finish();
+}
+
+void ApiObject::updateMemoryUsage()
+{
+    model::MemoryUsage usage;
+    usage.game_records = m_gameLibrary.recordsMemorySize();
+    usage.game_assets = m_gameLibrary.assetsMemorySize();
+    usage.game_objects = m_gameLibrary.objectsMemorySize();
+    usage.game_lists = m_allGames.heapSize();
+
+    usage.collections = static_cast<size_t>(m_collections.count()) * (sizeof(void*) + sizeof(model::Collection));
+    for (model::Collection* const collection : m_collections.asList()) {
+        usage.collections += collection->heapSize();
+        usage.collection_lists += collection->games().heapSize();
+    }
+
+    usage.theme_memory = m_memory.heapSize();
+    usage.process_resident = process_resident_size();
+
+    m_internal.meta().setMemoryUsage(usage);
+}
+
+void ApiObject::onGameLaunchRequested(model::Game* game)
 {
     // avoid launch spamming
     if (m_launch_game)
         return;
 
-    m_launch_game = static_cast<model::Game*>(QObject::sender());
+    m_launch_game = game;
     emit launchGame(m_launch_game);
 }
 
 void ApiObject::onGameLaunchOk()
 {
     Q_ASSERT(m_launch_game);
-    m_providerman.onGameLaunched(m_launch_game);
+    m_providerman.onGameLaunched(m_launch_game->slot());
 }
 
 void ApiObject::onGameLaunchError()
@@ -93,13 +149,13 @@ void ApiObject::onGameFinished()
 {
     Q_ASSERT(m_launch_game);
 
-    m_providerman.onGameFinished(m_launch_game);
+    m_providerman.onGameFinished(m_launch_game->slot());
     m_launch_game = nullptr;
 }
 
 void ApiObject::onGameFavoriteChanged()
 {
-    m_providerman.onGameFavoriteChanged(m_allGames.asList());
+    m_providerman.onGameFavoriteChanged();
 }
 
 void ApiObject::onThemeChanged()
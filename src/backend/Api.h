@@ -19,6 +19,8 @@
 
 #include "model/gaming/Collection.h"
 #include "model/gaming/Game.h"
+#include "model/gaming/GameLibrary.h"
+#include "model/gaming/GameListModel.h"
 #include "model/internal/Internal.h"
 #include "model/keys/Keys.h"
 #include "model/memory/Memory.h"
@@ -36,11 +38,14 @@
 class ApiObject : public QObject {
     Q_OBJECT
 
+    // the data of the games in the models below
+    model::GameLibrary m_gameLibrary;
+
     QML_CONST_PROPERTY(model::Internal, internal)
     QML_CONST_PROPERTY(model::Keys, keys)
     QML_READONLY_PROPERTY(model::Memory, memory)
     QML_OBJMODEL_PROPERTY(model::Collection, collections)
-    QML_OBJMODEL_PROPERTY(model::Game, allGames)
+    QML_CONST_PROPERTY(model::GameListModel, allGames)
 
     // retranslate on locale change
     Q_PROPERTY(QString tr READ emptyString NOTIFY localeChanged)
@@ -67,8 +72,11 @@ public slots:
 private slots:
     // internal communication
     void onStaticDataLoaded();
+    void onRescanRequested();
+    void onScanFinished();
+    void updateMemoryUsage();
     void onGameFavoriteChanged();
-    void onGameLaunchRequested();
+    void onGameLaunchRequested(model::Game*);
     void onThemeChanged();
 
 private:
@@ -73,6 +73,7 @@ General::General()
     , portable(false)
     , silent(false)
     , fullscreen(true)
+    , lazy_assets(false)
     , locale(DEFAULT_LOCALE)
     , theme(DEFAULT_THEME)
 {}
@@ -39,6 +39,8 @@ struct General {
     bool portable;
     bool silent;
     bool fullscreen;
+    /// Look up the media files of a game only when it's first shown
+    bool lazy_assets;
     QString locale;
     QString theme;
 
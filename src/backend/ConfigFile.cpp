@@ -18,6 +18,7 @@
 #include "ConfigFile.h"
 
 #include "LocaleUtils.h"
+#include "Trace.h"
 
 #include <QDebug>
 #include <QFile>
@@ -32,10 +33,14 @@ void readFile(const QString& path,
               const std::function<void(const int, const QString, const QString)>& onAttributeFound,
               const std::function<void(const int, const QString)>& onError)
 {
+    TRACE_SCOPE("read config file", path);
+
     QFile file(path);
     if (!file.open(QFile::ReadOnly | QFile::Text))
         return;
 
+    TRACE_COUNT("bytes read", file.size());
+
     QTextStream stream(&file);
     return readStream(stream, onAttributeFound, onError);
 }
@@ -45,6 +50,9 @@ void readFile(QFile& file,
               const std::function<void(const int, const QString)>& onError)
 {
     Q_ASSERT(file.isOpen() && file.isReadable());
+    TRACE_SCOPE("read config file", file.fileName());
+    TRACE_COUNT("bytes read", file.size());
+
     QTextStream stream(&file);
     return readStream(stream, onAttributeFound, onError);
 }
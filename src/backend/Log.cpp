@@ -23,6 +23,7 @@
 
 #include <QDateTime>
 #include <QFile>
+#include <QMutex>
 #include <QTextStream>
 
 
@@ -119,6 +120,9 @@ private:
 
 namespace {
 
+// the providers may log from multiple threads at the same time
+QMutex sink_guard;
+
 void on_qt_message(QtMsgType type, const QMessageLogContext& context, const QString& msg)
 {
     const QString prepared_msg = qFormatLogMessage(type, context, msg);
@@ -164,6 +168,7 @@ void Log::close()
 #define FORALLSINK_CALLER(method) \
     void Log::method(const QString& message) \
     { \
+        QMutexLocker lock(&sink_guard); \
         for (const auto& sink : m_sinks) \
             sink->method(message); \
     }
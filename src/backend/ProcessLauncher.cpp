@@ -31,10 +31,10 @@ namespace {
 void format_launch_command(QString& launch_cmd, const modeldata::Game& game)
 {
     launch_cmd
-        .replace(QLatin1String("{file.path}"), QDir::toNativeSeparators(game.fileinfo().absoluteFilePath()))
-        .replace(QLatin1String("{file.name}"), game.fileinfo().fileName())
-        .replace(QLatin1String("{file.basename}"), game.fileinfo().completeBaseName())
-        .replace(QLatin1String("{file.dir}"), QDir::toNativeSeparators(game.fileinfo().absolutePath()));
+        .replace(QLatin1String("{file.path}"), QDir::toNativeSeparators(game.path().absoluteFilePath()))
+        .replace(QLatin1String("{file.name}"), game.path().fileName())
+        .replace(QLatin1String("{file.basename}"), game.path().completeBaseName())
+        .replace(QLatin1String("{file.dir}"), QDir::toNativeSeparators(game.path().absoluteDirPath()));
 }
 } // namespace
 
@@ -68,7 +68,7 @@ void ProcessLauncher::onLaunchRequested(const model::Game* game)
 
     QString workdir = game->data().launch_workdir;
     if (workdir.isEmpty())
-        workdir = game->data().fileinfo().absolutePath();
+        workdir = game->data().path().absoluteDirPath();
 
 
     beforeRun();
@@ -0,0 +1,251 @@
+// Pegasus Frontend
+// Copyright (C) 2018  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#include "ScanRunner.h"
+
+#include "AppSettings.h"
+#include "LocaleUtils.h"
+#include "Trace.h"
+#include "model/gaming/Collection.h"
+#include "model/gaming/GameLibrary.h"
+#include "model/gaming/GameListModel.h"
+#include "providers/ProviderManager.h"
+
+#include "QtQmlTricks/QQmlObjectListModel.h"
+#include <QCoreApplication>
+#include <QDebug>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>
+#include <algorithm>
+
+#ifdef Q_OS_UNIX
+#include <sys/resource.h>
+#endif
+
+
+namespace {
+
+// The largest amount of memory the process had in the RAM, or -1 if unknown
+qint64 peak_rss_bytes()
+{
+#ifdef Q_OS_UNIX
+    struct ::rusage usage;
+    if (::getrusage(RUSAGE_SELF, &usage) != 0)
+        return -1;
+
+#ifdef Q_OS_MACOS
+    return static_cast<qint64>(usage.ru_maxrss);
+#else
+    return static_cast<qint64>(usage.ru_maxrss) * 1024;
+#endif
+#else
+    return -1;
+#endif
+}
+
+// Nearest-rank percentile of the values
+qint64 percentile(std::vector<qint64> values, int percent)
+{
+    Q_ASSERT(!values.empty());
+    std::sort(values.begin(), values.end());
+
+    const size_t rank = (values.size() * static_cast<size_t>(percent) + 99) / 100;
+    return values.at(rank > 0 ? rank - 1 : 0);
+}
+
+QJsonObject game_to_json(const modeldata::Game& game)
+{
+    QJsonObject obj;
+    obj.insert(QStringLiteral("title"), game.title);
+    obj.insert(QStringLiteral("path"), game.path().filePath());
+    if (!game.launch_cmd.isEmpty())
+        obj.insert(QStringLiteral("launch"), game.launch_cmd);
+    if (game.is_favorite)
+        obj.insert(QStringLiteral("favorite"), true);
+    if (game.playcount > 0)
+        obj.insert(QStringLiteral("playcount"), game.playcount);
+    return obj;
+}
+
+bool write_json(const QString& path,
+                const model::GameListModel& game_model,
+                const QQmlObjectListModel<model::Collection>& collection_model)
+{
+    const model::GameLibrary& game_library = game_model.library();
+
+    QJsonArray games;
+    for (const model::GameSlot slot : game_model.asList())
+        games.append(game_to_json(game_library.at(slot)));
+
+    QJsonArray collections;
+    for (model::Collection* const coll : collection_model.asList()) {
+        QJsonArray childs;
+        for (const model::GameSlot slot : coll->games().asList())
+            childs.append(game_library.at(slot).path().filePath());
+
+        QJsonObject obj;
+        obj.insert(QStringLiteral("name"), coll->name());
+        obj.insert(QStringLiteral("shortName"), coll->shortName());
+        obj.insert(QStringLiteral("games"), childs);
+        collections.append(obj);
+    }
+
+    QJsonObject root;
+    root.insert(QStringLiteral("games"), games);
+    root.insert(QStringLiteral("collections"), collections);
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+
+    return file.write(QJsonDocument(root).toJson()) >= 0;
+}
+
+} // namespace
+
+
+namespace backend {
+
+ScanOptions::ScanOptions()
+    : iterations(1)
+{}
+
+ScanRunner::Result::Result()
+    : first_phase_ms(0)
+    , second_phase_ms(0)
+    , third_phase_ms(0)
+    , total_ms(0)
+    , game_count(0)
+    , collection_count(0)
+{}
+
+ScanRunner::ScanRunner(ScanOptions options, QObject* parent)
+    : QObject(parent)
+    , m_options(std::move(options))
+{
+    m_results.reserve(static_cast<size_t>(std::max(1, m_options.iterations)));
+}
+
+ScanRunner::~ScanRunner()
+{
+    releaseLibrary();
+}
+
+void ScanRunner::start()
+{
+    QMetaObject::invokeMethod(this, "runIteration", Qt::QueuedConnection);
+}
+
+void ScanRunner::runIteration()
+{
+    m_current = Result();
+    m_game_library.reset(new model::GameLibrary());
+    m_game_model.reset(new model::GameListModel(*m_game_library));
+    m_collection_model.reset(new QQmlObjectListModel<model::Collection>());
+    m_providerman.reset(new ProviderManager(this));
+    m_providerman->setCachesEnabled(false);
+    m_providerman->setLazyAssetsEnabled(AppSettings::general.lazy_assets);
+
+    // the phase signals come from a background thread
+    connect(m_providerman.get(), &ProviderManager::firstPhaseComplete,
+            this, [this](qint64 ms){ m_current.first_phase_ms = ms; });
+    connect(m_providerman.get(), &ProviderManager::secondPhaseComplete,
+            this, [this](qint64 ms){ m_current.second_phase_ms = ms; });
+    connect(m_providerman.get(), &ProviderManager::thirdPhaseComplete,
+            this, &ScanRunner::onSearchFinished, Qt::QueuedConnection);
+
+    m_timer.start();
+    m_providerman->startSearch(*m_game_model, *m_collection_model);
+}
+
+void ScanRunner::onSearchFinished(qint64 third_phase_ms)
+{
+    m_current.third_phase_ms = third_phase_ms;
+    m_current.total_ms = m_timer.elapsed();
+    m_current.game_count = m_game_model->count();
+    m_current.collection_count = m_collection_model->count();
+    m_results.push_back(m_current);
+
+    QTextStream out(stdout);
+    out << tr_log("Iteration %1/%2: %3 games, %4 collections, phases %5 / %6 / %7 ms, total %8 ms")
+        .arg(QString::number(static_cast<int>(m_results.size())), QString::number(m_options.iterations),
+             QString::number(m_current.game_count), QString::number(m_current.collection_count),
+             QString::number(m_current.first_phase_ms), QString::number(m_current.second_phase_ms),
+             QString::number(m_current.third_phase_ms), QString::number(m_current.total_ms))
+        << endl;
+
+    const bool is_last = static_cast<int>(m_results.size()) >= m_options.iterations;
+    if (is_last && !m_options.json_path.isEmpty()) {
+        if (write_json(m_options.json_path, *m_game_model, *m_collection_model))
+            out << tr_log("Library written to `%1`").arg(m_options.json_path) << endl;
+        else
+            qWarning().noquote() << tr_log("Could not write the library to `%1`").arg(m_options.json_path);
+    }
+
+    releaseLibrary();
+
+    if (!is_last) {
+        QMetaObject::invokeMethod(this, "runIteration", Qt::QueuedConnection);
+        return;
+    }
+
+    printSummary();
+    Trace::finish();
+    QCoreApplication::quit();
+}
+
+void ScanRunner::releaseLibrary()
+{
+    // the manager may still be running background tasks that use the models
+    m_providerman.reset();
+    m_collection_model.reset();
+    m_game_model.reset();
+    m_game_library.reset();
+}
+
+void ScanRunner::printSummary() const
+{
+    const auto column = [this](qint64 Result::*field) -> QString {
+        std::vector<qint64> values;
+        values.reserve(m_results.size());
+        for (const Result& result : m_results)
+            values.push_back(result.*field);
+
+        return QStringLiteral("%1 %2 %3")
+            .arg(percentile(values, 0), 8)
+            .arg(percentile(values, 50), 8)
+            .arg(percentile(values, 95), 8);
+    };
+
+    QTextStream out(stdout);
+    out << endl
+        << tr_log("                     min   median      p95  (ms, %1 iterations)").arg(static_cast<int>(m_results.size())) << endl
+        << tr_log("first phase:    ") << column(&Result::first_phase_ms) << endl
+        << tr_log("second phase:   ") << column(&Result::second_phase_ms) << endl
+        << tr_log("third phase:    ") << column(&Result::third_phase_ms) << endl
+        << tr_log("total:          ") << column(&Result::total_ms) << endl;
+
+    const qint64 peak_rss = peak_rss_bytes();
+    if (peak_rss >= 0)
+        out << tr_log("peak RSS:       %1 MiB").arg(static_cast<double>(peak_rss) / (1024 * 1024), 0, 'f', 1) << endl;
+}
+
+} // namespace backend
@@ -0,0 +1,88 @@
+// Pegasus Frontend
+// Copyright (C) 2018  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#pragma once
+
+#include "utils/FwdDeclModel.h"
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QString>
+#include <memory>
+#include <vector>
+
+class ProviderManager;
+template<typename T> class QQmlObjectListModel;
+
+
+namespace backend {
+
+struct ScanOptions {
+    /// How many times the search should run
+    int iterations;
+    /// If not empty, the library found by the last search is written here as JSON
+    QString json_path;
+
+    ScanOptions();
+};
+
+
+/// Runs the game search without the frontend, then prints the duration of the phases,
+/// the size of the library and the peak memory use. The caches are not used,
+/// so every iteration reads everything from the disk.
+class ScanRunner : public QObject {
+    Q_OBJECT
+
+public:
+    explicit ScanRunner(ScanOptions, QObject* parent = nullptr);
+    ~ScanRunner();
+
+    /// Starts the first search; the application quits when all iterations are done
+    void start();
+
+private:
+    struct Result {
+        qint64 first_phase_ms;
+        qint64 second_phase_ms;
+        qint64 third_phase_ms;
+        qint64 total_ms;
+        int game_count;
+        int collection_count;
+
+        Result();
+    };
+
+    const ScanOptions m_options;
+    std::vector<Result> m_results;
+    Result m_current;
+    QElapsedTimer m_timer;
+
+    std::unique_ptr<model::GameLibrary> m_game_library;
+    std::unique_ptr<model::GameListModel> m_game_model;
+    std::unique_ptr<QQmlObjectListModel<model::Collection>> m_collection_model;
+    std::unique_ptr<ProviderManager> m_providerman;
+
+    void onSearchFinished(qint64 third_phase_ms);
+    void releaseLibrary();
+    void printSummary() const;
+
+private slots:
+    void runIteration();
+};
+
+} // namespace backend
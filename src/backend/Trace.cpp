@@ -0,0 +1,194 @@
+// Pegasus Frontend
+// Copyright (C) 2018  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "Trace.h"
+
+#include "LocaleUtils.h"
+#include "utils/HashMap.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QSaveFile>
+#include <QThread>
+#include <vector>
+
+
+namespace {
+static constexpr auto MSG_PREFIX = "Trace:";
+
+struct TraceEvent {
+    const char* name;
+    char phase;
+    int thread_idx;
+    qint64 timestamp;
+    qint64 value; // duration or counter value
+    QString detail;
+};
+
+// all of these are protected by `trace_guard`
+QMutex trace_guard;
+QString trace_path;
+QElapsedTimer trace_timer;
+std::vector<TraceEvent> trace_events;
+HashMap<Qt::HANDLE, int> thread_idxs;
+HashMap<QLatin1String, qint64> counter_values;
+
+int current_thread_idx()
+{
+    const Qt::HANDLE thread_id = QThread::currentThreadId();
+
+    const auto it = thread_idxs.find(thread_id);
+    if (it != thread_idxs.cend())
+        return it->second;
+
+    const int idx = static_cast<int>(thread_idxs.size());
+    thread_idxs.emplace(thread_id, idx);
+    return idx;
+}
+
+QJsonObject thread_name_event(const int thread_idx)
+{
+    const QString thread_name = thread_idx == 0
+        ? QStringLiteral("main")
+        : QStringLiteral("worker %1").arg(thread_idx);
+
+    return QJsonObject {
+        { QStringLiteral("name"), QStringLiteral("thread_name") },
+        { QStringLiteral("ph"), QStringLiteral("M") },
+        { QStringLiteral("pid"), 1 },
+        { QStringLiteral("tid"), thread_idx },
+        { QStringLiteral("args"), QJsonObject {{ QStringLiteral("name"), thread_name }} },
+    };
+}
+
+QJsonObject to_json(const TraceEvent& event)
+{
+    QJsonObject json {
+        { QStringLiteral("name"), QString::fromLatin1(event.name) },
+        { QStringLiteral("ph"), QString(QLatin1Char(event.phase)) },
+        { QStringLiteral("pid"), 1 },
+        { QStringLiteral("tid"), event.thread_idx },
+        { QStringLiteral("ts"), event.timestamp },
+    };
+
+    switch (event.phase) {
+        case 'X':
+            json.insert(QStringLiteral("dur"), event.value);
+            if (!event.detail.isEmpty())
+                json.insert(QStringLiteral("args"), QJsonObject {{ QStringLiteral("detail"), event.detail }});
+            break;
+        case 'C':
+            json.insert(QStringLiteral("args"), QJsonObject {{ QStringLiteral("value"), event.value }});
+            break;
+        default:
+            Q_UNREACHABLE();
+    }
+
+    return json;
+}
+} // namespace
+
+
+std::atomic<bool> Trace::m_enabled(false);
+
+void Trace::start(QString path)
+{
+    QMutexLocker lock(&trace_guard);
+
+    trace_path = std::move(path);
+    trace_events.clear();
+    thread_idxs.clear();
+    counter_values.clear();
+
+    current_thread_idx(); // the starting one is the main thread
+    trace_timer.start();
+    m_enabled = true;
+}
+
+void Trace::finish()
+{
+    QMutexLocker lock(&trace_guard);
+    if (!m_enabled)
+        return;
+
+    m_enabled = false;
+
+    QJsonArray json_events;
+    for (const auto& entry : thread_idxs)
+        json_events.append(thread_name_event(entry.second));
+    for (const TraceEvent& event : trace_events)
+        json_events.append(to_json(event));
+
+    const QJsonObject json_root {
+        { QStringLiteral("traceEvents"), json_events },
+        { QStringLiteral("displayTimeUnit"), QStringLiteral("ms") },
+    };
+
+    trace_events.clear();
+    trace_events.shrink_to_fit();
+
+
+    QSaveFile file(trace_path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning().noquote() << MSG_PREFIX
+            << tr_log("could not open `%1` for writing").arg(trace_path);
+        return;
+    }
+
+    file.write(QJsonDocument(json_root).toJson(QJsonDocument::Compact));
+    if (!file.commit()) {
+        qWarning().noquote() << MSG_PREFIX
+            << tr_log("could not write `%1`").arg(trace_path);
+        return;
+    }
+
+    qInfo().noquote() << MSG_PREFIX << tr_log("startup trace written to `%1`").arg(trace_path);
+}
+
+qint64 Trace::now()
+{
+    // QElapsedTimer is safe to read from multiple threads after starting
+    return trace_timer.nsecsElapsed() / 1000;
+}
+
+void Trace::complete(const char* name, qint64 start_us, const QString& detail)
+{
+    const qint64 end_us = now();
+
+    QMutexLocker lock(&trace_guard);
+    if (!m_enabled)
+        return;
+
+    trace_events.push_back({ name, 'X', current_thread_idx(), start_us, end_us - start_us, detail });
+}
+
+void Trace::count(const char* name, qint64 delta)
+{
+    const qint64 timestamp = now();
+
+    QMutexLocker lock(&trace_guard);
+    if (!m_enabled)
+        return;
+
+    qint64& value = counter_values[QLatin1String(name)];
+    value += delta;
+    trace_events.push_back({ name, 'C', current_thread_idx(), timestamp, value, QString() });
+}
@@ -0,0 +1,103 @@
+// Pegasus Frontend
+// Copyright (C) 2018  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include "utils/NoCopyNoMove.h"
+
+#include <QString>
+#include <QtGlobal>
+#include <atomic>
+#include <utility>
+
+
+// Startup profiling: records the duration of the marked scopes and the value
+// of some counters, then writes them in the Chrome/Perfetto JSON trace format.
+// While the recording is not active, the markers only check a flag.
+
+class Trace {
+public:
+    Trace() = delete;
+    NO_COPY_NO_MOVE(Trace)
+
+    /// Starts the recording; the events will be written to `path`
+    static void start(QString path);
+    /// Writes the recorded events to the file and stops the recording.
+    /// Does nothing if the recording is not active.
+    static void finish();
+
+    static bool enabled() { return m_enabled.load(std::memory_order_relaxed); }
+
+    /// Microseconds since the start of the recording
+    static qint64 now();
+    /// Records an event of `name` that started at `start_us` and ends now
+    static void complete(const char* name, qint64 start_us, const QString& detail);
+    /// Increments the counter of `name`, recording its new value
+    static void count(const char* name, qint64 delta);
+
+private:
+    static std::atomic<bool> m_enabled;
+};
+
+
+/// Records the lifetime of the object, if the tracing is active.
+/// Should be created with TRACE_SCOPE, which builds the arguments only
+/// while the tracing is active.
+class TraceScope {
+public:
+    /// The name (a string literal) and the optional detail of the scope,
+    /// or nothing if the scope shouldn't be recorded
+    struct Args {
+        Args() : name(nullptr) {}
+        explicit Args(const char* scope_name, QString scope_detail = QString())
+            : name(scope_name)
+            , detail(std::move(scope_detail))
+        {}
+
+        const char* name;
+        QString detail;
+    };
+
+    explicit TraceScope(Args args)
+        : m_name(args.name)
+        , m_start(m_name ? Trace::now() : 0)
+        , m_detail(std::move(args.detail))
+    {}
+    ~TraceScope() {
+        if (m_name)
+            Trace::complete(m_name, m_start, m_detail);
+    }
+    NO_COPY_NO_MOVE(TraceScope)
+
+private:
+    const char* const m_name;
+    const qint64 m_start;
+    const QString m_detail;
+};
+
+
+#define TRACE_CONCAT_IMPL(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_IMPL(a, b)
+
+/// Traces the rest of the enclosing scope. An optional QString can be passed as detail;
+/// like the name, it's not evaluated while the tracing is not active.
+#define TRACE_SCOPE(...) const TraceScope TRACE_CONCAT(trace_scope_, __LINE__)( \
+    Trace::enabled() ? TraceScope::Args(__VA_ARGS__) : TraceScope::Args())
+
+/// Increments a trace counter
+#define TRACE_COUNT(name, delta) \
+    do { if (Trace::enabled()) Trace::count(name, delta); } while (false)
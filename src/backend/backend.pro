@@ -14,10 +14,12 @@ SOURCES += \
     GamepadAxisNavigation.cpp \
     PegasusAssets.cpp \
     ProcessLauncher.cpp \
+    ScanRunner.cpp \
     ScriptRunner.cpp \
     Paths.cpp \
     AppSettings.cpp \
-    Log.cpp
+    Log.cpp \
+    Trace.cpp
 
 HEADERS += \
     Api.h \
@@ -28,13 +30,16 @@ HEADERS += \
     GamepadAxisNavigation.h \
     PegasusAssets.h \
     ProcessLauncher.h \
+    ScanRunner.h \
     ScriptRunner.h \
     LocaleUtils.h \
     Paths.h \
     AppSettings.h \
     Log.h \
+    Trace.h \
 
 include(configfiles/configfiles.pri)
+include(filesystem/filesystem.pri)
 include(platform/platform.pri)
 include(providers/providers.pri)
 include(model/model.pri)
@@ -40,6 +40,7 @@ enum class ConfigEntryGeneralOption : unsigned char {
     PORTABLE,
     SILENT,
     FULLSCREEN,
+    LAZY_ASSETS,
     LOCALE,
     THEME,
 };
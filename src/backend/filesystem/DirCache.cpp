@@ -0,0 +1,833 @@
+// Pegasus Frontend
+// Copyright (C) 2018  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "DirCache.h"
+
+#include "LocaleUtils.h"
+#include "Paths.h"
+#include "Trace.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QPair>
+#include <QSaveFile>
+#include <QSet>
+#include <QThread>
+#include <QThreadPool>
+#include <QWaitCondition>
+#include <QtConcurrent/QtConcurrent>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#ifdef Q_OS_UNIX
+#include <sys/stat.h>
+#endif
+#ifdef Q_OS_LINUX
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+
+namespace {
+static constexpr auto MSG_PREFIX = "Directory cache:";
+
+// increase this when the layout of the file changes
+constexpr quint32 CACHE_MAGIC = 0x50474443; // "PGDC"
+constexpr quint32 CACHE_FORMAT = 2;
+constexpr auto STREAM_VERSION = QDataStream::Qt_5_6;
+
+// directories modified this recently may change again without
+// a visible change of their timestamp
+constexpr qint64 RACY_WINDOW_NS = 2000000000;
+
+
+QString join_path(const QString& dir_path, const QString& name)
+{
+    if (dir_path.endsWith(QLatin1Char('/')))
+        return dir_path + name;
+
+    return dir_path + QLatin1Char('/') + name;
+}
+
+QDataStream& operator<<(QDataStream& stream, const filesystem::DirListing& listing)
+{
+    stream << listing.canonical_path
+           << listing.device
+           << listing.inode
+           << static_cast<quint32>(listing.entries.size());
+    for (const filesystem::DirEntry& entry : listing.entries)
+        stream << entry.name << entry.link_target << entry.is_dir;
+
+    return stream;
+}
+
+QDataStream& operator>>(QDataStream& stream, filesystem::DirListing& listing)
+{
+    quint32 entry_count = 0;
+    stream >> listing.canonical_path
+           >> listing.device
+           >> listing.inode
+           >> entry_count;
+    for (quint32 i = 0; i < entry_count && stream.status() == QDataStream::Ok; i++) {
+        filesystem::DirEntry entry;
+        stream >> entry.name >> entry.link_target >> entry.is_dir;
+        listing.entries.append(std::move(entry));
+    }
+
+    return stream;
+}
+
+/// The directories already seen during a walk, to avoid following symbolic link loops
+class VisitedDirs {
+public:
+    /// Returns false if the directory was already visited
+    bool insert(const filesystem::DirListing& listing)
+    {
+        if (listing.inode == 0) {
+            if (m_paths.contains(listing.canonical_path))
+                return false;
+
+            m_paths.insert(listing.canonical_path);
+            return true;
+        }
+
+        const QPair<quint64, quint64> id(listing.device, listing.inode);
+        if (m_ids.contains(id))
+            return false;
+
+        m_ids.insert(id);
+        return true;
+    }
+
+private:
+    QSet<QPair<quint64, quint64>> m_ids;
+    QSet<QString> m_paths;
+};
+
+
+#ifdef Q_OS_LINUX
+// the record layout of the getdents64 system call
+struct LinuxDirent64 {
+    quint64 d_ino;
+    qint64 d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[1];
+};
+
+QString canonical_path_of(const QByteArray& path)
+{
+    char* const resolved = ::realpath(path.constData(), nullptr);
+    if (!resolved)
+        return QString();
+
+    const QString result = QFile::decodeName(resolved);
+    ::free(resolved);
+    return result;
+}
+
+/// Reads the directory using the entry types returned by the kernel, so
+/// only the symbolic links and the entries of unknown type have to be stat'd
+filesystem::DirListing read_listing_native(const QString& dir_path)
+{
+    filesystem::DirListing listing;
+
+    const QByteArray dir_path_enc = QFile::encodeName(dir_path);
+    listing.canonical_path = canonical_path_of(dir_path_enc);
+    if (listing.canonical_path.isEmpty())
+        return listing;
+
+    const auto read_failed = [&listing, &dir_path](int error){
+        qWarning().noquote() << MSG_PREFIX
+            << tr_log("could not read directory `%1`: %2").arg(dir_path, QString::fromLocal8Bit(::strerror(error)));
+        listing.entries.clear();
+        listing.read_failed = true;
+    };
+
+    const int dir_fd = ::open(dir_path_enc.constData(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dir_fd < 0) {
+        read_failed(errno);
+        return listing;
+    }
+
+    struct ::stat dir_stat;
+    if (::fstat(dir_fd, &dir_stat) == 0) {
+        listing.device = static_cast<quint64>(dir_stat.st_dev);
+        listing.inode = static_cast<quint64>(dir_stat.st_ino);
+    }
+
+    std::vector<quint64> buffer(4096); // 32 KiB, aligned for the records
+    char* const buffer_start = reinterpret_cast<char*>(buffer.data());
+    const size_t buffer_size = buffer.size() * sizeof(quint64);
+
+    while (true) {
+        const long bytes_read = ::syscall(SYS_getdents64, dir_fd, buffer_start, buffer_size);
+        if (bytes_read == 0)
+            break;
+        if (bytes_read < 0) {
+            // eg. an I/O error or a stale network mount; a partial listing
+            // would hide the rest of the games for as long as it's cached
+            const int error = errno;
+            ::close(dir_fd);
+            read_failed(error);
+            return listing;
+        }
+
+        for (long offset = 0; offset < bytes_read;) {
+            const auto record = reinterpret_cast<const LinuxDirent64*>(buffer_start + offset);
+            offset += record->d_reclen;
+
+            // hidden files, including the dot entries
+            const char* const name = record->d_name;
+            if (name[0] == '.')
+                continue;
+
+            unsigned char type = record->d_type;
+            QString link_target;
+
+            struct ::stat entry_stat;
+            if (type == DT_UNKNOWN) {
+                if (::fstatat(dir_fd, name, &entry_stat, AT_SYMLINK_NOFOLLOW) != 0)
+                    continue;
+
+                type = S_ISLNK(entry_stat.st_mode) ? DT_LNK
+                     : S_ISDIR(entry_stat.st_mode) ? DT_DIR
+                     : S_ISREG(entry_stat.st_mode) ? DT_REG
+                     : DT_UNKNOWN;
+            }
+            if (type == DT_LNK) {
+                // broken links are ignored
+                if (::fstatat(dir_fd, name, &entry_stat, 0) != 0)
+                    continue;
+
+                type = S_ISDIR(entry_stat.st_mode) ? DT_DIR
+                     : S_ISREG(entry_stat.st_mode) ? DT_REG
+                     : DT_UNKNOWN;
+
+                link_target = canonical_path_of(dir_path_enc + '/' + name);
+                if (link_target.isEmpty())
+                    continue;
+            }
+            if (type != DT_DIR && type != DT_REG)
+                continue;
+            // same as QDir::Readable; unreadable files would show up as games that can't be launched
+            if (::faccessat(dir_fd, name, R_OK, 0) != 0)
+                continue;
+
+            filesystem::DirEntry entry;
+            entry.name = QFile::decodeName(name);
+            entry.link_target = std::move(link_target);
+            entry.is_dir = type == DT_DIR;
+            listing.entries.append(std::move(entry));
+        }
+    }
+
+    ::close(dir_fd);
+    return listing;
+}
+#endif // Q_OS_LINUX
+} // namespace
+
+
+namespace filesystem {
+
+QString DirEntry::suffix() const
+{
+    const int last_dot = name.lastIndexOf(QLatin1Char('.'));
+    return last_dot < 0 ? QString() : name.mid(last_dot + 1);
+}
+
+QStringRef DirEntry::suffixRef() const
+{
+    const int last_dot = name.lastIndexOf(QLatin1Char('.'));
+    return last_dot < 0 ? QStringRef() : name.midRef(last_dot + 1);
+}
+
+QString DirEntry::completeBaseName() const
+{
+    const int last_dot = name.lastIndexOf(QLatin1Char('.'));
+    return last_dot < 0 ? name : name.left(last_dot);
+}
+
+QStringRef DirEntry::completeBaseNameRef() const
+{
+    const int last_dot = name.lastIndexOf(QLatin1Char('.'));
+    return last_dot < 0 ? QStringRef(&name) : name.leftRef(last_dot);
+}
+
+
+QString DirListing::canonicalFilePath(const DirEntry& entry) const
+{
+    if (!entry.link_target.isEmpty())
+        return entry.link_target;
+
+    if (canonical_path.endsWith(QLatin1Char('/'))) // root
+        return canonical_path + entry.name;
+
+    return canonical_path + QLatin1Char('/') + entry.name;
+}
+
+QString DirListing::canonicalDirPath(const DirEntry& entry) const
+{
+    if (entry.link_target.isEmpty())
+        return canonical_path;
+
+    const int last_sep = entry.link_target.lastIndexOf(QLatin1Char('/'));
+    return entry.link_target.left(qMax(1, last_sep));
+}
+
+
+bool DirCache::Fingerprint::operator==(const Fingerprint& other) const
+{
+    return mtime_ns == other.mtime_ns
+        && device == other.device
+        && inode == other.inode
+        && nlink == other.nlink
+        && size == other.size;
+}
+
+
+DirCache::DirCache()
+    : m_dirty(false)
+    , m_scanning(false)
+    , m_scan_id(0)
+{
+    // the listing waits on the disk most of the time, so
+    // more threads are used than the number of cores
+    m_prefetch_pool.setMaxThreadCount(qBound(2, QThread::idealThreadCount() * 2, 16));
+}
+
+bool DirCache::read_fingerprint(const QString& dir_path, Fingerprint& fingerprint)
+{
+    // embedded resources can't change
+    if (dir_path.startsWith(QLatin1Char(':')))
+        return false;
+
+#ifdef Q_OS_UNIX
+    struct ::stat buffer;
+    if (::stat(QFile::encodeName(dir_path).constData(), &buffer) != 0 || !S_ISDIR(buffer.st_mode))
+        return false;
+
+  #ifdef Q_OS_DARWIN
+    const struct ::timespec& mtime = buffer.st_mtimespec;
+  #else
+    const struct ::timespec& mtime = buffer.st_mtim;
+  #endif
+    fingerprint.mtime_ns = static_cast<qint64>(mtime.tv_sec) * 1000000000 + mtime.tv_nsec;
+    fingerprint.device = static_cast<quint64>(buffer.st_dev);
+    fingerprint.inode = static_cast<quint64>(buffer.st_ino);
+    fingerprint.nlink = static_cast<quint64>(buffer.st_nlink);
+    fingerprint.size = static_cast<qint64>(buffer.st_size);
+#else
+    const QFileInfo finfo(dir_path);
+    if (!finfo.isDir())
+        return false;
+
+    fingerprint.mtime_ns = finfo.lastModified().toMSecsSinceEpoch() * 1000000;
+    fingerprint.device = 0;
+    fingerprint.inode = 0;
+    fingerprint.nlink = 0;
+    fingerprint.size = 0;
+#endif
+
+    return true;
+}
+
+DirListing DirCache::read_listing(const QString& dir_path)
+{
+    TRACE_SCOPE("read directory", dir_path);
+
+#ifdef Q_OS_LINUX
+    // the embedded resources can only be read by Qt
+    if (!dir_path.startsWith(QLatin1Char(':'))) {
+        DirListing listing = read_listing_native(dir_path);
+        TRACE_COUNT("files visited", listing.entries.count());
+        return listing;
+    }
+#endif
+
+    constexpr auto entry_filters = QDir::Files | QDir::Dirs | QDir::Readable | QDir::NoDotAndDotDot;
+
+    DirListing listing;
+    listing.canonical_path = QFileInfo(dir_path).canonicalFilePath();
+    if (listing.canonical_path.isEmpty())
+        return listing;
+
+    QDirIterator dir_it(dir_path, entry_filters);
+    while (dir_it.hasNext()) {
+        dir_it.next();
+        const QFileInfo finfo = dir_it.fileInfo();
+
+        DirEntry entry;
+        entry.name = dir_it.fileName();
+        entry.is_dir = finfo.isDir();
+        if (finfo.isSymLink())
+            entry.link_target = finfo.canonicalFilePath();
+
+        listing.entries.append(std::move(entry));
+    }
+
+    TRACE_COUNT("files visited", listing.entries.count());
+    return listing;
+}
+
+DirListing DirCache::list(const QString& dir_path)
+{
+    quint32 scan_id = 0;
+    bool scanning = false;
+    {
+        QMutexLocker lock(&m_guard);
+
+        // already checked during this scan
+        const auto it = m_entries.find(dir_path);
+        if (m_scanning && it != m_entries.end() && it->second.checked_scan == m_scan_id)
+            return it->second.listing;
+
+        scan_id = m_scan_id;
+        scanning = m_scanning;
+    }
+
+    // outside of a scan (eg. the lazy asset lookups) nothing is kept,
+    // so the memory use doesn't grow for the lifetime of the program
+    Fingerprint fingerprint;
+    bool cacheable = scanning && read_fingerprint(dir_path, fingerprint);
+    if (cacheable) {
+        QMutexLocker lock(&m_guard);
+
+        const auto it = m_entries.find(dir_path);
+        if (it != m_entries.end() && it->second.trusted && it->second.fingerprint == fingerprint) {
+            it->second.used = true;
+            it->second.checked_scan = scan_id;
+            return it->second.listing;
+        }
+    }
+
+    DirListing listing = read_listing(dir_path);
+    // the directory is read again on its next use
+    cacheable &= !listing.read_failed;
+
+    if (cacheable) {
+        const qint64 now_ns = QDateTime::currentMSecsSinceEpoch() * 1000000;
+        const bool trusted = now_ns - fingerprint.mtime_ns > RACY_WINDOW_NS;
+
+        QMutexLocker lock(&m_guard);
+        CacheEntry& entry = m_entries[dir_path];
+        entry.fingerprint = fingerprint;
+        entry.listing = listing;
+        entry.trusted = trusted;
+        entry.used = true;
+        entry.checked_scan = scan_id;
+        m_dirty = true;
+    }
+
+    return listing;
+}
+
+QString DirCache::canonicalFilePath(const QString& file_path)
+{
+    // relative to the working directory, or ending with a special name
+    const int last_sep = file_path.lastIndexOf(QLatin1Char('/'));
+    const QStringRef name = file_path.midRef(last_sep + 1);
+    if (last_sep < 0 || name.isEmpty() || name == QLatin1String(".") || name == QLatin1String(".."))
+        return QFileInfo(file_path).canonicalFilePath();
+
+#ifdef Q_OS_UNIX
+    const QString dir_path = last_sep == 0 ? QStringLiteral("/") : file_path.left(last_sep);
+    if (dir_path.startsWith(QLatin1Char(':')))
+        return QFileInfo(file_path).canonicalFilePath();
+
+    // the directory may have been listed since the last call
+    const auto attach_listing = [this](CanonicalDir& dir, const QString& dir_path){
+        if (dir.listed || dir.canonical_path.isEmpty())
+            return;
+
+        const auto entry_it = m_entries.find(dir_path);
+        if (entry_it == m_entries.end() || entry_it->second.checked_scan != m_scan_id)
+            return;
+
+        dir.listing = entry_it->second.listing;
+        for (int i = 0; i < dir.listing.entries.size(); i++)
+            dir.entry_index.insert(dir.listing.entries.at(i).name, i);
+        dir.listed = true;
+    };
+
+    CanonicalDir dir;
+    bool known_dir = false;
+    {
+        QMutexLocker lock(&m_guard);
+
+        // outside of a scan nothing is kept
+        if (!m_scanning)
+            return QFileInfo(file_path).canonicalFilePath();
+
+        const auto it = m_canonical_dirs.find(dir_path);
+        if (it != m_canonical_dirs.end()) {
+            attach_listing(it->second, dir_path);
+            dir = it->second;
+            known_dir = true;
+        }
+    }
+
+    if (!known_dir) {
+        // a single realpath for every file of the directory
+        dir.canonical_path = QFileInfo(dir_path).canonicalFilePath();
+
+        QMutexLocker lock(&m_guard);
+        if (m_scanning) {
+            attach_listing(dir, dir_path);
+            m_canonical_dirs.emplace(dir_path, dir);
+        }
+    }
+    if (dir.canonical_path.isEmpty())
+        return QString();
+
+    if (dir.listed) {
+        const int index = dir.entry_index.value(name.toString(), -1);
+        if (index >= 0)
+            return dir.listing.canonicalFilePath(dir.listing.entries.at(index));
+        // hidden and unreadable files are not listed, so they're checked below
+    }
+
+    struct ::stat buffer;
+    if (::lstat(QFile::encodeName(file_path).constData(), &buffer) != 0)
+        return QString();
+    if (S_ISLNK(buffer.st_mode))
+        return QFileInfo(file_path).canonicalFilePath();
+
+    return join_path(dir.canonical_path, name.toString());
+#else
+    return QFileInfo(file_path).canonicalFilePath();
+#endif
+}
+
+QStringList DirCache::subdirs(const QString& root_path)
+{
+    QStringList result;
+    VisitedDirs visited;
+
+    std::vector<QString> pending { root_path };
+    while (!pending.empty()) {
+        const QString dir_path = std::move(pending.back());
+        pending.pop_back();
+
+        const DirListing listing = list(dir_path);
+        if (listing.canonical_path.isEmpty() || !visited.insert(listing))
+            continue;
+
+        if (dir_path != root_path)
+            result.append(dir_path);
+
+        for (const DirEntry& entry : listing.entries) {
+            if (entry.is_dir)
+                pending.emplace_back(join_path(dir_path, entry.name));
+        }
+    }
+
+    return result;
+}
+
+void DirCache::forEachFile(const QString& root_path,
+                           const std::function<void(const QString&, const DirListing&, const DirEntry&)>& callback)
+{
+    forEachDir(root_path, [&callback](const QString& dir_path, const DirListing& listing){
+        for (const DirEntry& entry : listing.entries) {
+            if (!entry.is_dir)
+                callback(dir_path, listing, entry);
+        }
+    });
+}
+
+void DirCache::forEachDir(const QString& root_path,
+                          const std::function<void(const QString&, const DirListing&)>& callback)
+{
+    VisitedDirs visited;
+
+    std::vector<QString> pending { root_path };
+    while (!pending.empty()) {
+        const QString dir_path = std::move(pending.back());
+        pending.pop_back();
+
+        const DirListing listing = list(dir_path);
+        if (listing.canonical_path.isEmpty() || !visited.insert(listing))
+            continue;
+
+        for (const DirEntry& entry : listing.entries) {
+            if (entry.is_dir)
+                pending.emplace_back(join_path(dir_path, entry.name));
+        }
+        callback(dir_path, listing);
+    }
+}
+
+void DirCache::startScan()
+{
+    QMutexLocker lock(&m_guard);
+    m_scanning = true;
+    m_scan_id++;
+    m_canonical_dirs.clear();
+}
+
+void DirCache::finishScan()
+{
+    QMutexLocker lock(&m_guard);
+    m_scanning = false;
+    m_canonical_dirs.clear();
+}
+
+void DirCache::prefetch(const QStringList& root_paths)
+{
+    if (root_paths.isEmpty())
+        return;
+    {
+        // the listings are only kept for the walks during a scan
+        QMutexLocker lock(&m_guard);
+        if (!m_scanning)
+            return;
+    }
+
+    TRACE_SCOPE("prefetch directories", root_paths.join(QLatin1String(", ")));
+
+    // the pool is shared by all prefetches, which may run on multiple provider threads
+    const int thread_count = m_prefetch_pool.maxThreadCount();
+
+    struct WorkQueue {
+        QMutex guard;
+        std::deque<QString> dirs;
+    };
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    for (int i = 0; i < thread_count; i++)
+        queues.emplace_back(new WorkQueue());
+
+    // the number of directories queued or being listed
+    std::atomic<int> pending(root_paths.size());
+    // the number of directories queued only
+    std::atomic<int> queued(root_paths.size());
+    for (int i = 0; i < root_paths.size(); i++)
+        queues[static_cast<size_t>(i % thread_count)]->dirs.push_back(root_paths.at(i));
+
+    // the workers without anything to do sleep until new directories
+    // are queued or the last one is finished
+    QMutex idle_guard;
+    QWaitCondition idle_wakeup;
+    std::atomic<int> idle_count(0);
+    const auto wake_idle = [&idle_guard, &idle_wakeup, &idle_count]{
+        if (idle_count.load() > 0) {
+            QMutexLocker lock(&idle_guard);
+            idle_wakeup.wakeAll();
+        }
+    };
+
+    QMutex visited_guard;
+    VisitedDirs visited;
+
+    const auto take_work = [&queues, &queued](size_t self, QString& dir_path) -> bool {
+        {
+            // the own queue is used depth first, which keeps it short
+            WorkQueue& queue = *queues[self];
+            QMutexLocker lock(&queue.guard);
+            if (!queue.dirs.empty()) {
+                dir_path = std::move(queue.dirs.back());
+                queue.dirs.pop_back();
+                queued--;
+                return true;
+            }
+        }
+        for (size_t offset = 1; offset < queues.size(); offset++) {
+            // the oldest entries are usually the largest subtrees
+            WorkQueue& queue = *queues[(self + offset) % queues.size()];
+            QMutexLocker lock(&queue.guard);
+            if (!queue.dirs.empty()) {
+                dir_path = std::move(queue.dirs.front());
+                queue.dirs.pop_front();
+                queued--;
+                return true;
+            }
+        }
+        return false;
+    };
+    const auto run_worker = [&](size_t self) {
+        QString dir_path;
+        while (pending.load() > 0) {
+            if (!take_work(self, dir_path)) {
+                // the counters are changed before the wakeup, so either they are
+                // seen here, or the wakeup comes after the wait has started
+                QMutexLocker lock(&idle_guard);
+                idle_count++;
+                if (pending.load() > 0 && queued.load() == 0)
+                    idle_wakeup.wait(&idle_guard);
+                idle_count--;
+                continue;
+            }
+
+            const DirListing listing = list(dir_path);
+            bool is_new = false;
+            if (!listing.canonical_path.isEmpty()) {
+                QMutexLocker lock(&visited_guard);
+                is_new = visited.insert(listing);
+            }
+            bool has_new_work = false;
+            if (is_new) {
+                WorkQueue& queue = *queues[self];
+                QMutexLocker lock(&queue.guard);
+                for (const DirEntry& entry : listing.entries) {
+                    if (!entry.is_dir)
+                        continue;
+
+                    pending++;
+                    queued++;
+                    queue.dirs.push_back(join_path(dir_path, entry.name));
+                    has_new_work = true;
+                }
+            }
+
+            // the subdirectories are already counted at this point
+            const bool is_last = --pending == 0;
+            if (has_new_work || is_last)
+                wake_idle();
+        }
+    };
+
+    std::vector<QFuture<void>> workers;
+    workers.reserve(static_cast<size_t>(thread_count));
+    for (int i = 0; i < thread_count; i++) {
+        const size_t self = static_cast<size_t>(i);
+        workers.push_back(QtConcurrent::run(&m_prefetch_pool, [&run_worker, self]{ run_worker(self); }));
+    }
+    for (QFuture<void>& worker : workers)
+        worker.waitForFinished();
+}
+
+void DirCache::clear()
+{
+    QMutexLocker lock(&m_guard);
+    m_entries.clear();
+    m_canonical_dirs.clear();
+    m_dirty = false;
+}
+
+void DirCache::load(const QString& path)
+{
+    QMutexLocker lock(&m_guard);
+    m_entries.clear();
+    m_dirty = false;
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+
+    TRACE_COUNT("bytes read", file.size());
+
+    QDataStream stream(&file);
+    stream.setVersion(STREAM_VERSION);
+
+    quint32 magic = 0;
+    quint32 format = 0;
+    quint32 entry_count = 0;
+    stream >> magic >> format >> entry_count;
+    if (magic != CACHE_MAGIC || format != CACHE_FORMAT)
+        return;
+
+    for (quint32 i = 0; i < entry_count && stream.status() == QDataStream::Ok; i++) {
+        QString dir_path;
+        CacheEntry entry;
+        stream >> dir_path
+               >> entry.fingerprint.mtime_ns
+               >> entry.fingerprint.device
+               >> entry.fingerprint.inode
+               >> entry.fingerprint.nlink
+               >> entry.fingerprint.size
+               >> entry.listing;
+        entry.trusted = true;
+        entry.used = false;
+        entry.checked_scan = 0;
+
+        m_entries.emplace(std::move(dir_path), std::move(entry));
+    }
+
+    if (stream.status() != QDataStream::Ok) {
+        qWarning().noquote() << MSG_PREFIX << tr_log("`%1` is corrupt, ignored").arg(path);
+        m_entries.clear();
+    }
+}
+
+void DirCache::save(const QString& path)
+{
+    QMutexLocker lock(&m_guard);
+
+    // forget the directories not seen since loading
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if (it->second.used && it->second.trusted) {
+            ++it;
+            continue;
+        }
+
+        it = m_entries.erase(it);
+        m_dirty = true;
+    }
+    if (!m_dirty)
+        return;
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning().noquote() << MSG_PREFIX << tr_log("could not create `%1`").arg(path);
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(STREAM_VERSION);
+    stream << CACHE_MAGIC << CACHE_FORMAT << static_cast<quint32>(m_entries.size());
+    for (const auto& keyval : m_entries) {
+        const Fingerprint& fingerprint = keyval.second.fingerprint;
+        stream << keyval.first
+               << fingerprint.mtime_ns
+               << fingerprint.device
+               << fingerprint.inode
+               << fingerprint.nlink
+               << fingerprint.size
+               << keyval.second.listing;
+    }
+
+    if (!file.commit()) {
+        qWarning().noquote() << MSG_PREFIX << tr_log("writing `%1` failed").arg(path);
+        return;
+    }
+    m_dirty = false;
+}
+
+
+DirCache& dir_cache()
+{
+    static DirCache instance;
+    return instance;
+}
+
+QString default_dircache_path()
+{
+    return paths::writableCacheDir() + QStringLiteral("/dircache");
+}
+
+} // namespace filesystem
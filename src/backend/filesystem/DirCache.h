@@ -0,0 +1,166 @@
+// Pegasus Frontend
+// Copyright (C) 2018  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include "utils/HashMap.h"
+#include "utils/NoCopyNoMove.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+#include <QVector>
+#include <functional>
+
+
+namespace filesystem {
+
+struct DirEntry {
+    QString name;
+    /// The canonical path of the target, if the entry is a symbolic link
+    QString link_target;
+    bool is_dir;
+
+    /// Same as QFileInfo::suffix(), without creating one
+    QString suffix() const;
+    /// Same as suffix(), without allocating a new string
+    QStringRef suffixRef() const;
+    /// Same as QFileInfo::completeBaseName(), without creating one
+    QString completeBaseName() const;
+    /// Same as completeBaseName(), without allocating a new string
+    QStringRef completeBaseNameRef() const;
+};
+
+struct DirListing {
+    /// The canonical path of the listed directory
+    QString canonical_path;
+    /// The identity of the directory on the disk, used for detecting symbolic
+    /// link loops; zero where it's not available
+    quint64 device = 0;
+    quint64 inode = 0;
+    /// The files (and links to files) and directories, without the hidden ones
+    QVector<DirEntry> entries;
+    /// True if the directory exists but could not be read (completely); such a
+    /// listing has no entries, and is not kept in the cache
+    bool read_failed = false;
+
+    QString canonicalFilePath(const DirEntry&) const;
+    /// The canonical path of the directory that contains the (resolved) entry
+    QString canonicalDirPath(const DirEntry&) const;
+};
+
+
+/// A persistent store of directory listings. A listing is reused for as long as
+/// the fingerprint (modification time, inode, link count, size) of the directory
+/// doesn't change, so unchanged directories don't have to be read again.
+/// During a scan, every directory is checked on the disk only on its first use,
+/// and the filters and providers requesting it later share the same listing.
+/// The listings are only kept during a scan: after saving them, the cache should
+/// be cleared, and the next scan loads them again. All functions are thread safe.
+class DirCache {
+public:
+    DirCache();
+    NO_COPY_NO_MOVE(DirCache)
+
+    /// Returns the contents of the directory, either from the cache or from the disk
+    DirListing list(const QString& dir_path);
+    /// Same as QFileInfo::canonicalFilePath(), but during a scan the canonical path
+    /// of the parent directory is resolved only once, and if the directory was
+    /// already listed, the file is looked up in its listing instead of on the disk.
+    /// Returns an empty string if the file doesn't exist.
+    QString canonicalFilePath(const QString& file_path);
+    /// Returns the paths of all subdirectories under `root_path`, recursively,
+    /// following the symbolic links (but not the loops)
+    QStringList subdirs(const QString& root_path);
+    /// Calls `callback` for every file under `root_path`, recursively,
+    /// with the path of the containing directory
+    void forEachFile(const QString& root_path,
+                     const std::function<void(const QString&, const DirListing&, const DirEntry&)>& callback);
+    /// Calls `callback` for `root_path` and every directory under it, recursively,
+    /// in the same order as forEachFile()
+    void forEachDir(const QString& root_path,
+                    const std::function<void(const QString&, const DirListing&)>& callback);
+    /// Reads all directories under the root paths in parallel, on multiple threads
+    /// that steal work from each other when they run out of it. The threads come
+    /// from a bounded pool shared by every prefetch. During a scan, the
+    /// walks above then get every listing from memory, in the same order as before.
+    void prefetch(const QStringList& root_paths);
+
+    /// Starts a new scan; the directories are checked again on their next use,
+    /// then served from memory until the scan is finished
+    void startScan();
+    /// Ends the scan, after which every use reads the directory from the disk;
+    /// the listings of the scan are kept until clear() or load()
+    void finishScan();
+
+    /// Forgets all listings
+    void clear();
+    /// Replaces the contents of the cache with the one stored in the file
+    void load(const QString& path);
+    /// Writes the listings used since loading to the file, if anything has changed
+    void save(const QString& path);
+
+private:
+    struct Fingerprint {
+        qint64 mtime_ns;
+        quint64 device;
+        quint64 inode;
+        quint64 nlink;
+        qint64 size;
+
+        bool operator==(const Fingerprint&) const;
+    };
+    struct CacheEntry {
+        Fingerprint fingerprint;
+        DirListing listing;
+        /// False if the directory has changed right before being listed
+        bool trusted;
+        bool used;
+        /// The scan in which the directory was last checked on the disk
+        quint32 checked_scan;
+    };
+    struct CanonicalDir {
+        QString canonical_path;
+        /// The listing of the directory from the current scan, if it was already read
+        DirListing listing;
+        /// The entries of `listing`, by name
+        QHash<QString, int> entry_index;
+        bool listed = false;
+    };
+
+    QMutex m_guard;
+    HashMap<QString, CacheEntry> m_entries;
+    /// The directories of canonicalFilePath() during the current scan
+    HashMap<QString, CanonicalDir> m_canonical_dirs;
+    bool m_dirty;
+    bool m_scanning;
+    quint32 m_scan_id;
+    QThreadPool m_prefetch_pool;
+
+    static bool read_fingerprint(const QString& dir_path, Fingerprint&);
+    static DirListing read_listing(const QString& dir_path);
+};
+
+/// The cache used by the providers
+DirCache& dir_cache();
+
+/// The default location of the persistent directory cache
+QString default_dircache_path();
+
+} // namespace filesystem
@@ -0,0 +1,5 @@
+HEADERS += \
+    $$PWD/DirCache.h \
+
+SOURCES += \
+    $$PWD/DirCache.cpp \
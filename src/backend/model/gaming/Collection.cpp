@@ -17,20 +17,49 @@
 
 #include "Collection.h"
 
+#include "utils/MemoryUsage.h"
+
 
 namespace model {
 
-Collection::Collection(modeldata::Collection collection, QObject* parent)
+Collection::Collection(modeldata::Collection collection, GameLibrary& library, QObject* parent)
     : QObject(parent)
-    , m_games(this)
+    , m_games(library, this)
     , m_collection(std::move(collection))
     , m_default_assets(&m_collection.default_assets, this)
 {}
 
-void Collection::setGameList(QVector<Game*> games)
+// The name of a collection is its identifier, so it never changes
+void Collection::setData(modeldata::Collection collection)
+{
+    Q_ASSERT(collection.name == m_collection.name);
+
+    if (!collection.shortName().isEmpty())
+        m_collection.setShortName(collection.shortName());
+    m_collection.summary = std::move(collection.summary);
+    m_collection.description = std::move(collection.description);
+    m_collection.launch_cmd = std::move(collection.launch_cmd);
+    m_collection.launch_workdir = std::move(collection.launch_workdir);
+    m_collection.default_assets = std::move(collection.default_assets);
+
+    emit dataChanged();
+    m_default_assets.refresh();
+}
+
+void Collection::setGameList(QVector<GameSlot> games)
+{
+    m_games.setItems(std::move(games));
+}
+
+size_t Collection::heapSize() const
 {
-    m_games.clear();
-    m_games.append(std::move(games));
+    return heap_size(m_collection.name)
+        + heap_size(m_collection.shortName())
+        + heap_size(m_collection.summary)
+        + heap_size(m_collection.description)
+        + heap_size(m_collection.launch_cmd)
+        + heap_size(m_collection.launch_workdir)
+        + m_collection.default_assets.heapSize();
 }
 
 } // namespace model
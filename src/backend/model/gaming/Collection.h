@@ -17,32 +17,35 @@
 
 #pragma once
 
-#include "Game.h"
 #include "GameAssets.h"
+#include "GameListModel.h"
 #include "modeldata/gaming/CollectionData.h"
+#include "utils/QmlHelpers.h"
 
-#include "QtQmlTricks/QQmlObjectListModel.h"
 #include <QString>
 #include <QVector>
 
-namespace model { class Game; }
-
 
 namespace model {
 class Collection : public QObject {
     Q_OBJECT
 
     Q_PROPERTY(QString name READ name CONSTANT)
-    Q_PROPERTY(QString shortName READ shortName CONSTANT)
-    Q_PROPERTY(QString summary READ summary CONSTANT)
-    Q_PROPERTY(QString description READ description CONSTANT)
+    Q_PROPERTY(QString shortName READ shortName NOTIFY dataChanged)
+    Q_PROPERTY(QString summary READ summary NOTIFY dataChanged)
+    Q_PROPERTY(QString description READ description NOTIFY dataChanged)
     Q_PROPERTY(model::GameAssets* defaultAssets READ defaultAssetsPtr CONSTANT)
-    QML_OBJMODEL_PROPERTY(model::Game, games)
+    QML_CONST_PROPERTY(model::GameListModel, games)
 
 public:
-    explicit Collection(modeldata::Collection, QObject* parent = nullptr);
+    explicit Collection(modeldata::Collection, GameLibrary&, QObject* parent = nullptr);
 
-    void setGameList(QVector<Game*>);
+    const modeldata::Collection& data() const { return m_collection; }
+    void setData(modeldata::Collection);
+    void setGameList(QVector<GameSlot>);
+    /// Estimated heap memory held by the data of the collection, not counting
+    /// its game list, see utils/MemoryUsage.h
+    size_t heapSize() const;
 
 public:
     const QString& name() const { return m_collection.name; }
@@ -52,6 +55,9 @@ public:
 
     GameAssets* defaultAssetsPtr() { return &m_default_assets; }
 
+signals:
+    void dataChanged();
+
 private:
     modeldata::Collection m_collection;
     GameAssets m_default_assets;
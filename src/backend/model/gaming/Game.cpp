@@ -20,35 +20,17 @@
 
 namespace model {
 
-Game::Game(modeldata::Game game, QObject* parent)
+Game::Game(GameLibrary& library, GameSlot slot, modeldata::GameAssets* const assets, QObject* parent)
     : QObject(parent)
-    , m_game(std::move(game))
-    , m_assets(&m_game.assets, this)
+    , m_library(library)
+    , m_slot(slot)
+    , m_assets(assets, this)
 {
 }
 
 void Game::setFavorite(bool new_val)
 {
-    m_game.is_favorite = new_val;
-    emit favoriteChanged();
-}
-
-// This one is for summing the play times provided by multiple Providers.
-void Game::addPlayStats(int playcount, qint64 playtime, const QDateTime& last_played)
-{
-    m_game.last_played = std::max(m_game.last_played, last_played);
-    m_game.playtime += playtime;
-    m_game.playcount += playcount;
-    emit playStatsChanged();
-}
-
-// This one is a single update for playtime when the game finishes.
-void Game::updatePlayStats(qint64 duration, QDateTime time_finished)
-{
-    m_game.last_played = std::move(time_finished);
-    m_game.playtime += duration;
-    m_game.playcount++;
-    emit playStatsChanged();
+    m_library.setFavorite(m_slot, new_val);
 }
 
 void Game::launch()
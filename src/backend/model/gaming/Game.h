@@ -18,30 +18,34 @@
 #pragma once
 
 #include "GameAssets.h"
+#include "GameLibrary.h"
 #include "modeldata/gaming/CollectionData.h"
 #include "modeldata/gaming/GameData.h"
+#include "modeldata/gaming/GameStore.h"
 
 #include <QObject>
 
 
 namespace {
-QString joined_list(const QStringList& list) { return list.join(QLatin1String(", ")); }
+QString joined_list(const InternedStringList& list) { return list.join(QStringLiteral(", ")); }
 } // namespace
 
 
 #define CPROP_Q(type, apiName) \
-    private: Q_PROPERTY(type apiName READ apiName CONSTANT)
+    private: Q_PROPERTY(type apiName READ apiName NOTIFY dataChanged)
 
 #define CPROP_REF(type, apiName, dataField) \
-    public: const type& apiName() const { return m_game.dataField; } \
+    public: const type& apiName() const { return data().dataField; } \
     CPROP_Q(type, apiName)
 
 #define CPROP_POD(type, apiName, dataField) \
-    public: type apiName() const { return m_game.dataField; } \
+    public: type apiName() const { return data().dataField; } \
     CPROP_Q(type, apiName)
 
 
 namespace model {
+/// The QObject of a game in the GameLibrary, for the places that have to refer to
+/// a single game (eg. QML code using `get(i)`). Only the library creates them.
 class Game : public QObject {
     Q_OBJECT
 
@@ -49,12 +53,12 @@ class Game : public QObject {
     CPROP_REF(QString, summary, summary)
     CPROP_REF(QString, description, description)
 
-    Q_PROPERTY(QString developer READ developerString CONSTANT)
-    Q_PROPERTY(QString publisher READ publisherString CONSTANT)
-    Q_PROPERTY(QString genre READ genreString CONSTANT)
-    CPROP_REF(QStringList, developerList, developers)
-    CPROP_REF(QStringList, publisherList, publishers)
-    CPROP_REF(QStringList, genreList, genres)
+    Q_PROPERTY(QString developer READ developerString NOTIFY dataChanged)
+    Q_PROPERTY(QString publisher READ publisherString NOTIFY dataChanged)
+    Q_PROPERTY(QString genre READ genreString NOTIFY dataChanged)
+    Q_PROPERTY(QStringList developerList READ developerList NOTIFY dataChanged)
+    Q_PROPERTY(QStringList publisherList READ publisherList NOTIFY dataChanged)
+    Q_PROPERTY(QStringList genreList READ genreList NOTIFY dataChanged)
 
     CPROP_POD(int, players, player_count)
     CPROP_POD(float, rating, rating)
@@ -72,35 +76,40 @@ class Game : public QObject {
     Q_PROPERTY(model::GameAssets* assets READ assetsPtr CONSTANT)
 
 public:
-    explicit Game(modeldata::Game, QObject* parent = nullptr);
+    explicit Game(GameLibrary&, GameSlot, modeldata::GameAssets* const, QObject* parent = nullptr);
 
     Q_INVOKABLE void launch();
 
-    const modeldata::Game& data() const { return m_game; }
+    const modeldata::Game& data() const { return m_library.at(m_slot); }
+    GameLibrary& library() const { return m_library; }
+    GameSlot slot() const { return m_slot; }
     void setFavorite(bool);
-    void addPlayStats(int playcount, qint64 playtime, const QDateTime& last_played);
-    void updatePlayStats(qint64 duration, QDateTime time_finished);
+
+    GameAssets* assetsPtr() { return &m_assets; }
 
 signals:
     void launchRequested(model::Game*);
 
+    void dataChanged();
     void favoriteChanged();
     void playStatsChanged();
 
 private:
-    QString developerString() const { return joined_list(m_game.developers); }
-    QString publisherString() const { return joined_list(m_game.publishers); }
-    QString genreString() const { return joined_list(m_game.genres); }
-
-    bool favorite() const { return m_game.is_favorite; }
-    int playCount() const { return m_game.playcount; }
-    qint64 playTime() const { return m_game.playtime; }
-    const QDateTime& lastPlayed() const { return m_game.last_played; }
-
-    GameAssets* assetsPtr() { return &m_assets; }
+    QString developerString() const { return joined_list(data().developers); }
+    QString publisherString() const { return joined_list(data().publishers); }
+    QString genreString() const { return joined_list(data().genres); }
+    QStringList developerList() const { return data().developers.toStringList(); }
+    QStringList publisherList() const { return data().publishers.toStringList(); }
+    QStringList genreList() const { return data().genres.toStringList(); }
+
+    bool favorite() const { return data().is_favorite; }
+    int playCount() const { return data().playcount; }
+    qint64 playTime() const { return data().playtime; }
+    const QDateTime& lastPlayed() const { return data().last_played; }
 
 private:
-    modeldata::Game m_game;
+    GameLibrary& m_library;
+    const GameSlot m_slot;
     GameAssets m_assets;
 };
 } // namespace model
@@ -23,6 +23,50 @@ namespace model {
 GameAssets::GameAssets(modeldata::GameAssets* const assets, QObject* parent)
     : QObject(parent)
     , m_assets(std::move(assets))
+    , m_lookup_pending(false)
 {}
 
+void GameAssets::requestLookupMaybe() const
+{
+    if (!m_lookup_pending)
+        return;
+
+    // reading a property doesn't change the assets themselves
+    m_lookup_pending = false;
+    emit const_cast<GameAssets*>(this)->lookupRequested();
+}
+
+void GameAssets::refresh()
+{
+    for (QString& url : m_single_urls)
+        url.clear();
+    for (QStringList& urls : m_multi_urls)
+        urls.clear();
+
+    emit assetsChanged();
+}
+
+const QString& GameAssets::singleUrl(AssetType type) const
+{
+    requestLookupMaybe();
+
+    QString& url = m_single_urls[modeldata::GameAssets::singleSlot(type)];
+    if (url.isEmpty())
+        url = m_assets->single(type).url();
+
+    return url;
+}
+
+const QStringList& GameAssets::multiUrls(AssetType type) const
+{
+    requestLookupMaybe();
+
+    QStringList& urls = m_multi_urls[modeldata::GameAssets::multiSlot(type)];
+    if (urls.isEmpty()) {
+        for (const modeldata::Asset& asset : m_assets->multi(type))
+            urls.append(asset.url());
+    }
+    return urls;
+}
+
 } // namespace model
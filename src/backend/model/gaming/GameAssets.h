@@ -20,11 +20,12 @@
 #include "modeldata/gaming/GameAssetsData.h"
 
 #include <QObject>
+#include <array>
 
 
 #define SINGLE_ASSET_PROP(api_name, asset_type) \
-    Q_PROPERTY(QString api_name READ api_name CONSTANT) \
-    const QString& api_name() const { return m_assets->single(AssetType::asset_type); }
+    Q_PROPERTY(QString api_name READ api_name NOTIFY assetsChanged) \
+    const QString& api_name() const { return singleUrl(AssetType::asset_type); }
 
 
 namespace model {
@@ -57,18 +58,41 @@ class GameAssets : public QObject {
 
     // TODO: these could be optimized, see
     // https://doc.qt.io/qt-5/qtqml-cppintegration-data.html (Sequence Type to JavaScript Array)
-    Q_PROPERTY(QStringList screenshots READ screenshots CONSTANT)
-    Q_PROPERTY(QStringList videos READ videos CONSTANT)
+    Q_PROPERTY(QStringList screenshots READ screenshots NOTIFY assetsChanged)
+    Q_PROPERTY(QStringList videos READ videos NOTIFY assetsChanged)
 
 public:
     explicit GameAssets(modeldata::GameAssets* const, QObject* parent = nullptr);
 
+    /// Should be called when the underlying data has changed
+    void refresh();
+    /// Should be called when the underlying data has moved to a different place
+    void rebind(modeldata::GameAssets* const assets) { m_assets = assets; }
+    /// When set, the first read of any asset requests a lookup of the media files
+    void setLookupPending(bool pending) { m_lookup_pending = pending; }
+
+    // the URLs are built on the first read, then kept until the next refresh
+    const QString& singleUrl(AssetType) const;
+    const QStringList& multiUrls(AssetType) const;
+
+signals:
+    void assetsChanged();
+    /// The assets were read while a lookup was pending; `assetsChanged`
+    /// follows when the lookup has finished
+    void lookupRequested();
+
 private:
-    const QStringList& screenshots() { return m_assets->multi(AssetType::SCREENSHOTS); }
-    const QStringList& videos() { return m_assets->multi(AssetType::VIDEOS); }
+    const QStringList& screenshots() const { return multiUrls(AssetType::SCREENSHOTS); }
+    const QStringList& videos() const { return multiUrls(AssetType::VIDEOS); }
 
 private:
-    modeldata::GameAssets* const m_assets;
+    modeldata::GameAssets* m_assets;
+    mutable bool m_lookup_pending;
+
+    void requestLookupMaybe() const;
+
+    mutable std::array<QString, modeldata::SINGLE_ASSET_TYPE_COUNT> m_single_urls;
+    mutable std::array<QStringList, modeldata::MULTI_ASSET_TYPE_COUNT> m_multi_urls;
 };
 
 } // namespace model
@@ -0,0 +1,314 @@
+// Pegasus Frontend
+// Copyright (C) 2018  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "GameLibrary.h"
+
+#include "Game.h"
+#include "utils/StringIntern.h"
+
+#include <QFileInfo>
+#include <QMetaType>
+#include <QtConcurrent/QtConcurrent>
+#include <algorithm>
+
+
+namespace model {
+
+GameLibrary::GameLibrary(QObject* parent)
+    : QObject(parent)
+{
+    // the dynamic data is loaded in the background, so the changes may arrive queued
+    qRegisterMetaType<model::GameSlot>("model::GameSlot");
+
+    // the lookups are small, and should not compete with each other for the disk
+    m_lookup_pool.setMaxThreadCount(1);
+}
+
+GameLibrary::~GameLibrary()
+{
+    // the background lookup refers to the members
+    m_lookup_pool.waitForDone();
+}
+
+void GameLibrary::reserve(size_t count)
+{
+    const bool reallocates = count > m_games.capacity();
+    m_games.reserve(count);
+    m_objects.reserve(count);
+
+    if (reallocates)
+        rebindObjects();
+}
+
+GameSlot GameLibrary::add(modeldata::Game game)
+{
+    if (!m_free_slots.empty()) {
+        const GameSlot slot = m_free_slots.back();
+        m_free_slots.pop_back();
+        m_games[slot] = std::move(game);
+        return slot;
+    }
+
+    Q_ASSERT(m_games.size() < INVALID_GAMESLOT);
+    const GameSlot slot = static_cast<GameSlot>(m_games.size());
+    const bool reallocates = m_games.size() == m_games.capacity();
+
+    m_games.push_back(std::move(game));
+    m_objects.push_back(nullptr);
+
+    if (reallocates)
+        rebindObjects();
+
+    return slot;
+}
+
+void GameLibrary::remove(GameSlot slot)
+{
+    Q_ASSERT(slot < m_games.size());
+
+    // QML may still refer to the object until the current event is processed
+    if (m_objects[slot]) {
+        m_objects[slot]->deleteLater();
+        m_objects[slot] = nullptr;
+    }
+
+    m_games[slot] = modeldata::Game(modeldata::GamePath());
+    m_free_slots.push_back(slot);
+}
+
+Game* GameLibrary::object(GameSlot slot)
+{
+    Q_ASSERT(slot < m_games.size());
+
+    Game*& obj = m_objects[slot];
+    if (!obj) {
+        obj = new Game(*this, slot, &m_games[slot].assets, this);
+        connect(obj, &Game::launchRequested, this, &GameLibrary::launchRequested);
+        connect(obj->assetsPtr(), &GameAssets::lookupRequested,
+                this, [this, slot]{ requestAssets(slot); });
+
+        if (m_asset_loader)
+            obj->assetsPtr()->setLookupPending(true);
+    }
+    return obj;
+}
+
+void GameLibrary::setAssetLoader(AssetLoader loader)
+{
+    m_asset_loader = std::move(loader);
+    if (!m_asset_loader)
+        return;
+
+    // the objects already shown read their assets again after the refresh,
+    // which starts the lookup for them
+    for (size_t slot = 0; slot < m_objects.size(); slot++)
+        markLookupPending(static_cast<GameSlot>(slot));
+}
+
+void GameLibrary::compactStrings()
+{
+    std::vector<InternedStringList*> lists;
+    lists.reserve(m_games.size() * 3);
+    for (modeldata::Game& game : m_games) {
+        lists.push_back(&game.developers);
+        lists.push_back(&game.publishers);
+        lists.push_back(&game.genres);
+    }
+
+    compact_string_table(lists);
+}
+
+void GameLibrary::markLookupPending(GameSlot slot)
+{
+    Game* const obj = m_objects[slot];
+    if (!obj)
+        return;
+
+    obj->assetsPtr()->setLookupPending(true);
+    obj->assetsPtr()->refresh();
+}
+
+void GameLibrary::requestAssets(GameSlot slot)
+{
+    if (!m_asset_loader)
+        return;
+
+    // the reads during the same event loop iteration are looked up together
+    m_lookup_queue.push_back(slot);
+    if (m_lookup_queue.size() == 1)
+        QMetaObject::invokeMethod(this, "startAssetLookup", Qt::QueuedConnection);
+}
+
+void GameLibrary::startAssetLookup()
+{
+    std::vector<GameSlot> queue;
+    queue.swap(m_lookup_queue);
+
+    std::vector<std::pair<GameSlot, modeldata::GamePath>> requests;
+    requests.reserve(queue.size());
+    for (const GameSlot slot : queue) {
+        if (slot < m_games.size())
+            requests.emplace_back(slot, m_games[slot].path());
+    }
+    if (requests.empty() || !m_asset_loader)
+        return;
+
+    const AssetLoader loader = m_asset_loader;
+    QtConcurrent::run(&m_lookup_pool, [this, requests, loader]{
+        for (const auto& request : requests) {
+            modeldata::GameAssets assets;
+            loader(request.second, assets);
+
+            QMutexLocker lock(&m_found_guard);
+            m_found_assets.push_back({ request.first, request.second, std::move(assets) });
+            if (m_found_assets.size() == 1)
+                QMetaObject::invokeMethod(this, "applyFoundAssets", Qt::QueuedConnection);
+        }
+    });
+}
+
+void GameLibrary::applyFoundAssets()
+{
+    std::vector<FoundAssets> found;
+    {
+        QMutexLocker lock(&m_found_guard);
+        found.swap(m_found_assets);
+    }
+
+    for (FoundAssets& entry : found) {
+        if (entry.slot >= m_games.size())
+            continue;
+
+        // the game may have been removed or replaced during the lookup
+        modeldata::Game& game = m_games[entry.slot];
+        if (game.path().fileName() != entry.path.fileName() || game.path().dirPath() != entry.path.dirPath())
+            continue;
+
+        // the assets known from the metadata files take priority
+        game.assets.mergeFrom(std::move(entry.assets));
+
+        Game* const obj = m_objects[entry.slot];
+        if (obj)
+            obj->assetsPtr()->refresh();
+    }
+}
+
+size_t GameLibrary::recordsMemorySize() const
+{
+    size_t sum = m_games.capacity() * sizeof(modeldata::Game)
+        + m_free_slots.capacity() * sizeof(GameSlot);
+    for (const modeldata::Game& game : m_games)
+        sum += game.heapSize();
+
+    return sum;
+}
+
+size_t GameLibrary::assetsMemorySize() const
+{
+    size_t sum = 0;
+    for (const modeldata::Game& game : m_games)
+        sum += game.assets.heapSize();
+
+    return sum;
+}
+
+size_t GameLibrary::objectsMemorySize() const
+{
+    const size_t object_count = static_cast<size_t>(
+        std::count_if(m_objects.cbegin(), m_objects.cend(), [](const Game* obj){ return obj != nullptr; }));
+
+    // the private data of the QObjects is not included
+    return m_objects.capacity() * sizeof(Game*)
+        + object_count * sizeof(Game);
+}
+
+// The objects refer to the assets of their game directly
+void GameLibrary::rebindObjects()
+{
+    for (size_t slot = 0; slot < m_objects.size(); slot++) {
+        if (m_objects[slot])
+            m_objects[slot]->assetsPtr()->rebind(&m_games[slot].assets);
+    }
+}
+
+void GameLibrary::setData(GameSlot slot, modeldata::Game game)
+{
+    Q_ASSERT(slot < m_games.size());
+    modeldata::Game& current = m_games[slot];
+
+    game.is_favorite = current.is_favorite;
+    game.playcount = current.playcount;
+    game.playtime = current.playtime;
+    game.last_played = std::move(current.last_played);
+
+    current = std::move(game);
+    emit gameChanged(slot);
+
+    Game* const obj = m_objects[slot];
+    if (obj) {
+        emit obj->dataChanged();
+        // the new data doesn't have the assets found by the lookup yet
+        if (m_asset_loader)
+            obj->assetsPtr()->setLookupPending(true);
+        obj->assetsPtr()->refresh();
+    }
+}
+
+void GameLibrary::setFavorite(GameSlot slot, bool new_val)
+{
+    Q_ASSERT(slot < m_games.size());
+
+    m_games[slot].is_favorite = new_val;
+    emit gameChanged(slot);
+    emit favoriteChanged(slot);
+
+    Game* const obj = m_objects[slot];
+    if (obj)
+        emit obj->favoriteChanged();
+}
+
+void GameLibrary::addPlayStats(GameSlot slot, int playcount, qint64 playtime, const QDateTime& last_played)
+{
+    Q_ASSERT(slot < m_games.size());
+    modeldata::Game& game = m_games[slot];
+
+    game.last_played = std::max(game.last_played, last_played);
+    game.playtime += playtime;
+    game.playcount += playcount;
+    emit gameChanged(slot);
+
+    Game* const obj = m_objects[slot];
+    if (obj)
+        emit obj->playStatsChanged();
+}
+
+void GameLibrary::updatePlayStats(GameSlot slot, qint64 duration, QDateTime time_finished)
+{
+    Q_ASSERT(slot < m_games.size());
+    modeldata::Game& game = m_games[slot];
+
+    game.last_played = std::move(time_finished);
+    game.playtime += duration;
+    game.playcount++;
+    emit gameChanged(slot);
+
+    Game* const obj = m_objects[slot];
+    if (obj)
+        emit obj->playStatsChanged();
+}
+
+} // namespace model
@@ -0,0 +1,120 @@
+// Pegasus Frontend
+// Copyright (C) 2018  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include "modeldata/gaming/GameData.h"
+#include "modeldata/gaming/GameStore.h"
+#include "utils/FwdDeclModel.h"
+
+#include <QMutex>
+#include <QObject>
+#include <QThreadPool>
+#include <QVector>
+#include <functional>
+#include <limits>
+#include <vector>
+
+
+namespace model {
+
+constexpr GameSlot INVALID_GAMESLOT = std::numeric_limits<GameSlot>::max();
+
+/// The data of all games in the models, stored contiguously and referred to
+/// by their slot. The slot of a game doesn't change while the game exists,
+/// but may be reused for a new one after the game was removed.
+///
+/// Most games are only ever shown as a row of a list, so the QObject of a game
+/// (for example the one QML gets from `get(i)`) is created only on request.
+class GameLibrary : public QObject {
+    Q_OBJECT
+
+public:
+    /// Adds the assets found for the game; called on a background thread
+    using AssetLoader = std::function<void(const modeldata::GamePath&, modeldata::GameAssets&)>;
+
+    explicit GameLibrary(QObject* parent = nullptr);
+    ~GameLibrary();
+
+    void reserve(size_t count);
+    GameSlot add(modeldata::Game);
+    /// The game should not be in any model at this point
+    void remove(GameSlot);
+    /// The number of slots, including the free ones
+    size_t slotCount() const { return m_games.size(); }
+
+    const modeldata::Game& at(GameSlot slot) const { Q_ASSERT(slot < m_games.size()); return m_games[slot]; }
+    /// Returns the QObject of the game, creating it when necessary
+    Game* object(GameSlot);
+
+    // estimated memory use, see utils/MemoryUsage.h
+    /// The game records, not counting their assets
+    size_t recordsMemorySize() const;
+    size_t assetsMemorySize() const;
+    /// The QObjects created so far
+    size_t objectsMemorySize() const;
+
+    /// When set, the assets of a game are looked up in the background on their
+    /// first read through its object, and added to the ones already known
+    void setAssetLoader(AssetLoader);
+    /// Drops the strings no longer used by any game from the global string table,
+    /// see utils/StringIntern.h; no scanning may run at the same time
+    void compactStrings();
+
+    /// Replaces the static data, eg. when a later stage of the scanning has found
+    /// more details. The favorite and play time related fields are kept.
+    void setData(GameSlot, modeldata::Game);
+    void setFavorite(GameSlot, bool);
+    /// For summing the play times provided by multiple Providers
+    void addPlayStats(GameSlot, int playcount, qint64 playtime, const QDateTime& last_played);
+    /// A single update for the play time when the game finishes
+    void updatePlayStats(GameSlot, qint64 duration, QDateTime time_finished);
+
+signals:
+    /// Any field of the game has changed
+    void gameChanged(model::GameSlot);
+    void favoriteChanged(model::GameSlot);
+    void launchRequested(model::Game*);
+
+private:
+    std::vector<modeldata::Game> m_games;
+    std::vector<Game*> m_objects;
+    std::vector<GameSlot> m_free_slots;
+
+    // the asset lookup runs on a single background thread; the results
+    // are added on the main thread, if the slot still has the same game
+    struct FoundAssets {
+        GameSlot slot;
+        modeldata::GamePath path;
+        modeldata::GameAssets assets;
+    };
+    AssetLoader m_asset_loader;
+    QThreadPool m_lookup_pool;
+    std::vector<GameSlot> m_lookup_queue;
+    QMutex m_found_guard;
+    std::vector<FoundAssets> m_found_assets;
+
+    void rebindObjects();
+    void markLookupPending(GameSlot);
+    void requestAssets(GameSlot);
+
+private slots:
+    void startAssetLookup();
+    void applyFoundAssets();
+};
+
+} // namespace model
@@ -0,0 +1,288 @@
+// Pegasus Frontend
+// Copyright (C) 2018  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "GameListModel.h"
+
+#include "Game.h"
+#include "GameLibrary.h"
+#include "utils/MemoryUsage.h"
+
+#include <algorithm>
+
+
+namespace {
+const QHash<int, QByteArray>& role_names()
+{
+    using Roles = model::GameListModel::Roles;
+
+    // the same names as the properties of model::Game
+    static const QHash<int, QByteArray> names {
+        { Roles::ModelData, QByteArrayLiteral("modelData") },
+        { Roles::Title, QByteArrayLiteral("title") },
+        { Roles::Summary, QByteArrayLiteral("summary") },
+        { Roles::Description, QByteArrayLiteral("description") },
+        { Roles::Developer, QByteArrayLiteral("developer") },
+        { Roles::Publisher, QByteArrayLiteral("publisher") },
+        { Roles::Genre, QByteArrayLiteral("genre") },
+        { Roles::DeveloperList, QByteArrayLiteral("developerList") },
+        { Roles::PublisherList, QByteArrayLiteral("publisherList") },
+        { Roles::GenreList, QByteArrayLiteral("genreList") },
+        { Roles::Players, QByteArrayLiteral("players") },
+        { Roles::Rating, QByteArrayLiteral("rating") },
+        { Roles::Release, QByteArrayLiteral("release") },
+        { Roles::ReleaseYear, QByteArrayLiteral("releaseYear") },
+        { Roles::ReleaseMonth, QByteArrayLiteral("releaseMonth") },
+        { Roles::ReleaseDay, QByteArrayLiteral("releaseDay") },
+        { Roles::Favorite, QByteArrayLiteral("favorite") },
+        { Roles::PlayCount, QByteArrayLiteral("playCount") },
+        { Roles::PlayTime, QByteArrayLiteral("playTime") },
+        { Roles::LastPlayed, QByteArrayLiteral("lastPlayed") },
+        { Roles::Assets, QByteArrayLiteral("assets") },
+    };
+    return names;
+}
+} // namespace
+
+
+namespace model {
+
+GameListModel::GameListModel(GameLibrary& library, QObject* parent)
+    : QAbstractListModel(parent)
+    , m_library(library)
+    , m_rows_valid(false)
+{
+    connect(&m_library, &GameLibrary::gameChanged,
+            this, &GameListModel::onGameChanged);
+}
+
+int GameListModel::rowCount(const QModelIndex& parent) const
+{
+    if (parent.isValid())
+        return 0;
+
+    return m_items.count();
+}
+
+QHash<int, QByteArray> GameListModel::roleNames() const
+{
+    return role_names();
+}
+
+QVariant GameListModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || rowCount() <= index.row())
+        return {};
+
+    const GameSlot slot = m_items.at(index.row());
+    const modeldata::Game& game = m_library.at(slot);
+    switch (role) {
+        case Roles::ModelData:
+            return QVariant::fromValue(m_library.object(slot));
+        case Roles::Title:
+            return game.title;
+        case Roles::Summary:
+            return game.summary;
+        case Roles::Description:
+            return game.description;
+        case Roles::Developer:
+            return joined_list(game.developers);
+        case Roles::Publisher:
+            return joined_list(game.publishers);
+        case Roles::Genre:
+            return joined_list(game.genres);
+        case Roles::DeveloperList:
+            return game.developers.toStringList();
+        case Roles::PublisherList:
+            return game.publishers.toStringList();
+        case Roles::GenreList:
+            return game.genres.toStringList();
+        case Roles::Players:
+            return game.player_count;
+        case Roles::Rating:
+            return game.rating;
+        case Roles::Release:
+            return game.release_date;
+        case Roles::ReleaseYear:
+            return game.release_date.year();
+        case Roles::ReleaseMonth:
+            return game.release_date.month();
+        case Roles::ReleaseDay:
+            return game.release_date.day();
+        case Roles::Favorite:
+            return game.is_favorite;
+        case Roles::PlayCount:
+            return game.playcount;
+        case Roles::PlayTime:
+            return game.playtime;
+        case Roles::LastPlayed:
+            return game.last_played;
+        case Roles::Assets:
+            return QVariant::fromValue(m_library.object(slot)->assetsPtr());
+        default:
+            return {};
+    }
+}
+
+Game* GameListModel::get(int idx) const
+{
+    if (idx < 0 || m_items.count() <= idx)
+        return nullptr;
+
+    return m_library.object(m_items.at(idx));
+}
+
+int GameListModel::indexOf(QObject* obj) const
+{
+    const Game* const game = qobject_cast<Game*>(obj);
+    if (!game || &game->library() != &m_library)
+        return -1;
+
+    return m_items.indexOf(game->slot());
+}
+
+QVariantList GameListModel::toVarArray() const
+{
+    QVariantList list;
+    list.reserve(m_items.count());
+    for (const GameSlot slot : m_items)
+        list.append(QVariant::fromValue(m_library.object(slot)));
+
+    return list;
+}
+
+void GameListModel::setItems(QVector<GameSlot> items)
+{
+    const int old_count = m_items.count();
+
+    beginResetModel();
+    m_items = std::move(items);
+    onRowsChanged();
+    endResetModel();
+
+    if (old_count != m_items.count())
+        emit countChanged();
+}
+
+void GameListModel::append(const QVector<GameSlot>& items)
+{
+    insert(m_items.count(), items);
+}
+
+void GameListModel::insert(int idx, GameSlot slot)
+{
+    insert(idx, QVector<GameSlot> { slot });
+}
+
+void GameListModel::insert(int idx, const QVector<GameSlot>& items)
+{
+    Q_ASSERT(0 <= idx && idx <= m_items.count());
+    if (items.isEmpty())
+        return;
+
+    beginInsertRows(QModelIndex(), idx, idx + items.count() - 1);
+    m_items.insert(idx, items.count(), INVALID_GAMESLOT);
+    std::copy(items.cbegin(), items.cend(), m_items.begin() + idx);
+    onRowsChanged();
+    endInsertRows();
+
+    emit countChanged();
+}
+
+void GameListModel::move(int from, int to)
+{
+    Q_ASSERT(0 <= from && from < m_items.count());
+    Q_ASSERT(0 <= to && to < m_items.count());
+    if (from == to)
+        return;
+
+    beginMoveRows(QModelIndex(), from, from, QModelIndex(), from < to ? to + 1 : to);
+    m_items.move(from, to);
+    onRowsChanged();
+    endMoveRows();
+}
+
+void GameListModel::remove(int idx)
+{
+    remove(idx, 1);
+}
+
+void GameListModel::remove(int idx, int count)
+{
+    if (idx < 0 || count <= 0 || m_items.count() < idx + count)
+        return;
+
+    beginRemoveRows(QModelIndex(), idx, idx + count - 1);
+    m_items.remove(idx, count);
+    onRowsChanged();
+    endRemoveRows();
+
+    emit countChanged();
+}
+
+void GameListModel::clear()
+{
+    if (m_items.isEmpty())
+        return;
+
+    beginRemoveRows(QModelIndex(), 0, m_items.count() - 1);
+    m_items.clear();
+    onRowsChanged();
+    endRemoveRows();
+
+    emit countChanged();
+}
+
+void GameListModel::refresh()
+{
+    if (m_items.isEmpty())
+        return;
+
+    emit dataChanged(index(0), index(m_items.count() - 1));
+}
+
+size_t GameListModel::heapSize() const
+{
+    return static_cast<size_t>(m_items.capacity()) * sizeof(GameSlot)
+        + hashmap_heap_size(m_rows);
+}
+
+void GameListModel::onRowsChanged()
+{
+    m_rows.clear();
+    m_rows_valid = false;
+}
+
+void GameListModel::onGameChanged(GameSlot slot)
+{
+    // a linear search for every change would make loading the dynamic data quadratic
+    if (!m_rows_valid) {
+        m_rows.reserve(static_cast<size_t>(m_items.count()));
+        for (int row = 0; row < m_items.count(); row++)
+            m_rows.emplace(m_items.at(row), row);
+
+        m_rows_valid = true;
+    }
+
+    const auto it = m_rows.find(slot);
+    if (it == m_rows.cend())
+        return;
+
+    const QModelIndex idx = index(it->second);
+    emit dataChanged(idx, idx);
+}
+
+} // namespace model
@@ -0,0 +1,119 @@
+// Pegasus Frontend
+// Copyright (C) 2018  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include "Game.h"
+#include "utils/FwdDeclModel.h"
+#include "utils/HashMap.h"
+
+#include <QAbstractListModel>
+#include <QVariantList>
+#include <QVector>
+
+
+namespace model {
+
+/// A list of games of a GameLibrary, which serves the properties of the games
+/// as roles directly from the library. The QObject of a game is only created
+/// when it's requested through `get(i)` or the `modelData` and `assets` roles.
+///
+/// For the themes, it provides the same read-only functions as the object
+/// list models used before (`size()`, `contains()`, `getFirst()` etc.).
+class GameListModel : public QAbstractListModel {
+    Q_OBJECT
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+
+public:
+    explicit GameListModel(GameLibrary&, QObject* parent = nullptr);
+
+    enum Roles {
+        ModelData = Qt::UserRole + 1,
+        Title,
+        Summary,
+        Description,
+        Developer,
+        Publisher,
+        Genre,
+        DeveloperList,
+        PublisherList,
+        GenreList,
+        Players,
+        Rating,
+        Release,
+        ReleaseYear,
+        ReleaseMonth,
+        ReleaseDay,
+        Favorite,
+        PlayCount,
+        PlayTime,
+        LastPlayed,
+        Assets,
+    };
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    Q_INVOKABLE model::Game* get(int idx) const;
+    Q_INVOKABLE model::Game* getFirst() const { return get(0); }
+    Q_INVOKABLE model::Game* getLast() const { return get(m_items.count() - 1); }
+    Q_INVOKABLE int size() const { return m_items.count(); }
+    Q_INVOKABLE bool isEmpty() const { return m_items.isEmpty(); }
+    Q_INVOKABLE bool contains(QObject* game) const { return indexOf(game) >= 0; }
+    Q_INVOKABLE int indexOf(QObject* game) const;
+    /// Creates the object of every game in the list
+    Q_INVOKABLE QVariantList toVarArray() const;
+
+    GameLibrary& library() const { return m_library; }
+    const QVector<GameSlot>& asList() const { return m_items; }
+    GameSlot at(int idx) const { return m_items.at(idx); }
+    int count() const { return m_items.count(); }
+    int indexOf(GameSlot slot) const { return m_items.indexOf(slot); }
+    bool contains(GameSlot slot) const { return m_items.contains(slot); }
+
+    void setItems(QVector<GameSlot>);
+    void append(const QVector<GameSlot>&);
+    void insert(int idx, GameSlot);
+    void insert(int idx, const QVector<GameSlot>&);
+    void move(int from, int to);
+    void remove(int idx);
+    void remove(int idx, int count);
+    void clear();
+    /// Should be called when the data of many games has changed at once,
+    /// eg. while the signals of the library were blocked
+    void refresh();
+
+    /// Estimated heap memory held by the list, see utils/MemoryUsage.h
+    size_t heapSize() const;
+
+signals:
+    void countChanged();
+
+private:
+    GameLibrary& m_library;
+    QVector<GameSlot> m_items;
+
+    // the row of each game, built on the first change of a game after the rows changed
+    HashMap<GameSlot, int> m_rows;
+    bool m_rows_valid;
+
+    void onGameChanged(GameSlot);
+    void onRowsChanged();
+};
+
+} // namespace model
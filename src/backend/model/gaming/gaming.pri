@@ -2,8 +2,12 @@ HEADERS += \
     $$PWD/Collection.h \
     $$PWD/Game.h \
     $$PWD/GameAssets.h \
+    $$PWD/GameLibrary.h \
+    $$PWD/GameListModel.h \
 
 SOURCES += \
     $$PWD/Collection.cpp \
     $$PWD/Game.cpp \
     $$PWD/GameAssets.cpp \
+    $$PWD/GameLibrary.cpp \
+    $$PWD/GameListModel.cpp \
@@ -19,12 +19,19 @@
 
 #include "LocaleUtils.h"
 #include "Paths.h"
+#include "utils/MemoryUsage.h"
 
 #include <QDebug>
 
 
 namespace model {
 
+size_t MemoryUsage::accounted() const
+{
+    return game_records + game_assets + game_objects + game_lists
+        + collections + collection_lists + theme_memory;
+}
+
 const QString Meta::m_git_revision(QStringLiteral(GIT_REVISION));
 const QString Meta::m_git_date(QStringLiteral(GIT_DATE));
 
@@ -33,6 +40,7 @@ Meta::Meta(QObject* parent)
     , m_log_path(paths::writableConfigDir() + QStringLiteral("/lastrun.log"))
     , m_loading(true)
     , m_loading_progress(0.f)
+    , m_scanning(false)
     , m_game_count(0)
 {
 }
@@ -43,6 +51,63 @@ void Meta::clearQMLCache()
     emit qmlClearCacheRequested();
 }
 
+void Meta::rescanLibrary()
+{
+    if (m_loading || m_scanning)
+        return;
+
+    qInfo().noquote() << tr_log("Looking for games again...");
+    emit libraryRescanRequested();
+}
+
+void Meta::refreshMemoryUsage()
+{
+    emit memoryUsageRefreshRequested();
+}
+
+void Meta::setMemoryUsage(const MemoryUsage& usage)
+{
+    m_memory_usage = usage;
+
+    const size_t accounted = usage.accounted();
+    const size_t other = usage.process_resident > accounted
+        ? usage.process_resident - accounted
+        : 0;
+
+    // QML numbers are doubles
+    const auto as_number = [](size_t bytes){ return QVariant(static_cast<double>(bytes)); };
+    m_memory_usage_map = QVariantMap {
+        { QStringLiteral("gameRecords"), as_number(usage.game_records) },
+        { QStringLiteral("gameAssets"), as_number(usage.game_assets) },
+        { QStringLiteral("gameObjects"), as_number(usage.game_objects) },
+        { QStringLiteral("gameLists"), as_number(usage.game_lists) },
+        { QStringLiteral("collections"), as_number(usage.collections) },
+        { QStringLiteral("collectionLists"), as_number(usage.collection_lists) },
+        { QStringLiteral("themeMemory"), as_number(usage.theme_memory) },
+        { QStringLiteral("accounted"), as_number(accounted) },
+        { QStringLiteral("resident"), as_number(usage.process_resident) },
+        { QStringLiteral("other"), as_number(other) },
+    };
+    emit memoryUsageChanged();
+}
+
+void Meta::logMemoryUsage() const
+{
+    const MemoryUsage& usage = m_memory_usage;
+
+    qInfo().noquote() << tr_log("Estimated memory use: game data %1, game assets %2, game objects %3, "
+                                "game lists %4, collections %5, collection game lists %6, theme memory %7")
+        .arg(format_mem_size(usage.game_records), format_mem_size(usage.game_assets),
+             format_mem_size(usage.game_objects), format_mem_size(usage.game_lists),
+             format_mem_size(usage.collections), format_mem_size(usage.collection_lists),
+             format_mem_size(usage.theme_memory));
+
+    if (usage.process_resident > 0) {
+        qInfo().noquote() << tr_log("Resident memory: %1 in total, %2 accounted above")
+            .arg(format_mem_size(usage.process_resident), format_mem_size(usage.accounted()));
+    }
+}
+
 void Meta::onFirstPhaseCompleted(qint64 elapsedTime)
 {
     qInfo().noquote() << tr_log("Games found in %1ms").arg(elapsedTime);
@@ -59,6 +124,24 @@ void Meta::onSecondPhaseCompleted(qint64 elapsedTime)
     emit loadingProgressChanged();
 }
 
+void Meta::onThirdPhaseCompleted(qint64 elapsedTime)
+{
+    qInfo().noquote() << tr_log("Scanning finished in %1ms").arg(elapsedTime);
+
+    if (m_scanning) {
+        m_scanning = false;
+        emit scanningChanged();
+    }
+}
+
+void Meta::onScanStarted()
+{
+    if (!m_scanning) {
+        m_scanning = true;
+        emit scanningChanged();
+    }
+}
+
 void Meta::onUiReady()
 {
     m_loading = false;
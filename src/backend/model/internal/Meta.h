@@ -18,16 +18,34 @@
 #pragma once
 
 #include <QObject>
+#include <QVariantMap>
 
 
 namespace model {
 
+/// Estimated memory use of the parts of the program, in bytes.
+/// Qt doesn't provide a way to query the QML image cache, so it's part of
+/// the remainder of the resident memory, with the QML engine and the code.
+struct MemoryUsage {
+    size_t game_records = 0;
+    size_t game_assets = 0;
+    size_t game_objects = 0;
+    size_t game_lists = 0;
+    size_t collections = 0;
+    size_t collection_lists = 0;
+    size_t theme_memory = 0;
+    size_t process_resident = 0;
+
+    size_t accounted() const;
+};
+
 /// Provides information about the program for the frontend layer
 class Meta : public QObject {
     Q_OBJECT
 
     Q_PROPERTY(bool loading READ isLoading NOTIFY loadingChanged)
     Q_PROPERTY(float loadingProgress READ loadingProgress NOTIFY loadingProgressChanged)
+    Q_PROPERTY(bool scanning READ isScanning NOTIFY scanningChanged)
 
     Q_PROPERTY(int gameCount READ gameCount NOTIFY gameCountChanged)
 
@@ -35,31 +53,49 @@ class Meta : public QObject {
     Q_PROPERTY(QString gitDate MEMBER m_git_date CONSTANT)
     Q_PROPERTY(QString logFilePath MEMBER m_log_path CONSTANT)
 
+    Q_PROPERTY(QVariantMap memoryUsage READ memoryUsage NOTIFY memoryUsageChanged)
+
 public:
     explicit Meta(QObject* parent = nullptr);
 
     void onUiReady();
+    void onScanStarted();
+
+    void setMemoryUsage(const MemoryUsage&);
+    void logMemoryUsage() const;
 
 public:
     Q_INVOKABLE void clearQMLCache();
+    /// Looks for games again, and updates the library without restarting
+    Q_INVOKABLE void rescanLibrary();
+    /// Updates `memoryUsage`. Calculating the values takes a walk through the
+    /// whole library, so this shouldn't be called too often.
+    Q_INVOKABLE void refreshMemoryUsage();
 
     bool isLoading() const { return m_loading; }
     float loadingProgress() const { return m_loading_progress; }
+    bool isScanning() const { return m_scanning; }
 
     int gameCount() const { return m_game_count; }
+    const QVariantMap& memoryUsage() const { return m_memory_usage_map; }
 
 public slots:
     void onFirstPhaseCompleted(qint64 elapsedTime);
     void onSecondPhaseCompleted(qint64 elapsedTime);
+    void onThirdPhaseCompleted(qint64 elapsedTime);
 
     void onGameCountUpdate(int game_count);
 
 signals:
     void loadingChanged();
     void loadingProgressChanged();
+    void scanningChanged();
     void gameCountChanged();
+    void memoryUsageChanged();
 
     void qmlClearCacheRequested();
+    void libraryRescanRequested();
+    void memoryUsageRefreshRequested();
 
 private:
     static const QString m_git_revision;
@@ -68,8 +104,12 @@ private:
 
     bool m_loading;
     float m_loading_progress;
+    bool m_scanning;
 
     int m_game_count;
+
+    MemoryUsage m_memory_usage;
+    QVariantMap m_memory_usage_map;
 };
 
 } // namespace model
@@ -21,6 +21,7 @@
 #include "ConfigFile.h"
 #include "LocaleUtils.h"
 #include "Paths.h"
+#include "utils/Collation.h"
 #include "utils/HashMap.h"
 #include "utils/PathCheck.h"
 
@@ -124,11 +125,7 @@ std::vector<model::ThemeEntry> find_available_themes()
         }
     }
 
-    std::sort(themes.begin(), themes.end(),
-        [](const model::ThemeEntry& a, const model::ThemeEntry& b) {
-            return QString::localeAwareCompare(a.name, b.name);
-        }
-    );
+    collation_sort(themes, [](const model::ThemeEntry& entry){ return entry.name; });
 
     return themes;
 }
@@ -19,6 +19,7 @@
 
 #include "LocaleUtils.h"
 #include "Paths.h"
+#include "utils/MemoryUsage.h"
 
 #include <QDebug>
 #include <QDir>
@@ -163,4 +164,9 @@ void Memory::changeTheme(const QString& theme_root_dir)
     m_data = load_map_maybe(m_settings_dir, m_current_theme);
     emit dataChanged();
 }
+
+size_t Memory::heapSize() const
+{
+    return heap_size(m_data);
+}
 } // namespace model
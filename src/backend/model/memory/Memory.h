@@ -37,6 +37,8 @@ public:
 
     void flush() const;
     void changeTheme(const QString&);
+    /// Estimated heap memory held by the stored values, see utils/MemoryUsage.h
+    size_t heapSize() const;
 
 signals:
     // NOTE: because QVariantMap cannot be changed on the QML side (QTBUG-59474),
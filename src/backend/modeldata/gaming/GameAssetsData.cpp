@@ -17,51 +17,228 @@
 
 #include "GameAssetsData.h"
 
+#include <QDataStream>
+#include <QStringBuilder>
 #include <QUrl>
 
 #include "types/AssetType.h"
+#include "utils/MemoryUsage.h"
+#include "utils/StringIntern.h"
+
+#include <algorithm>
 
 
 namespace {
+static_assert(static_cast<size_t>(AssetType::VIDEOS) == modeldata::SINGLE_ASSET_TYPE_COUNT + modeldata::MULTI_ASSET_TYPE_COUNT,
+              "The multi-value asset types should be at the end of the enum");
+
 bool asset_is_single(AssetType type)
 {
     return type != AssetType::SCREENSHOTS && type != AssetType::VIDEOS;
 }
+
+AssetType single_type_at(size_t slot)
+{
+    return static_cast<AssetType>(slot + 1);
+}
+
+AssetType multi_type_at(size_t slot)
+{
+    return static_cast<AssetType>(slot + static_cast<size_t>(AssetType::SCREENSHOTS));
+}
+
+// Only the non-empty slots are written, in the order of the types
+template<typename T, size_t N>
+void write_nonempty(QDataStream& stream, const std::array<T, N>& slots_array, AssetType (*type_at)(size_t))
+{
+    const auto nonempty_count = std::count_if(slots_array.cbegin(), slots_array.cend(),
+        [](const T& value){ return !value.isEmpty(); });
+    stream << static_cast<quint32>(nonempty_count);
+
+    for (size_t slot = 0; slot < N; slot++) {
+        if (!slots_array[slot].isEmpty())
+            stream << static_cast<quint8>(type_at(slot)) << slots_array[slot];
+    }
+}
+
+bool read_asset_type(QDataStream& stream, AssetType& type, bool expect_single)
+{
+    quint8 raw_type = 0;
+    stream >> raw_type;
+
+    type = static_cast<AssetType>(raw_type);
+    const bool valid = AssetType::UNKNOWN < type && type <= AssetType::VIDEOS
+        && asset_is_single(type) == expect_single;
+    if (!valid)
+        stream.setStatus(QDataStream::ReadCorruptData);
+
+    return stream.status() == QDataStream::Ok;
+}
 } // namespace
 
 
 namespace modeldata {
 
+Asset Asset::fromFile(const QString& path)
+{
+    const int sep_idx = path.lastIndexOf(QLatin1Char('/'));
+    if (sep_idx < 0)
+        return fromFile(QString(), path);
+
+    return fromFile(path.left(sep_idx), path.mid(sep_idx + 1));
+}
+
+Asset Asset::fromFile(const QString& dir_path, QString file_name)
+{
+    Asset asset;
+    // a non-null directory marks the local files, even in the root
+    asset.m_dir = dir_path.isEmpty() ? QStringLiteral("") : intern_string(dir_path);
+    asset.m_name = std::move(file_name);
+    return asset;
+}
+
+Asset Asset::fromUrl(QString url)
+{
+    Asset asset;
+    asset.m_name = std::move(url);
+    return asset;
+}
+
+QString Asset::url() const
+{
+    if (!isFile() || isEmpty())
+        return m_name;
+
+    return QUrl::fromLocalFile(m_dir % QLatin1Char('/') % m_name).toString();
+}
+
+size_t Asset::heapSize() const
+{
+    return heap_size(m_name);
+}
+
+QDataStream& operator<<(QDataStream& stream, const Asset& asset)
+{
+    return stream << asset.m_dir << asset.m_name;
+}
+
+QDataStream& operator>>(QDataStream& stream, Asset& asset)
+{
+    QString dir_path;
+    stream >> dir_path >> asset.m_name;
+    asset.m_dir = dir_path.isNull() ? QString() : intern_string(dir_path);
+    return stream;
+}
+
+
 GameAssets::GameAssets() = default;
 
-void GameAssets::addFileMaybe(AssetType key, QString path)
+bool GameAssets::addFileMaybe(AssetType key, const QString& path)
 {
-    QString url = QUrl::fromLocalFile(path).toString();
-    addUrlMaybe(key, std::move(url));
+    return addMaybe(key, Asset::fromFile(path));
 }
 
-void GameAssets::addUrlMaybe(AssetType key, QString url)
+bool GameAssets::addFileMaybe(AssetType key, const QString& dir_path, QString file_name)
 {
-    const bool is_single = asset_is_single(key);
+    return addMaybe(key, Asset::fromFile(dir_path, std::move(file_name)));
+}
 
-    if (is_single && single(key).isEmpty()) {
-        setSingle(key, std::move(url));
+bool GameAssets::addUrlMaybe(AssetType key, QString url)
+{
+    return addMaybe(key, Asset::fromUrl(std::move(url)));
+}
+
+bool GameAssets::addMaybe(AssetType key, Asset asset)
+{
+    if (asset_is_single(key)) {
+        Asset& current = m_single_assets[singleSlot(key)];
+        if (!current.isEmpty())
+            return false;
+
+        current = std::move(asset);
+        return true;
     }
-    else if (!is_single && !multi(key).contains(url)) {
-        appendMulti(key, std::move(url));
+
+    QVector<Asset>& current = m_multi_assets[multiSlot(key)];
+    if (current.contains(asset))
+        return false;
+
+    current.append(std::move(asset));
+    return true;
+}
+
+void GameAssets::setSingle(AssetType key, QString url)
+{
+    setSingle(key, Asset::fromUrl(std::move(url)));
+}
+
+void GameAssets::setSingle(AssetType key, Asset asset)
+{
+    m_single_assets[singleSlot(key)] = std::move(asset);
+}
+
+void GameAssets::appendMulti(AssetType key, QString url)
+{
+    m_multi_assets[multiSlot(key)].append(Asset::fromUrl(std::move(url)));
+}
+
+void GameAssets::mergeFrom(GameAssets&& other)
+{
+    for (size_t slot = 0; slot < SINGLE_ASSET_TYPE_COUNT; slot++) {
+        Asset& asset = other.m_single_assets[slot];
+        if (!asset.isEmpty())
+            addMaybe(single_type_at(slot), std::move(asset));
+    }
+    for (size_t slot = 0; slot < MULTI_ASSET_TYPE_COUNT; slot++) {
+        for (Asset& asset : other.m_multi_assets[slot])
+            addMaybe(multi_type_at(slot), std::move(asset));
+    }
+}
+
+size_t GameAssets::heapSize() const
+{
+    size_t sum = 0;
+    for (const Asset& asset : m_single_assets)
+        sum += asset.heapSize();
+    for (const QVector<Asset>& assets : m_multi_assets) {
+        sum += static_cast<size_t>(assets.capacity()) * sizeof(Asset);
+        for (const Asset& asset : assets)
+            sum += asset.heapSize();
     }
+
+    return sum;
 }
 
-void GameAssets::setSingle(AssetType key, QString value)
+QDataStream& operator<<(QDataStream& stream, const GameAssets& assets)
 {
-    Q_ASSERT(asset_is_single(key));
-    m_single_assets[key] = std::move(value);
+    write_nonempty(stream, assets.m_single_assets, single_type_at);
+    write_nonempty(stream, assets.m_multi_assets, multi_type_at);
+    return stream;
 }
 
-void GameAssets::appendMulti(AssetType key, QString value)
+QDataStream& operator>>(QDataStream& stream, GameAssets& assets)
 {
-    Q_ASSERT(!asset_is_single(key));
-    m_multi_assets[key].append(std::move(value));
+    quint32 single_count = 0;
+    stream >> single_count;
+    for (quint32 i = 0; i < single_count && stream.status() == QDataStream::Ok; i++) {
+        AssetType type;
+        if (!read_asset_type(stream, type, true))
+            break;
+
+        stream >> assets.m_single_assets[GameAssets::singleSlot(type)];
+    }
+
+    quint32 multi_count = 0;
+    stream >> multi_count;
+    for (quint32 i = 0; i < multi_count && stream.status() == QDataStream::Ok; i++) {
+        AssetType type;
+        if (!read_asset_type(stream, type, false))
+            break;
+
+        stream >> assets.m_multi_assets[GameAssets::multiSlot(type)];
+    }
+
+    return stream;
 }
 
 } // namespace modeldata
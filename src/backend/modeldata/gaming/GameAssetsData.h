@@ -18,31 +18,105 @@
 #pragma once
 
 #include "types/AssetType.h"
-#include "utils/HashMap.h"
 #include "utils/MoveOnly.h"
 
 #include <QString>
 #include <QStringList>
+#include <QVector>
+#include <array>
 
+class QDataStream;
+
+
+namespace modeldata {
+
+/// A single asset: either a local file, stored as a shared directory path
+/// and a file name, or a URL. The file URL is only built when it's requested.
+class Asset {
+public:
+    Asset() = default;
+    /// The directory part is shared between all assets in the same directory
+    static Asset fromFile(const QString& path);
+    static Asset fromFile(const QString& dir_path, QString file_name);
+    static Asset fromUrl(QString url);
+
+    bool isEmpty() const { return m_name.isEmpty(); }
+    bool isFile() const { return !m_dir.isNull(); }
+    /// Builds the URL of the asset; for local files this involves percent-encoding
+    QString url() const;
+
+    bool operator==(const Asset& other) const { return m_name == other.m_name && m_dir == other.m_dir; }
+    bool operator!=(const Asset& other) const { return !(*this == other); }
+
+    /// Estimated heap memory held by the asset, not counting the shared directory
+    size_t heapSize() const;
+
+private:
+    QString m_dir;
+    QString m_name; // or the whole URL
+
+    friend QDataStream& operator<<(QDataStream&, const Asset&);
+    friend QDataStream& operator>>(QDataStream&, Asset&);
+};
+
+QDataStream& operator<<(QDataStream&, const Asset&);
+QDataStream& operator>>(QDataStream&, Asset&);
+
+} // namespace modeldata
+
+Q_DECLARE_TYPEINFO(modeldata::Asset, Q_MOVABLE_TYPE);
 
 namespace modeldata {
 
+// The multi-value types are at the end of the enum
+constexpr size_t SINGLE_ASSET_TYPE_COUNT = static_cast<size_t>(AssetType::SCREENSHOTS) - 1;
+constexpr size_t MULTI_ASSET_TYPE_COUNT = 2;
+
+/// The assets of a game or collection, in a fixed slot for every type.
+/// Empty strings and lists don't allocate, so missing assets cost no memory
+/// beyond the slots themselves.
 struct GameAssets {
     explicit GameAssets();
     MOVE_ONLY(GameAssets)
 
-    // NOTE: a value for an asset type may not exist at the time of calling
-    const QString& single(AssetType type) { return m_single_assets[type]; }
-    const QStringList& multi(AssetType type) { return m_multi_assets[type]; }
+    // an empty value is returned for the missing assets
+    const Asset& single(AssetType type) const { return m_single_assets[singleSlot(type)]; }
+    const QVector<Asset>& multi(AssetType type) const { return m_multi_assets[multiSlot(type)]; }
+
+    // these return false if the asset was not stored, because the slot
+    // of the single value type is already taken, or it's already in the list
+    bool addFileMaybe(AssetType, const QString& path);
+    bool addFileMaybe(AssetType, const QString& dir_path, QString file_name);
+    bool addUrlMaybe(AssetType, QString);
+    bool addMaybe(AssetType, Asset);
+    void setSingle(AssetType, QString url);
+    void setSingle(AssetType, Asset);
+    void appendMulti(AssetType, QString url);
+    /// Adds the assets of `other` that are not yet set in this object
+    void mergeFrom(GameAssets&& other);
+
+    /// Estimated heap memory held by the assets, see utils/MemoryUsage.h
+    size_t heapSize() const;
 
-    void addFileMaybe(AssetType, QString);
-    void addUrlMaybe(AssetType, QString);
-    void setSingle(AssetType, QString);
-    void appendMulti(AssetType, QString);
+    // the position of the asset type in the slot arrays
+    static size_t singleSlot(AssetType type) {
+        Q_ASSERT(AssetType::UNKNOWN < type && type < AssetType::SCREENSHOTS);
+        return static_cast<size_t>(type) - 1;
+    }
+    static size_t multiSlot(AssetType type) {
+        Q_ASSERT(type == AssetType::SCREENSHOTS || type == AssetType::VIDEOS);
+        return static_cast<size_t>(type) - static_cast<size_t>(AssetType::SCREENSHOTS);
+    }
 
 private:
-    HashMap<AssetType, QString, EnumHash> m_single_assets;
-    HashMap<AssetType, QStringList, EnumHash> m_multi_assets;
+    std::array<Asset, SINGLE_ASSET_TYPE_COUNT> m_single_assets;
+    std::array<QVector<Asset>, MULTI_ASSET_TYPE_COUNT> m_multi_assets;
+
+    friend QDataStream& operator<<(QDataStream&, const GameAssets&);
+    friend QDataStream& operator>>(QDataStream&, GameAssets&);
 };
 
+QDataStream& operator<<(QDataStream&, const GameAssets&);
+QDataStream& operator>>(QDataStream&, GameAssets&);
+
 } // namespace modeldata
@@ -1,5 +1,5 @@
 // Pegasus Frontend
-// Copyright (C) 2017-2018  Mátyás Mustoha
+// Copyright (C) 2018  Mátyás Mustoha
 //
 // This program is free software: you can redistribute it and/or modify
 // it under the terms of the GNU General Public License as published by
@@ -17,18 +17,214 @@
 
 #include "GameData.h"
 
+#include "utils/MemoryUsage.h"
+#include "utils/StringIntern.h"
+
+#include <QDataStream>
+#include <QDir>
+#include <QStringBuilder>
+
+
+namespace {
+int basename_length(const QString& file_name)
+{
+    const int dot_idx = file_name.lastIndexOf(QLatin1Char('.'));
+    return dot_idx < 0 ? file_name.length() : dot_idx;
+}
+
+QString join_path(const QString& dir_path, const QString& file_name)
+{
+    if (dir_path.isNull())
+        return file_name;
+
+    return dir_path % QLatin1Char('/') % file_name;
+}
+
+// the root directory is stored as an empty (but not null) string
+QString dir_part(const QString& path, int sep_idx)
+{
+    if (sep_idx < 0)
+        return QString();
+    if (sep_idx == 0)
+        return QStringLiteral("");
+
+    return intern_string(path.left(sep_idx));
+}
+
+QString read_interned(QDataStream& stream)
+{
+    QString str;
+    stream >> str;
+    return str.isEmpty() ? str : intern_string(str);
+}
+} // namespace
+
 
 namespace modeldata {
 
-Game::Game(QFileInfo fileinfo)
-    : title(fileinfo.completeBaseName())
+GamePath::GamePath()
+    : m_basename_len(0)
+{}
+
+GamePath::GamePath(const QFileInfo& fileinfo)
+    : GamePath()
+{
+    const QString file_path = fileinfo.filePath();
+    const int sep_idx = file_path.lastIndexOf(QLatin1Char('/'));
+    m_dir_path = dir_part(file_path, sep_idx);
+    m_file_name = file_path.mid(sep_idx + 1);
+    m_basename_len = basename_length(m_file_name);
+
+    setCanonicalPath(fileinfo.canonicalFilePath());
+}
+
+GamePath::GamePath(const QString& dir_path, QString file_name, const QString& canonical_file_path)
+    : m_dir_path(intern_string(dir_path))
+    , m_file_name(std::move(file_name))
+    , m_basename_len(basename_length(m_file_name))
+{
+    setCanonicalPath(canonical_file_path);
+}
+
+void GamePath::setCanonicalPath(const QString& canonical_path)
+{
+    if (canonical_path.isEmpty())
+        return;
+
+    const int sep_idx = canonical_path.lastIndexOf(QLatin1Char('/'));
+    const QStringRef canonical_dir = canonical_path.leftRef(qMax(0, sep_idx));
+    const QStringRef canonical_name = canonical_path.midRef(sep_idx + 1);
+
+    // in most cases there are no symbolic links, and the data can be shared
+    m_canonical_dir_path = canonical_dir == m_dir_path
+        ? m_dir_path
+        : dir_part(canonical_path, sep_idx);
+    if (canonical_name != m_file_name)
+        m_canonical_file_name = canonical_name.toString();
+}
+
+QString GamePath::filePath() const
+{
+    return join_path(m_dir_path, m_file_name);
+}
+
+QString GamePath::suffix() const
+{
+    return m_basename_len < m_file_name.length()
+        ? m_file_name.mid(m_basename_len + 1)
+        : QString();
+}
+
+QString GamePath::absoluteDirPath() const
+{
+    if (!m_dir_path.isEmpty() && QDir::isAbsolutePath(m_dir_path))
+        return m_dir_path;
+
+    return QFileInfo(filePath()).absolutePath();
+}
+
+QString GamePath::absoluteFilePath() const
+{
+    if (!m_dir_path.isEmpty() && QDir::isAbsolutePath(m_dir_path))
+        return filePath();
+
+    return QFileInfo(filePath()).absoluteFilePath();
+}
+
+QString GamePath::canonicalFilePath() const
+{
+    if (m_canonical_dir_path.isNull())
+        return QString();
+
+    const QString& name = m_canonical_file_name.isNull() ? m_file_name : m_canonical_file_name;
+    return join_path(m_canonical_dir_path, name);
+}
+
+QDataStream& operator<<(QDataStream& stream, const GamePath& path)
+{
+    return stream << path.m_dir_path
+                  << path.m_file_name
+                  << path.m_canonical_dir_path
+                  << path.m_canonical_file_name;
+}
+
+QDataStream& operator>>(QDataStream& stream, GamePath& path)
+{
+    path.m_dir_path = read_interned(stream);
+    stream >> path.m_file_name;
+    path.m_canonical_dir_path = read_interned(stream);
+    stream >> path.m_canonical_file_name;
+    path.m_basename_len = basename_length(path.m_file_name);
+    return stream;
+}
+
+
+Game::Game(GamePath path)
+    : title(path.completeBaseName())
+    , playtime(0)
     , player_count(1)
-    , is_favorite(false)
-    , rating(0.f)
     , playcount(0)
-    , playtime(0)
-    , m_fileinfo(std::move(fileinfo))
+    , rating(0.f)
+    , is_favorite(false)
+    , m_path(std::move(path))
+{
+}
+
+Game::Game(const QFileInfo& fileinfo)
+    : Game(GamePath(fileinfo))
+{
+}
+
+const QString& Game::extra(const QString& key) const
+{
+    static const QString empty;
+    if (!m_extra)
+        return empty;
+
+    const auto it = m_extra->find(key);
+    return it != m_extra->cend() ? it->second : empty;
+}
+
+bool Game::hasExtra(const QString& key) const
+{
+    return m_extra && m_extra->count(key) > 0;
+}
+
+void Game::setExtra(QString key, QString value)
 {
+    if (!m_extra)
+        m_extra.reset(new HashMap<QString, QString>());
+
+    (*m_extra)[std::move(key)] = std::move(value);
+}
+
+const HashMap<QString, QString>& Game::extras() const
+{
+    static const HashMap<QString, QString> empty;
+    return m_extra ? *m_extra : empty;
+}
+
+size_t Game::heapSize() const
+{
+    size_t sum = heap_size(title)
+        + heap_size(summary)
+        + heap_size(description)
+        + heap_size(launch_cmd)
+        + heap_size(launch_workdir)
+        + developers.heapSize()
+        + publishers.heapSize()
+        + genres.heapSize();
+
+    if (m_extra) {
+        sum += sizeof(HashMap<QString, QString>) + hashmap_heap_size(*m_extra);
+        for (const auto& keyval : *m_extra)
+            sum += heap_size(keyval.first) + heap_size(keyval.second);
+    }
+
+    // the directory paths are shared
+    sum += heap_size(m_path.fileName());
+
+    return sum;
 }
 
 } // namespace modeldata
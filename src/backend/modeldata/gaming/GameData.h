@@ -20,20 +20,70 @@
 #include "GameAssetsData.h"
 #include "utils/HashMap.h"
 #include "utils/MoveOnly.h"
+#include "utils/StringIntern.h"
 
 #include <QDateTime>
 #include <QFileInfo>
 #include <QString>
 #include <QStringList>
+#include <memory>
+
+class QDataStream;
 
 
 namespace modeldata {
 
+/// The path of a game's file, split into the parts that are commonly used, so
+/// they don't have to be calculated (or read from the disk) again. The directory
+/// paths are interned, so they are stored only once for all games in a directory.
+class GamePath {
+public:
+    GamePath();
+    /// Reads the canonical path through the QFileInfo, which may access the disk
+    explicit GamePath(const QFileInfo&);
+    /// The canonical path should be empty if the file doesn't exist
+    GamePath(const QString& dir_path, QString file_name, const QString& canonical_file_path);
+
+    /// Null if the path had no directory part
+    const QString& dirPath() const { return m_dir_path; }
+    const QString& fileName() const { return m_file_name; }
+    QString filePath() const;
+    QString completeBaseName() const { return m_file_name.left(m_basename_len); }
+    QString suffix() const;
+
+    QString absoluteDirPath() const;
+    QString absoluteFilePath() const;
+    /// Empty if the file didn't exist when the path was created
+    const QString& canonicalDirPath() const { return m_canonical_dir_path; }
+    /// Empty if the file didn't exist when the path was created
+    QString canonicalFilePath() const;
+
+private:
+    QString m_dir_path;
+    QString m_file_name;
+    QString m_canonical_dir_path;
+    // null if it's the same as the file name
+    QString m_canonical_file_name;
+    int m_basename_len;
+
+    void setCanonicalPath(const QString&);
+
+    friend QDataStream& operator<<(QDataStream&, const GamePath&);
+    friend QDataStream& operator>>(QDataStream&, GamePath&);
+};
+
+QDataStream& operator<<(QDataStream&, const GamePath&);
+QDataStream& operator>>(QDataStream&, GamePath&);
+
+
 struct Game {
-    explicit Game(QFileInfo fileinfo);
+    explicit Game(GamePath path);
+    explicit Game(const QFileInfo& fileinfo);
     MOVE_ONLY(Game)
 
-    const QFileInfo& fileinfo() const { return m_fileinfo; }
+    const GamePath& path() const { return m_path; }
+    /// Estimated heap memory held by the fields, not counting the assets
+    size_t heapSize() const;
 
     QString title;
     QString summary;
@@ -41,24 +91,32 @@ struct Game {
     QString launch_cmd;
     QString launch_workdir;
 
-    int player_count;
-    bool is_favorite;
-    float rating;
+    // the numeric fields are grouped by size to avoid padding
     QDate release_date;
-
-    int playcount;
     qint64 playtime;
     QDateTime last_played;
+    int player_count;
+    int playcount;
+    float rating;
+    bool is_favorite;
 
-    QStringList developers;
-    QStringList publishers;
-    QStringList genres;
+    // only a few hundred different values even in large libraries
+    InternedStringList developers;
+    InternedStringList publishers;
+    InternedStringList genres;
 
-    HashMap<QString, QString> extra; // TODO: remove
     GameAssets assets;
 
+    // values used only by some providers, allocated on the first use
+    const QString& extra(const QString& key) const;
+    bool hasExtra(const QString& key) const;
+    void setExtra(QString key, QString value);
+    /// All extra values, possibly an empty map
+    const HashMap<QString, QString>& extras() const;
+
 private:
-    QFileInfo m_fileinfo;
+    GamePath m_path;
+    std::unique_ptr<HashMap<QString, QString>> m_extra;
 };
 
 } // namespace modeldata
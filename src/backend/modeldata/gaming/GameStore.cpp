@@ -0,0 +1,110 @@
+// Pegasus Frontend
+// Copyright (C) 2018  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "GameStore.h"
+
+
+namespace modeldata {
+
+void GameStore::reserve(size_t count)
+{
+    m_games.reserve(count);
+    m_keys.reserve(count);
+    m_ids.reserve(count);
+}
+
+void GameStore::clear()
+{
+    m_games.clear();
+    m_keys.clear();
+    m_ids.clear();
+    m_path_index.reset();
+}
+
+GameId GameStore::find(const QString& key) const
+{
+    const auto it = m_ids.find(key);
+    return it != m_ids.cend()
+        ? it->second
+        : INVALID_GAMEID;
+}
+
+GameId GameStore::add(QString key, Game game)
+{
+    Q_ASSERT(!contains(key));
+    Q_ASSERT(m_games.size() < INVALID_GAMEID);
+
+    const GameId id = static_cast<GameId>(m_games.size());
+    m_ids.emplace(key, id);
+    m_keys.push_back(std::move(key));
+    m_games.push_back(std::move(game));
+    m_path_index.reset();
+    return id;
+}
+
+GamePathIndex& GameStore::pathIndex()
+{
+    if (m_path_index)
+        return *m_path_index;
+
+    m_path_index.reset(new GamePathIndex());
+    for (GameId id = 0; id < m_games.size(); id++) {
+        const GamePath& path = m_games[id].path();
+        if (!path.canonicalDirPath().isEmpty())
+            m_path_index->add(path.canonicalDirPath(), path.completeBaseName(), id);
+    }
+
+    return *m_path_index;
+}
+
+
+GamePathIndex::GamePathIndex()
+    : m_dirs(arena_hashmap<QString, DirGames>(m_arena))
+{}
+
+void GamePathIndex::add(const QString& dir_key, QString basename, GameId id)
+{
+    auto it = m_dirs.find(dir_key);
+    if (it == m_dirs.end())
+        it = m_dirs.emplace(dir_key, arena_hashmap<QString, GameId>(m_arena)).first;
+
+    // of the games with the same name, the first one is kept
+    it->second.emplace(std::move(basename), id);
+}
+
+const GamePathIndex::DirGames* GamePathIndex::findDir(const QString& dir_key) const
+{
+    const auto it = m_dirs.find(dir_key);
+    return it != m_dirs.cend()
+        ? &it->second
+        : nullptr;
+}
+
+GameId GamePathIndex::find(const DirGames* dir_games, const QStringRef& basename)
+{
+    if (!dir_games)
+        return INVALID_GAMEID;
+
+    // the key only refers to the existing characters, nothing is copied
+    const QString key = QString::fromRawData(basename.unicode(), basename.size());
+    const auto it = dir_games->find(key);
+    return it != dir_games->cend()
+        ? it->second
+        : INVALID_GAMEID;
+}
+
+} // namespace modeldata
@@ -0,0 +1,101 @@
+// Pegasus Frontend
+// Copyright (C) 2018  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include "GameData.h"
+#include "utils/FwdDeclModelData.h"
+#include "utils/HashMap.h"
+#include "utils/MonotonicArena.h"
+#include "utils/MoveOnly.h"
+#include "utils/NoCopyNoMove.h"
+
+#include <QString>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+
+namespace modeldata {
+
+constexpr GameId INVALID_GAMEID = std::numeric_limits<GameId>::max();
+
+/// Finds games by the directory and the extensionless name of their file.
+/// The directory is looked up once, then the names can be found without
+/// creating a new string for every lookup. The tables live only during
+/// a search, so their memory is taken from an arena.
+class GamePathIndex {
+public:
+    using DirGames = ArenaHashMap<QString, GameId>;
+
+    GamePathIndex();
+    NO_COPY_NO_MOVE(GamePathIndex)
+
+    /// The directory key is usually a canonical directory path, but can be
+    /// any other string (eg. the name of a collection)
+    void add(const QString& dir_key, QString basename, GameId);
+
+    /// Returns nullptr if there are no games under this key
+    const DirGames* findDir(const QString& dir_key) const;
+    /// Returns INVALID_GAMEID if there's no game with this name
+    static GameId find(const DirGames*, const QStringRef& basename);
+
+private:
+    MonotonicArena m_arena;
+    ArenaHashMap<QString, DirGames> m_dirs;
+};
+
+/// The games found during a search, stored contiguously and referred to by
+/// their index. The key of a game (usually its canonical path) is only used
+/// to find a game that's already known, eg. when it's mentioned in a file.
+class GameStore {
+public:
+    GameStore() = default;
+    MOVE_ONLY(GameStore)
+
+    size_t size() const { return m_games.size(); }
+    bool empty() const { return m_games.empty(); }
+    void reserve(size_t count);
+    void clear();
+
+    /// Returns INVALID_GAMEID if there's no game with this key
+    GameId find(const QString& key) const;
+    bool contains(const QString& key) const { return m_ids.count(key) > 0; }
+    /// The key must not be in use yet. The references to the games
+    /// may be invalidated, the IDs are not.
+    GameId add(QString key, Game game);
+
+    Game& at(GameId id) { Q_ASSERT(id < m_games.size()); return m_games[id]; }
+    const Game& at(GameId id) const { Q_ASSERT(id < m_games.size()); return m_games[id]; }
+    const QString& key(GameId id) const { Q_ASSERT(id < m_keys.size()); return m_keys[id]; }
+
+    /// The games by their canonical directory and extensionless file name.
+    /// Built on the first use after adding games, so only once per search;
+    /// the search builds it before the static data stages, which can then
+    /// read it in parallel. The users should not add entries to it.
+    GamePathIndex& pathIndex();
+
+private:
+    std::vector<Game> m_games;
+    std::vector<QString> m_keys;
+    HashMap<QString, GameId> m_ids;
+
+    std::unique_ptr<GamePathIndex> m_path_index;
+};
+
+} // namespace modeldata
@@ -0,0 +1,131 @@
+// Pegasus Frontend
+// Copyright (C) 2018  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "AssetResolver.h"
+
+#include "PegasusAssets.h"
+#include "filesystem/DirCache.h"
+#include "modeldata/gaming/GameData.h"
+#include "types/AssetType.h"
+
+#include <QStringList>
+
+
+namespace {
+// a string that uses the characters of the reference, without copying them
+QString raw_string(const QStringRef& ref)
+{
+    return QString::fromRawData(ref.unicode(), ref.size());
+}
+
+bool ext_allowed(AssetType type, const QStringRef& ext)
+{
+    return pegasus_assets::allowed_asset_exts(type).contains(raw_string(ext));
+}
+} // namespace
+
+
+namespace providers {
+
+AssetResolver::AssetResolver(modeldata::GameStore& games)
+    : m_games(games)
+    , m_index(games.pathIndex())
+    , m_added_count(0)
+{}
+
+AssetType AssetResolver::typeByName(const QStringRef& basename, const QStringRef& ext)
+{
+    const AssetType type = pegasus_assets::str_to_type(raw_string(basename));
+    if (type != AssetType::UNKNOWN && ext_allowed(type, ext))
+        return type;
+
+    return AssetType::UNKNOWN;
+}
+
+AssetType AssetResolver::typeByNameSuffix(const filesystem::DirEntry& file, QStringRef& game_basename)
+{
+    const QStringRef basename = file.completeBaseNameRef();
+    const QStringRef ext = file.suffixRef();
+    const int last_dash = basename.lastIndexOf(QLatin1Char('-'));
+
+    // missing/unknown suffix -> guess by extension
+    const AssetType type = last_dash == -1
+        ? AssetType::UNKNOWN
+        : pegasus_assets::str_to_type(raw_string(basename.mid(last_dash + 1)));
+    if (type == AssetType::UNKNOWN) {
+        game_basename = basename;
+        return pegasus_assets::ext_to_type(raw_string(ext));
+    }
+
+    // known suffix but wrong extension -> invalid
+    game_basename = basename.left(last_dash);
+    if (!ext_allowed(type, ext))
+        return AssetType::UNKNOWN;
+
+    // known suffix and valid extension
+    return type;
+}
+
+void AssetResolver::addAlias(const QString& dir_key, modeldata::GameId game_id)
+{
+    m_aliases.add(dir_key, m_games.at(game_id).path().completeBaseName(), game_id);
+}
+
+const AssetResolver::DirGames* AssetResolver::findDir(const QString& dir_key) const
+{
+    const DirGames* const dir_games = m_index.findDir(dir_key);
+    return dir_games ? dir_games : m_aliases.findDir(dir_key);
+}
+
+bool AssetResolver::addFile(modeldata::GameId game_id, AssetType type,
+                            const QString& dir_path, const QString& file_name)
+{
+    if (game_id == modeldata::INVALID_GAMEID || type == AssetType::UNKNOWN)
+        return false;
+
+    if (!m_games.at(game_id).assets.addFileMaybe(type, dir_path, file_name))
+        return false;
+
+    m_added_count++;
+    return true;
+}
+
+void AssetResolver::forEachMirroredDir(const QString& games_dir, const QString& media_dir,
+                                       const std::function<void(const QString&, const QString&, const filesystem::DirListing&)>& callback) const
+{
+    filesystem::DirCache& dir_cache = filesystem::dir_cache();
+
+    const QString media_root = dir_cache.list(media_dir).canonical_path;
+    const QString games_root = dir_cache.list(games_dir).canonical_path;
+    if (media_root.isEmpty() || games_root.isEmpty())
+        return;
+
+    dir_cache.forEachDir(media_dir, [&](const QString& dir_path, const filesystem::DirListing& listing){
+        // directories linked from outside of the media tree are not mirrored
+        const QString& canonical_path = listing.canonical_path;
+        if (!canonical_path.startsWith(media_root))
+            return;
+        if (canonical_path.length() > media_root.length() && canonical_path.at(media_root.length()) != QLatin1Char('/'))
+            return;
+
+        QString mirrored_dir = games_root;
+        mirrored_dir += canonical_path.midRef(media_root.length());
+        callback(mirrored_dir, dir_path, listing);
+    });
+}
+
+} // namespace providers
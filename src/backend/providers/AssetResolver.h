@@ -0,0 +1,78 @@
+// Pegasus Frontend
+// Copyright (C) 2018  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include "modeldata/gaming/GameStore.h"
+
+#include <QString>
+#include <QStringRef>
+#include <functional>
+
+enum class AssetType : unsigned char;
+namespace filesystem { struct DirEntry; struct DirListing; }
+
+
+namespace providers {
+
+/// Matches the media files found by the providers to the games of a search.
+/// The games are looked up through the path index of the game store, which
+/// is built once per search and shared (read only) by all providers, and the
+/// asset type detection and the priority rules are also kept here, in one place.
+/// No games should be added to the store while the resolver is in use.
+class AssetResolver {
+public:
+    using DirGames = modeldata::GamePathIndex::DirGames;
+
+    explicit AssetResolver(modeldata::GameStore&);
+
+    /// The type of a file named after the asset type, eg. `boxFront.png`
+    static AssetType typeByName(const QStringRef& basename, const QStringRef& ext);
+    /// The type of a file named as `<game>-<asset type>.<ext>`, or if there's no known
+    /// asset type in the name, guessed by the extension; `game_basename` is set to the game part
+    static AssetType typeByNameSuffix(const filesystem::DirEntry&, QStringRef& game_basename);
+
+    /// Also makes the game findable under this key, eg. the name of its collection;
+    /// the aliases are only known by this resolver
+    void addAlias(const QString& dir_key, modeldata::GameId);
+    /// Returns nullptr if there are no games under this key
+    const DirGames* findDir(const QString& dir_key) const;
+    static modeldata::GameId findGame(const DirGames* dir_games, const QStringRef& basename) {
+        return modeldata::GamePathIndex::find(dir_games, basename);
+    }
+
+    /// Offers a file as an asset of the game. For single value types, the first
+    /// file wins, so the providers and the locations within them should add their
+    /// candidates in the order of priority. Returns false if the file was not used.
+    bool addFile(modeldata::GameId, AssetType, const QString& dir_path, const QString& file_name);
+    size_t addedCount() const { return m_added_count; }
+
+    /// Walks `media_dir`, a directory tree that mirrors the layout of `games_dir`:
+    /// the files in `<media_dir>/<sub path>` belong to the games in `<games_dir>/<sub path>`.
+    /// The callback is called for every directory, with the canonical path of the
+    /// game directory it mirrors, computed once per directory.
+    void forEachMirroredDir(const QString& games_dir, const QString& media_dir,
+                            const std::function<void(const QString&, const QString&, const filesystem::DirListing&)>& callback) const;
+
+private:
+    modeldata::GameStore& m_games;
+    const modeldata::GamePathIndex& m_index;
+    modeldata::GamePathIndex m_aliases;
+    size_t m_added_count;
+};
+
+} // namespace providers
@@ -0,0 +1,378 @@
+// Pegasus Frontend
+// Copyright (C) 2018  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "LibrarySnapshot.h"
+
+#include "LocaleUtils.h"
+#include "Paths.h"
+#include "Trace.h"
+#include "modeldata/gaming/CollectionData.h"
+#include "modeldata/gaming/GameData.h"
+#include "modeldata/gaming/GameStore.h"
+
+#include <QBuffer>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDebug>
+#include <QFile>
+#include <QSaveFile>
+#include <algorithm>
+
+
+namespace {
+static constexpr auto MSG_PREFIX = "Snapshot:";
+
+// increase this when the layout of the serialized data changes
+constexpr quint32 SNAPSHOT_MAGIC = 0x50474c53; // "PGLS"
+constexpr quint32 SNAPSHOT_FORMAT = 4;
+constexpr auto STREAM_VERSION = QDataStream::Qt_5_6;
+
+template<typename T>
+std::vector<const QString*> sorted_keys(const HashMap<QString, T>& map)
+{
+    std::vector<const QString*> keys;
+    keys.reserve(map.size());
+    for (const auto& keyval : map)
+        keys.push_back(&keyval.first);
+
+    std::sort(keys.begin(), keys.end(),
+        [](const QString* const a, const QString* const b){ return *a < *b; });
+    return keys;
+}
+
+// the games in the order of their keys
+std::vector<modeldata::GameId> sorted_game_ids(const modeldata::GameStore& games)
+{
+    std::vector<modeldata::GameId> ids(games.size());
+    for (modeldata::GameId game_id = 0; game_id < ids.size(); game_id++)
+        ids[game_id] = game_id;
+
+    std::sort(ids.begin(), ids.end(),
+        [&games](const modeldata::GameId a, const modeldata::GameId b){ return games.key(a) < games.key(b); });
+    return ids;
+}
+
+bool stream_ok(const QDataStream& stream)
+{
+    return stream.status() == QDataStream::Ok;
+}
+
+void write_collection(QDataStream& stream, const modeldata::Collection& coll)
+{
+    stream << coll.name
+           << coll.shortName()
+           << coll.summary
+           << coll.description
+           << coll.launch_cmd
+           << coll.launch_workdir
+           << coll.default_assets;
+}
+
+void read_collection(QDataStream& stream, HashMap<QString, modeldata::Collection>& collections)
+{
+    QString name;
+    QString short_name;
+    stream >> name >> short_name;
+
+    modeldata::Collection coll(name);
+    if (!short_name.isEmpty())
+        coll.setShortName(short_name);
+
+    stream >> coll.summary
+           >> coll.description
+           >> coll.launch_cmd
+           >> coll.launch_workdir
+           >> coll.default_assets;
+
+    if (stream_ok(stream))
+        collections.emplace(std::move(name), std::move(coll));
+}
+
+void write_game(QDataStream& stream, const QString& key, const modeldata::Game& game)
+{
+    stream << key
+           << game.path()
+           << game.title
+           << game.summary
+           << game.description
+           << game.launch_cmd
+           << game.launch_workdir
+           << static_cast<qint32>(game.player_count)
+           << game.is_favorite
+           << game.rating
+           << game.release_date
+           << static_cast<qint32>(game.playcount)
+           << game.playtime
+           << game.last_played
+           << game.developers
+           << game.publishers
+           << game.genres;
+
+    const auto extra_keys = sorted_keys(game.extras());
+    stream << static_cast<quint32>(extra_keys.size());
+    for (const QString* const extra_key : extra_keys)
+        stream << *extra_key << game.extra(*extra_key);
+
+    stream << game.assets;
+}
+
+void read_game(QDataStream& stream, modeldata::GameStore& games)
+{
+    QString key;
+    modeldata::GamePath path;
+    stream >> key >> path;
+
+    modeldata::Game game { std::move(path) };
+
+    qint32 player_count = 0;
+    qint32 playcount = 0;
+    stream >> game.title
+           >> game.summary
+           >> game.description
+           >> game.launch_cmd
+           >> game.launch_workdir
+           >> player_count
+           >> game.is_favorite
+           >> game.rating
+           >> game.release_date
+           >> playcount
+           >> game.playtime
+           >> game.last_played
+           >> game.developers
+           >> game.publishers
+           >> game.genres;
+    game.player_count = player_count;
+    game.playcount = playcount;
+
+    quint32 extra_count = 0;
+    stream >> extra_count;
+    for (quint32 i = 0; i < extra_count && stream_ok(stream); i++) {
+        QString extra_key;
+        QString extra_val;
+        stream >> extra_key >> extra_val;
+        game.setExtra(std::move(extra_key), std::move(extra_val));
+    }
+
+    stream >> game.assets;
+
+    if (!stream_ok(stream))
+        return;
+    if (games.contains(key)) {
+        stream.setStatus(QDataStream::ReadCorruptData);
+        return;
+    }
+    games.add(std::move(key), std::move(game));
+}
+
+// the children are stored as their position in the sorted game list
+void write_childs(QDataStream& stream,
+                  const QString& coll_name,
+                  const std::vector<modeldata::GameId>& childs,
+                  const std::vector<quint32>& game_positions)
+{
+    stream << coll_name << static_cast<quint32>(childs.size());
+    for (const modeldata::GameId child : childs)
+        stream << game_positions[child];
+}
+
+void read_childs(QDataStream& stream, HashMap<QString, std::vector<modeldata::GameId>>& collection_childs)
+{
+    QString coll_name;
+    quint32 child_count = 0;
+    stream >> coll_name >> child_count;
+
+    std::vector<modeldata::GameId> childs;
+    for (quint32 i = 0; i < child_count && stream_ok(stream); i++) {
+        quint32 child = 0;
+        stream >> child;
+        childs.push_back(child);
+    }
+
+    if (stream_ok(stream))
+        collection_childs.emplace(std::move(coll_name), std::move(childs));
+}
+
+bool read_payload(QDataStream& stream,
+                  modeldata::GameStore& games,
+                  HashMap<QString, modeldata::Collection>& collections,
+                  HashMap<QString, std::vector<modeldata::GameId>>& collection_childs)
+{
+    quint32 coll_count = 0;
+    stream >> coll_count;
+    for (quint32 i = 0; i < coll_count && stream_ok(stream); i++)
+        read_collection(stream, collections);
+
+    // the games are read in their stored order, so their IDs are their positions
+    quint32 game_count = 0;
+    stream >> game_count;
+    for (quint32 i = 0; i < game_count && stream_ok(stream); i++)
+        read_game(stream, games);
+
+    quint32 childlist_count = 0;
+    stream >> childlist_count;
+    for (quint32 i = 0; i < childlist_count && stream_ok(stream); i++)
+        read_childs(stream, collection_childs);
+
+    if (!stream_ok(stream) || !stream.atEnd())
+        return false;
+
+    // every child must be a known game of a known collection
+    for (const auto& keyval : collection_childs) {
+        if (!collections.count(keyval.first))
+            return false;
+        for (const modeldata::GameId child : keyval.second) {
+            if (games.size() <= child)
+                return false;
+        }
+    }
+    return true;
+}
+} // namespace
+
+
+namespace providers {
+namespace snapshot {
+
+QString default_path()
+{
+    return paths::writableCacheDir() + QStringLiteral("/library.snapshot");
+}
+
+QByteArray serialize(const modeldata::GameStore& games,
+                     const HashMap<QString, modeldata::Collection>& collections,
+                     const HashMap<QString, std::vector<modeldata::GameId>>& collection_childs)
+{
+    QByteArray payload;
+    QDataStream stream(&payload, QIODevice::WriteOnly);
+    stream.setVersion(STREAM_VERSION);
+
+    const auto coll_keys = sorted_keys(collections);
+    stream << static_cast<quint32>(coll_keys.size());
+    for (const QString* const key : coll_keys)
+        write_collection(stream, collections.at(*key));
+
+    // the IDs depend on the order the games were found in
+    const std::vector<modeldata::GameId> game_order = sorted_game_ids(games);
+    std::vector<quint32> game_positions(games.size());
+    stream << static_cast<quint32>(game_order.size());
+    for (size_t i = 0; i < game_order.size(); i++) {
+        const modeldata::GameId game_id = game_order[i];
+        game_positions[game_id] = static_cast<quint32>(i);
+        write_game(stream, games.key(game_id), games.at(game_id));
+    }
+
+    // the order of children matters
+    const auto childlist_keys = sorted_keys(collection_childs);
+    stream << static_cast<quint32>(childlist_keys.size());
+    for (const QString* const key : childlist_keys)
+        write_childs(stream, *key, collection_childs.at(*key), game_positions);
+
+    return payload;
+}
+
+QByteArray checksum(const QByteArray& payload)
+{
+    return QCryptographicHash::hash(payload, QCryptographicHash::Sha1);
+}
+
+bool write(const QString& path, const QByteArray& payload)
+{
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning().noquote() << MSG_PREFIX << tr_log("could not create `%1`").arg(path);
+        return false;
+    }
+
+    {
+        QDataStream stream(&file);
+        stream.setVersion(STREAM_VERSION);
+        stream << SNAPSHOT_MAGIC
+               << SNAPSHOT_FORMAT
+               << QStringLiteral(GIT_REVISION)
+               << checksum(payload);
+    }
+    file.write(payload);
+
+    if (!file.commit()) {
+        qWarning().noquote() << MSG_PREFIX << tr_log("writing `%1` failed").arg(path);
+        return false;
+    }
+    return true;
+}
+
+QByteArray read(const QString& path,
+                modeldata::GameStore& games,
+                HashMap<QString, modeldata::Collection>& collections,
+                HashMap<QString, std::vector<modeldata::GameId>>& collection_childs)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return {};
+
+    const qint64 file_size = file.size();
+    const uchar* const file_data = file.map(0, file_size);
+    if (!file_data)
+        return {};
+
+    TRACE_COUNT("bytes read", file_size);
+
+    const QByteArray raw = QByteArray::fromRawData(reinterpret_cast<const char*>(file_data),
+                                                   static_cast<int>(file_size));
+    QBuffer buffer;
+    buffer.setData(raw);
+    buffer.open(QIODevice::ReadOnly);
+
+    QDataStream stream(&buffer);
+    stream.setVersion(STREAM_VERSION);
+
+    quint32 magic = 0;
+    quint32 format = 0;
+    QString revision;
+    QByteArray expected_checksum;
+    stream >> magic >> format >> revision >> expected_checksum;
+
+    const bool header_ok = stream_ok(stream)
+        && magic == SNAPSHOT_MAGIC
+        && format == SNAPSHOT_FORMAT
+        && revision == QLatin1String(GIT_REVISION);
+    if (!header_ok) {
+        qInfo().noquote() << MSG_PREFIX
+            << tr_log("`%1` was created by a different version, ignored").arg(path);
+        return {};
+    }
+
+    const qint64 payload_start = buffer.pos();
+    const QByteArray payload = QByteArray::fromRawData(raw.constData() + payload_start,
+                                                       static_cast<int>(file_size - payload_start));
+    if (checksum(payload) != expected_checksum) {
+        qWarning().noquote() << MSG_PREFIX << tr_log("`%1` is corrupt, ignored").arg(path);
+        return {};
+    }
+
+    if (!read_payload(stream, games, collections, collection_childs)) {
+        qWarning().noquote() << MSG_PREFIX << tr_log("`%1` could not be read, ignored").arg(path);
+        games.clear();
+        collections.clear();
+        collection_childs.clear();
+        return {};
+    }
+
+    return expected_checksum;
+}
+
+} // namespace snapshot
+} // namespace providers
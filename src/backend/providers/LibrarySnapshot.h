@@ -0,0 +1,55 @@
+// Pegasus Frontend
+// Copyright (C) 2018  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include "utils/FwdDeclModelData.h"
+#include "utils/HashMap.h"
+
+#include <QByteArray>
+#include <QString>
+#include <vector>
+
+
+namespace providers {
+namespace snapshot {
+
+/// The default location of the library snapshot
+QString default_path();
+
+/// Serializes the games and collections; the result is always
+/// the same for the same contents, regardless of the hash map order
+QByteArray serialize(const modeldata::GameStore&,
+                     const HashMap<QString, modeldata::Collection>&,
+                     const HashMap<QString, std::vector<modeldata::GameId>>&);
+
+/// Returns a fingerprint of the serialized data
+QByteArray checksum(const QByteArray& payload);
+
+/// Writes the serialized data to the file, replacing the previous one atomically
+bool write(const QString& path, const QByteArray& payload);
+
+/// Reads the snapshot file into the containers, and returns the checksum of its data.
+/// If the file is missing, corrupt or was made by a different version of the program,
+/// an empty value is returned and the containers are left empty.
+QByteArray read(const QString& path,
+                modeldata::GameStore&,
+                HashMap<QString, modeldata::Collection>&,
+                HashMap<QString, std::vector<modeldata::GameId>>&);
+
+} // namespace snapshot
+} // namespace providers
@@ -0,0 +1,135 @@
+// Pegasus Frontend
+// Copyright (C) 2018  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "MediaRoots.h"
+
+#include "AssetResolver.h"
+#include "filesystem/DirCache.h"
+#include "modeldata/gaming/GameAssetsData.h"
+#include "modeldata/gaming/GameData.h"
+
+
+namespace {
+bool is_same_or_subdir(const QString& dir_path, const QString& parent_path)
+{
+    return dir_path.startsWith(parent_path)
+        && (dir_path.length() == parent_path.length() || dir_path.at(parent_path.length()) == QLatin1Char('/'));
+}
+} // namespace
+
+
+namespace providers {
+
+void MediaRoots::addNamedRoot(const QString& games_dir, const QString& media_dir)
+{
+    addRoot(games_dir, media_dir, AssetType::UNKNOWN);
+}
+
+void MediaRoots::addTypedRoot(const QString& games_dir, const QString& media_dir, AssetType asset_type)
+{
+    Q_ASSERT(asset_type != AssetType::UNKNOWN);
+    addRoot(games_dir, media_dir, asset_type);
+}
+
+void MediaRoots::addRoot(const QString& games_dir, const QString& media_dir, AssetType asset_type)
+{
+    // only the existing directories are kept, with their canonical path
+    filesystem::DirCache& dir_cache = filesystem::dir_cache();
+    QString games_root = dir_cache.list(games_dir).canonical_path;
+    QString media_root = dir_cache.list(media_dir).canonical_path;
+    if (games_root.isEmpty() || media_root.isEmpty())
+        return;
+
+    m_roots.push_back({ std::move(games_root), std::move(media_root), asset_type });
+}
+
+std::shared_ptr<const MediaRoots::DirIndex> MediaRoots::dirIndex(const QString& dir_path) const
+{
+    {
+        QMutexLocker lock(&m_index_guard);
+        const auto it = m_dir_indices.find(dir_path);
+        if (it != m_dir_indices.cend())
+            return it->second;
+    }
+
+    std::shared_ptr<DirIndex> index(new DirIndex());
+    const filesystem::DirListing listing = filesystem::dir_cache().list(dir_path);
+    for (const filesystem::DirEntry& entry : listing.entries) {
+        if (entry.is_dir)
+            index->subdirs.insert(entry.name);
+        else
+            index->files[entry.completeBaseName()].append(entry.name);
+    }
+
+    // another thread may have read the same directory in the meantime
+    QMutexLocker lock(&m_index_guard);
+    return m_dir_indices.emplace(dir_path, std::move(index)).first->second;
+}
+
+void MediaRoots::clearIndex()
+{
+    QMutexLocker lock(&m_index_guard);
+    m_dir_indices.clear();
+}
+
+void MediaRoots::findAssets(const modeldata::GamePath& game_path, modeldata::GameAssets& assets) const
+{
+    const QString& game_dir = game_path.canonicalDirPath();
+    if (game_dir.isEmpty())
+        return;
+
+    const QString basename = game_path.completeBaseName();
+
+    for (const Root& root : m_roots) {
+        if (!is_same_or_subdir(game_dir, root.games_dir))
+            continue;
+
+        QString media_dir = root.media_dir;
+        media_dir += game_dir.midRef(root.games_dir.length());
+
+        const std::shared_ptr<const DirIndex> index = dirIndex(media_dir);
+
+        if (root.asset_type == AssetType::UNKNOWN) {
+            if (!index->subdirs.contains(basename))
+                continue;
+
+            // every game has its own directory, which is only read once
+            media_dir += QLatin1Char('/');
+            media_dir += basename;
+
+            const filesystem::DirListing listing = filesystem::dir_cache().list(media_dir);
+            for (const filesystem::DirEntry& entry : listing.entries) {
+                if (entry.is_dir)
+                    continue;
+
+                const AssetType asset_type = AssetResolver::typeByName(entry.completeBaseNameRef(), entry.suffixRef());
+                if (asset_type != AssetType::UNKNOWN)
+                    assets.addFileMaybe(asset_type, media_dir, entry.name);
+            }
+        }
+        else {
+            const auto it = index->files.constFind(basename);
+            if (it == index->files.cend())
+                continue;
+
+            for (const QString& file_name : *it)
+                assets.addFileMaybe(root.asset_type, media_dir, file_name);
+        }
+    }
+}
+
+} // namespace providers
@@ -0,0 +1,80 @@
+// Pegasus Frontend
+// Copyright (C) 2018  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include "types/AssetType.h"
+#include "utils/FwdDeclModelData.h"
+#include "utils/HashMap.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <memory>
+#include <vector>
+
+
+namespace providers {
+
+/// The media directories found during a search, for looking up the assets of
+/// a game only when it's first shown, instead of searching every media file
+/// of the library in advance. Every media directory is read only once, the first
+/// time a game needs it, and kept as an index until the next search or live update.
+class MediaRoots {
+public:
+    /// `<media_dir>/<sub path>/<game basename>/` contains the assets of the game
+    /// in `<games_dir>/<sub path>`, in files named after the asset types
+    void addNamedRoot(const QString& games_dir, const QString& media_dir);
+    /// `<media_dir>/<sub path>/` contains assets of the given type for the games
+    /// in `<games_dir>/<sub path>`, in files named after the games
+    void addTypedRoot(const QString& games_dir, const QString& media_dir, AssetType);
+
+    bool empty() const { return m_roots.empty(); }
+    size_t size() const { return m_roots.size(); }
+
+    /// Adds the assets of the game found in the media directories, in the order
+    /// the directories were added. Thread safe, as long as no roots are added.
+    void findAssets(const modeldata::GamePath&, modeldata::GameAssets&) const;
+    /// Forgets the contents of the media directories, so they are read again on
+    /// their next use; to be called when new games may have appeared. Thread safe.
+    void clearIndex();
+
+private:
+    struct Root {
+        QString games_dir;
+        QString media_dir;
+        // unknown if the files are named after the types
+        AssetType asset_type;
+    };
+    std::vector<Root> m_roots;
+
+    struct DirIndex {
+        /// The files of the directory, by their complete base name
+        QHash<QString, QStringList> files;
+        QSet<QString> subdirs;
+    };
+    mutable QMutex m_index_guard;
+    mutable HashMap<QString, std::shared_ptr<const DirIndex>> m_dir_indices;
+
+    void addRoot(const QString& games_dir, const QString& media_dir, AssetType);
+    /// Returns the index of the directory, reading it on the first use
+    std::shared_ptr<const DirIndex> dirIndex(const QString& dir_path) const;
+};
+
+} // namespace providers
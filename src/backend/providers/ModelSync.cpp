@@ -0,0 +1,600 @@
+// Pegasus Frontend
+// Copyright (C) 2018  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "ModelSync.h"
+
+#include "Trace.h"
+#include "model/gaming/Collection.h"
+#include "model/gaming/GameLibrary.h"
+#include "model/gaming/GameListModel.h"
+#include "utils/Collation.h"
+
+#include "QtQmlTricks/QQmlObjectListModel.h"
+#include <QSet>
+#include <QSignalBlocker>
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+
+
+namespace {
+// Beyond these, replacing the whole list is cheaper than the individual row changes
+constexpr int MAX_ROW_MOVES = 64;
+constexpr int MAX_INSERT_RUNS = 1024;
+
+bool collection_name_less(const model::Collection* const a, const model::Collection* const b)
+{
+    return collation_compare(a->name(), b->name()) < 0;
+}
+
+QString collection_name(const model::Collection* const coll)
+{
+    return coll->name();
+}
+
+// Marks the items of a longest increasing subsequence of `values`
+std::vector<bool> longest_increasing(const std::vector<int>& values)
+{
+    std::vector<int> tail_idxs;
+    std::vector<int> prev_idxs(values.size(), -1);
+
+    for (size_t i = 0; i < values.size(); i++) {
+        const auto it = std::lower_bound(tail_idxs.begin(), tail_idxs.end(), values[i],
+            [&values](const int idx, const int val){ return values[idx] < val; });
+        if (it != tail_idxs.begin())
+            prev_idxs[i] = *(it - 1);
+
+        if (it == tail_idxs.end())
+            tail_idxs.push_back(static_cast<int>(i));
+        else
+            *it = static_cast<int>(i);
+    }
+
+    std::vector<bool> result(values.size(), false);
+    for (int i = tail_idxs.empty() ? -1 : tail_idxs.back(); i >= 0; i = prev_idxs[i])
+        result[i] = true;
+
+    return result;
+}
+
+template<typename T>
+void replace_items(QQmlObjectListModel<T>& model, const QVector<T*>& items)
+{
+    // the model would delete the items it owns on removal
+    for (T* const item : model.asList()) {
+        if (item->parent() == &model)
+            item->setParent(nullptr);
+    }
+
+    model.clear();
+    model.append(items);
+}
+
+void replace_items(model::GameListModel& model, const QVector<model::GameSlot>& items)
+{
+    model.setItems(items);
+}
+
+// Changes the contents of the model to `target`; removed objects owned by the model get deleted
+template<typename Model, typename Item>
+void set_items(Model& model, const QVector<Item>& target)
+{
+    if (model.asList() == target)
+        return;
+
+    QSet<Item> target_set;
+    target_set.reserve(target.count());
+    for (const Item item : target)
+        target_set.insert(item);
+
+    for (int i = model.count() - 1; i >= 0; i--) {
+        if (!target_set.contains(model.at(i)))
+            model.remove(i);
+    }
+
+
+    // the items already in the model, in their final order
+    QSet<Item> kept_set;
+    kept_set.reserve(model.count());
+    for (const Item item : model.asList())
+        kept_set.insert(item);
+
+    QVector<Item> kept_order;
+    kept_order.reserve(model.count());
+    for (const Item item : target) {
+        if (kept_set.contains(item))
+            kept_order.append(item);
+    }
+
+    int insert_runs = 0;
+    for (int i = 0; i < target.count(); i++) {
+        const bool run_start = !kept_set.contains(target.at(i))
+            && (i == 0 || kept_set.contains(target.at(i - 1)));
+        if (run_start)
+            insert_runs++;
+    }
+
+    // only the items outside of the longest correctly ordered sequence have to move
+    std::vector<bool> stays;
+    if (model.asList() != kept_order) {
+        HashMap<Item, int> target_idxs;
+        target_idxs.reserve(kept_order.count());
+        for (int i = 0; i < kept_order.count(); i++)
+            target_idxs.emplace(kept_order.at(i), i);
+
+        std::vector<int> positions;
+        positions.reserve(model.count());
+        for (const Item item : model.asList())
+            positions.push_back(target_idxs.at(item));
+
+        stays = longest_increasing(positions);
+    }
+    const auto move_count = std::count(stays.cbegin(), stays.cend(), false);
+
+    if (move_count > MAX_ROW_MOVES || insert_runs > MAX_INSERT_RUNS) {
+        replace_items(model, target);
+        return;
+    }
+
+    if (move_count > 0) {
+        QSet<Item> moving;
+        for (int i = 0; i < model.count(); i++) {
+            if (!stays[i])
+                moving.insert(model.at(i));
+        }
+
+        // placing every moved item right after its final predecessor, in the final order,
+        // keeps the already placed ones together
+        for (int i = 0; i < kept_order.count(); i++) {
+            const Item item = kept_order.at(i);
+            if (!moving.contains(item))
+                continue;
+
+            const int from = model.indexOf(item);
+            const int pred = i > 0 ? model.indexOf(kept_order.at(i - 1)) : -1;
+            const int to = from > pred ? pred + 1 : pred;
+            model.move(from, to);
+        }
+    }
+    Q_ASSERT(model.asList() == kept_order);
+
+
+    int model_idx = 0;
+    for (int i = 0; i < target.count(); ) {
+        if (kept_set.contains(target.at(i))) {
+            model_idx++;
+            i++;
+            continue;
+        }
+
+        QVector<Item> run;
+        while (i < target.count() && !kept_set.contains(target.at(i)))
+            run.append(target.at(i++));
+
+        model.insert(model_idx, run);
+        model_idx += run.count();
+    }
+}
+
+// Merges the sorted new items into the sorted list
+template<typename Item, typename Less>
+QVector<Item> merge_sorted(const QVector<Item>& list, const QVector<Item>& new_items, Less less)
+{
+    QVector<Item> result;
+    result.reserve(list.count() + new_items.count());
+
+    auto list_it = list.cbegin();
+    for (const Item item : new_items) {
+        const auto pos = std::upper_bound(list_it, list.cend(), item, less);
+        std::copy(list_it, pos, std::back_inserter(result));
+        result.append(item);
+        list_it = pos;
+    }
+    std::copy(list_it, list.cend(), std::back_inserter(result));
+
+    return result;
+}
+
+HashMap<QString, model::Collection*> collections_by_name(const QQmlObjectListModel<model::Collection>& model)
+{
+    HashMap<QString, model::Collection*> result;
+    result.reserve(static_cast<size_t>(model.count()));
+
+    for (model::Collection* const coll : model.asList())
+        result.emplace(coll->name(), coll);
+
+    return result;
+}
+
+void merge_collection(modeldata::Collection& target, modeldata::Collection& source)
+{
+    if (!source.shortName().isEmpty())
+        target.setShortName(source.shortName());
+    if (!source.launch_cmd.isEmpty())
+        target.launch_cmd = std::move(source.launch_cmd);
+    if (!source.launch_workdir.isEmpty())
+        target.launch_workdir = std::move(source.launch_workdir);
+    if (!source.summary.isEmpty())
+        target.summary = std::move(source.summary);
+    if (!source.description.isEmpty())
+        target.description = std::move(source.description);
+
+    target.default_assets.mergeFrom(std::move(source.default_assets));
+}
+
+// The names of the child lists, in the reported collection order first,
+// then the rest sorted by name, so the result doesn't depend on the hashing
+std::vector<QString> ordered_child_lists(const providers::sync::ListResults& results)
+{
+    std::vector<QString> names;
+    names.reserve(results.collection_childs.size());
+
+    QSet<QString> seen;
+    for (const QString& name : results.collection_order) {
+        if (results.collection_childs.count(name) && !seen.contains(name)) {
+            seen.insert(name);
+            names.push_back(name);
+        }
+    }
+
+    const auto ordered_end = names.size();
+    for (const auto& keyval : results.collection_childs) {
+        if (!seen.contains(keyval.first))
+            names.push_back(keyval.first);
+    }
+    std::sort(names.begin() + ordered_end, names.end());
+
+    return names;
+}
+} // namespace
+
+
+namespace providers {
+namespace sync {
+
+std::vector<modeldata::GameId> sorted_game_order(const modeldata::GameStore& games)
+{
+    const size_t game_count = games.size();
+
+    // the titles are collated only once per game, instead of on every comparison
+    std::vector<QString> titles;
+    titles.reserve(game_count);
+    for (modeldata::GameId game_id = 0; game_id < game_count; game_id++)
+        titles.push_back(games.at(game_id).title);
+
+    const std::vector<QCollatorSortKey> title_keys = collation_keys(titles);
+
+    std::vector<modeldata::GameId> order(game_count);
+    for (modeldata::GameId game_id = 0; game_id < game_count; game_id++)
+        order[game_id] = game_id;
+
+    // sorting by the key too makes the order independent from the order of discovery
+    std::sort(order.begin(), order.end(),
+        [&games, &title_keys](const modeldata::GameId a, const modeldata::GameId b) {
+            const int cmp = title_keys[a].compare(title_keys[b]);
+            return cmp < 0 || (cmp == 0 && games.key(a) < games.key(b));
+        });
+
+    return order;
+}
+
+void order_collection_childs(const std::vector<modeldata::GameId>& game_order,
+                             HashMap<QString, std::vector<modeldata::GameId>>& collection_childs)
+{
+    const size_t game_count = game_order.size();
+
+    // the collections of each game, stored in one block; the ones of the game `id`
+    // are between `offsets[id]` and `offsets[id + 1]`
+    std::vector<std::vector<modeldata::GameId>*> child_lists;
+    child_lists.reserve(collection_childs.size());
+    std::vector<size_t> offsets(game_count + 1, 0);
+    for (auto& keyval : collection_childs) {
+        child_lists.push_back(&keyval.second);
+        for (const modeldata::GameId game_id : keyval.second) {
+            if (game_id < game_count)
+                offsets[game_id + 1]++;
+        }
+    }
+    std::partial_sum(offsets.cbegin(), offsets.cend(), offsets.begin());
+
+    std::vector<size_t> memberships(offsets.back());
+    std::vector<size_t> fill_pos(offsets.cbegin(), offsets.cend() - 1);
+    for (size_t list_idx = 0; list_idx < child_lists.size(); list_idx++) {
+        for (const modeldata::GameId game_id : *child_lists[list_idx]) {
+            if (game_id < game_count)
+                memberships[fill_pos[game_id]++] = list_idx;
+        }
+        child_lists[list_idx]->clear();
+    }
+
+    // the child lists are filtered from the global order, so they don't have to be sorted
+    for (const modeldata::GameId game_id : game_order) {
+        for (size_t i = offsets[game_id]; i < offsets[game_id + 1]; i++) {
+            std::vector<modeldata::GameId>& childs = *child_lists[memberships[i]];
+            if (childs.empty() || childs.back() != game_id)
+                childs.push_back(game_id);
+        }
+    }
+}
+
+void sort_library(Library& library)
+{
+    TRACE_SCOPE("sort_library");
+
+    library.game_order = sorted_game_order(library.games);
+    order_collection_childs(library.game_order, library.collection_childs);
+}
+
+void merge_list_results(ListResults& source,
+                        modeldata::GameStore& games,
+                        HashMap<QString, modeldata::Collection>& collections,
+                        HashMap<QString, std::vector<modeldata::GameId>>& collection_childs)
+{
+    for (auto& keyval : source.collections) {
+        auto it = collections.find(keyval.first);
+        if (it == collections.end())
+            collections.emplace(keyval.first, std::move(keyval.second));
+        else
+            merge_collection(it->second, keyval.second);
+    }
+
+    // a game found by multiple providers is owned by the first one; new games
+    // without a launch command would have inherited it from their collection
+    const size_t source_game_count = source.games.size();
+    std::vector<modeldata::GameId> target_ids(source_game_count);
+    std::vector<bool> launchless(source_game_count, false);
+    games.reserve(games.size() + source_game_count);
+
+    for (modeldata::GameId source_id = 0; source_id < source_game_count; source_id++) {
+        const QString& game_key = source.games.key(source_id);
+
+        modeldata::GameId target_id = games.find(game_key);
+        if (target_id == modeldata::INVALID_GAMEID) {
+            modeldata::Game& game = source.games.at(source_id);
+            launchless[source_id] = game.launch_cmd.isEmpty();
+            target_id = games.add(game_key, std::move(game));
+        }
+        target_ids[source_id] = target_id;
+    }
+
+    // the first collection of a game decides, even if it has no launch command either
+    for (const QString& coll_name : ordered_child_lists(source)) {
+        const modeldata::Collection& coll = collections.at(coll_name);
+        const std::vector<modeldata::GameId>& source_childs = source.collection_childs.at(coll_name);
+
+        std::vector<modeldata::GameId>& childs = collection_childs[coll_name];
+        childs.reserve(childs.size() + source_childs.size());
+
+        for (const modeldata::GameId source_id : source_childs) {
+            const modeldata::GameId target_id = target_ids[source_id];
+            if (launchless[source_id]) {
+                if (!coll.launch_cmd.isEmpty())
+                    games.at(target_id).launch_cmd = coll.launch_cmd;
+                launchless[source_id] = false;
+            }
+            childs.push_back(target_id);
+        }
+    }
+}
+
+bool game_title_less(const model::GameLibrary& game_library, const model::GameSlot a, const model::GameSlot b)
+{
+    return collation_compare(game_library.at(a).title, game_library.at(b).title) < 0;
+}
+
+void insert_sorted(model::GameListModel& model, const model::GameSlot game)
+{
+    const model::GameLibrary& game_library = model.library();
+    const QVector<model::GameSlot>& list = model.asList();
+    const auto it = std::upper_bound(list.cbegin(), list.cend(), game,
+        [&game_library](const model::GameSlot a, const model::GameSlot b){ return game_title_less(game_library, a, b); });
+    model.insert(static_cast<int>(std::distance(list.cbegin(), it)), game);
+}
+
+void remove_games(model::GameListModel& model, const QSet<model::GameSlot>& games)
+{
+    if (games.isEmpty())
+        return;
+
+    // from the end, so the rows before the removed ones don't move
+    int run_end = model.count();
+    for (int i = model.count() - 1; i >= -1; i--) {
+        if (i >= 0 && games.contains(model.at(i)))
+            continue;
+
+        const int run_start = i + 1;
+        if (run_start < run_end)
+            model.remove(run_start, run_end - run_start);
+        run_end = i;
+    }
+}
+
+QVector<model::GameSlot> add_missing(Library& library,
+                                     model::GameListModel& game_model,
+                                     QQmlObjectListModel<model::Collection>& collection_model,
+                                     HashMap<QString, model::GameSlot>& gameid_to_slot)
+{
+    TRACE_SCOPE("add missing games to the models");
+
+    model::GameLibrary& game_library = game_model.library();
+    const auto title_less = [&game_library](const model::GameSlot a, const model::GameSlot b){
+        return game_title_less(game_library, a, b);
+    };
+
+    std::vector<model::GameSlot> slots_by_id(library.games.size(), model::INVALID_GAMESLOT);
+
+    QVector<model::GameSlot> new_games;
+    for (const modeldata::GameId game_id : library.game_order) {
+        const QString& game_key = library.games.key(game_id);
+        const auto it = gameid_to_slot.find(game_key);
+        if (it != gameid_to_slot.cend()) {
+            slots_by_id[game_id] = it->second;
+            continue;
+        }
+
+        const model::GameSlot slot = game_library.add(std::move(library.games.at(game_id)));
+        gameid_to_slot.emplace(game_key, slot);
+        slots_by_id[game_id] = slot;
+        new_games.append(slot);
+    }
+    if (!new_games.isEmpty())
+        set_items(game_model, merge_sorted(game_model.asList(), new_games, title_less));
+    TRACE_COUNT("games added", new_games.count());
+
+
+    HashMap<QString, model::Collection*> q_collections = collections_by_name(collection_model);
+
+    QVector<model::Collection*> new_collections;
+    for (auto& keyval : library.collections) {
+        if (q_collections.count(keyval.first))
+            continue;
+
+        auto q_coll = new model::Collection(std::move(keyval.second), game_library);
+        q_collections.emplace(keyval.first, q_coll);
+        new_collections.append(q_coll);
+    }
+    if (!new_collections.isEmpty()) {
+        collation_sort(new_collections, collection_name);
+        set_items(collection_model, merge_sorted(collection_model.asList(), new_collections, collection_name_less));
+    }
+
+
+    for (const auto& keyval : library.collection_childs) {
+        const auto coll_it = q_collections.find(keyval.first);
+        if (coll_it == q_collections.cend())
+            continue;
+
+        model::GameListModel& coll_games = coll_it->second->games();
+        const QSet<model::GameSlot> current = QSet<model::GameSlot>::fromList(coll_games.asList().toList());
+
+        QVector<model::GameSlot> new_childs;
+        for (const modeldata::GameId game_id : keyval.second) {
+            const model::GameSlot slot = slots_by_id[game_id];
+            if (!current.contains(slot))
+                new_childs.append(slot);
+        }
+        if (!new_childs.isEmpty())
+            set_items(coll_games, merge_sorted(coll_games.asList(), new_childs, title_less));
+    }
+
+    return new_games;
+}
+
+QVector<model::GameSlot> apply(Library& library,
+                               model::GameListModel& game_model,
+                               QQmlObjectListModel<model::Collection>& collection_model,
+                               HashMap<QString, model::GameSlot>& gameid_to_slot)
+{
+    TRACE_SCOPE("update the models");
+
+    model::GameLibrary& game_library = game_model.library();
+
+    QVector<model::GameSlot> new_games;
+    QVector<model::GameSlot> game_slots;
+    game_slots.reserve(static_cast<int>(library.game_order.size()));
+    std::vector<model::GameSlot> slots_by_id(library.games.size(), model::INVALID_GAMESLOT);
+    HashMap<QString, model::GameSlot> new_gameid_map;
+    new_gameid_map.reserve(library.game_order.size());
+
+    {
+        // instead of a change signal for every game, the models are refreshed at once below
+        const QSignalBlocker blocker(game_library);
+
+        for (const modeldata::GameId game_id : library.game_order) {
+            const QString& game_key = library.games.key(game_id);
+            modeldata::Game& game = library.games.at(game_id);
+
+            model::GameSlot slot = model::INVALID_GAMESLOT;
+            const auto it = gameid_to_slot.find(game_key);
+            if (it != gameid_to_slot.cend()) {
+                slot = it->second;
+                game_library.setData(slot, std::move(game));
+            }
+            else {
+                slot = game_library.add(std::move(game));
+                new_games.append(slot);
+            }
+
+            game_slots.append(slot);
+            slots_by_id[game_id] = slot;
+            new_gameid_map.emplace(game_key, slot);
+        }
+    }
+
+
+    const HashMap<QString, model::Collection*> old_collections = collections_by_name(collection_model);
+
+    QVector<model::Collection*> q_collections;
+    q_collections.reserve(static_cast<int>(library.collections.size()));
+
+    for (auto& keyval : library.collections) {
+        model::Collection* q_coll = nullptr;
+        const auto it = old_collections.find(keyval.first);
+        if (it != old_collections.cend()) {
+            q_coll = it->second;
+            q_coll->setData(std::move(keyval.second));
+        }
+        else {
+            q_coll = new model::Collection(std::move(keyval.second), game_library);
+        }
+
+        q_collections.append(q_coll);
+    }
+    collation_sort(q_collections, collection_name);
+
+
+    // the removed collections are deleted later by their model
+    set_items(game_model, game_slots);
+    set_items(collection_model, q_collections);
+    game_model.refresh();
+
+    for (model::Collection* const q_coll : q_collections) {
+        QVector<model::GameSlot> child_slots;
+
+        const auto it = library.collection_childs.find(q_coll->name());
+        if (it != library.collection_childs.cend()) {
+            child_slots.reserve(static_cast<int>(it->second.size()));
+            for (const modeldata::GameId game_id : it->second)
+                child_slots.append(slots_by_id[game_id]);
+        }
+
+        set_items(q_coll->games(), child_slots);
+        q_coll->games().refresh();
+    }
+
+    // the removed games are not shown by any model at this point
+    for (const auto& keyval : gameid_to_slot) {
+        if (!new_gameid_map.count(keyval.first))
+            game_library.remove(keyval.second);
+    }
+
+    gameid_to_slot = std::move(new_gameid_map);
+    TRACE_COUNT("games added", new_games.count());
+    return new_games;
+}
+
+void apply_dynamic_data(const DynamicData& data, model::GameLibrary& game_library)
+{
+    for (const model::GameSlot slot : data.favorites)
+        game_library.setFavorite(slot, true);
+
+    for (const DynamicData::PlayStats& stats : data.play_stats)
+        game_library.addPlayStats(stats.slot, stats.playcount, stats.playtime, stats.last_played);
+}
+
+} // namespace sync
+} // namespace providers
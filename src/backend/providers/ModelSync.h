@@ -0,0 +1,133 @@
+// Pegasus Frontend
+// Copyright (C) 2018  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include "modeldata/gaming/CollectionData.h"
+#include "modeldata/gaming/GameData.h"
+#include "modeldata/gaming/GameStore.h"
+#include "utils/FwdDeclModel.h"
+#include "utils/HashMap.h"
+#include "utils/MoveOnly.h"
+
+#include <QDateTime>
+#include <QSet>
+#include <QString>
+#include <QVector>
+#include <vector>
+
+template<typename T> class QQmlObjectListModel;
+
+
+namespace providers {
+namespace sync {
+
+/// Game and collection data to be added to the models
+struct Library {
+    Library() = default;
+    MOVE_ONLY(Library)
+
+    modeldata::GameStore games;
+    HashMap<QString, modeldata::Collection> collections;
+    HashMap<QString, std::vector<modeldata::GameId>> collection_childs;
+    /// The IDs of all games, in the order they should appear in the models
+    std::vector<modeldata::GameId> game_order;
+};
+
+/// The lists found by a provider that ran on its own containers,
+/// to be merged into the shared ones later
+struct ListResults {
+    modeldata::GameStore games;
+    HashMap<QString, modeldata::Collection> collections;
+    HashMap<QString, std::vector<modeldata::GameId>> collection_childs;
+    /// The names of the collections, in the order the provider added them
+    std::vector<QString> collection_order;
+};
+
+/// The data found by the providers during the dynamic data stage. It's collected
+/// in the background, then applied to the game library on the main thread.
+struct DynamicData {
+    struct PlayStats {
+        model::GameSlot slot;
+        int playcount;
+        qint64 playtime;
+        QDateTime last_played;
+    };
+
+    std::vector<model::GameSlot> favorites;
+    std::vector<PlayStats> play_stats;
+};
+
+
+/// Returns the IDs of all games, ordered by their title
+std::vector<modeldata::GameId> sorted_game_order(const modeldata::GameStore&);
+
+/// Makes the collection child lists follow the game order, also removing
+/// the duplicates and the IDs of unknown games
+void order_collection_childs(const std::vector<modeldata::GameId>& game_order,
+                             HashMap<QString, std::vector<modeldata::GameId>>& collection_childs);
+
+/// Fills the game order and sorts the collection child lists by the title of the games,
+/// also removing the duplicates and the IDs of unknown games. Can be used on any thread,
+/// and it's recommended to do so in the background for large libraries.
+void sort_library(Library&);
+
+/// Moves the results of one provider into the shared lists, the same way as if the
+/// provider had run directly on them after the previously merged ones. New games
+/// without a launch command inherit it from the first of their collections, in the
+/// collection order of the results; the collections missing from that order come
+/// after the rest, sorted by name.
+void merge_list_results(ListResults&,
+                        modeldata::GameStore&,
+                        HashMap<QString, modeldata::Collection>&,
+                        HashMap<QString, std::vector<modeldata::GameId>>&);
+
+
+/// The ordering of the games in the models, matching `sorted_game_order`
+bool game_title_less(const model::GameLibrary&, const model::GameSlot, const model::GameSlot);
+
+/// Inserts the game into the already sorted model
+void insert_sorted(model::GameListModel&, const model::GameSlot);
+/// Removes the games from the model, with one row change for every contiguous range
+void remove_games(model::GameListModel&, const QSet<model::GameSlot>&);
+
+
+// NOTE: the functions below have to be called on the thread of the models,
+//       and expect a library already processed by `sort_library`.
+
+/// Adds the games, collections and collection memberships not yet present in the models.
+/// The existing entries are left unchanged. Returns the slots of the newly added games.
+/// The games are matched to the existing entries of the game library by their key.
+QVector<model::GameSlot> add_missing(Library&,
+                                     model::GameListModel&,
+                                     QQmlObjectListModel<model::Collection>&,
+                                     HashMap<QString, model::GameSlot>& gameid_to_slot);
+
+/// Makes the models contain exactly the games and collections of the library:
+/// the existing entries are updated in place, the new ones are added and the rest is
+/// removed, with the individual row changes where practical. The removed games are
+/// also freed in the game library. Returns the slots of the newly added games.
+QVector<model::GameSlot> apply(Library&,
+                               model::GameListModel&,
+                               QQmlObjectListModel<model::Collection>&,
+                               HashMap<QString, model::GameSlot>& gameid_to_slot);
+
+/// Marks the favorites and adds the play stats to the games of the library
+void apply_dynamic_data(const DynamicData&, model::GameLibrary&);
+
+} // namespace sync
+} // namespace providers
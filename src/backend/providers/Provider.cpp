@@ -22,6 +22,7 @@ namespace providers {
 
 Provider::Provider(QObject* parent)
     : QObject(parent)
+    , m_lazy_assets(false)
 {}
 
 Provider::~Provider() = default;
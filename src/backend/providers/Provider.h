@@ -22,6 +22,7 @@
 #include "utils/HashMap.h"
 
 #include <QString>
+#include <QStringList>
 #include <QObject>
 #include <QVector>
 #include <vector>
@@ -29,6 +30,33 @@
 
 namespace providers {
 
+class MediaRoots;
+namespace sync { struct DynamicData; }
+
+/// The parts of the shared initialization data a provider stage may touch.
+/// Used by the ProviderManager to decide which stages can run in parallel.
+enum DataSet : unsigned char {
+    NO_DATA = 0,
+    /// The game, collection and collection child lists
+    GAME_LIST = 1 << 0,
+    /// The textual metadata fields of any game
+    GAME_METADATA = 1 << 1,
+    /// The assets of any game
+    GAME_ASSETS = 1 << 2,
+    /// Fields of games that only this provider has found (eg. store apps);
+    /// the stages working on any game may still touch these games too
+    OWN_GAMES = 1 << 3,
+
+    ALL_DATA = GAME_LIST | GAME_METADATA | GAME_ASSETS | OWN_GAMES,
+};
+Q_DECLARE_FLAGS(DataSets, DataSet)
+
+struct StageAccess {
+    DataSets reads;
+    DataSets writes;
+};
+
+
 class Provider : public QObject {
     Q_OBJECT
 
@@ -38,33 +66,76 @@ public:
 
     /// Initialization first stage:
     /// Find all games and collections.
-    virtual void findLists(HashMap<QString, modeldata::Game>&,
+    virtual void findLists(modeldata::GameStore&,
                            HashMap<QString, modeldata::Collection>&,
-                           HashMap<QString, std::vector<QString>>&)
+                           HashMap<QString, std::vector<modeldata::GameId>>&)
     {}
 
     /// Initialization second stage:
     /// Enhance the previously found games and collections with metadata and assets.
-    virtual void findStaticData(HashMap<QString, modeldata::Game>&,
+    virtual void findStaticData(modeldata::GameStore&,
                                 const HashMap<QString, modeldata::Collection>&,
-                                const HashMap<QString, std::vector<QString>>&)
+                                const HashMap<QString, std::vector<modeldata::GameId>>&)
     {}
 
+    /// Lazy asset lookup: instead of searching every media file during the
+    /// second stage, tell where the media directories are, so the assets of
+    /// a game can be looked up when it's first shown
+    virtual void findMediaRoots(MediaRoots&) const {}
+
     /// Initialization third stage:
-    /// Find data that may change during the runtime for all games
-    virtual void findDynamicData(const QVector<model::Game*>&,
-                                 const QVector<model::Collection*>&,
-                                 const HashMap<QString, model::Game*>&)
+    /// Find data that may change during the runtime for the games of the map.
+    /// Runs in the background, so the results are only collected here, and
+    /// applied to the library later on the main thread.
+    virtual void findDynamicData(sync::DynamicData&,
+                                 const HashMap<QString, model::GameSlot>&)
+    {}
+
+
+    /// The data accessed by `findLists`. Providers that only write the
+    /// lists can run in parallel with each other; a provider that also
+    /// reads them sees the results of the lower priority providers.
+    virtual StageAccess listsAccess() const { return { ALL_DATA, ALL_DATA }; }
+    /// The names of the collections, in the order the last `findLists` added them.
+    /// When the lists are merged, the new games without a launch command inherit
+    /// it from the first of their collections in this order.
+    virtual std::vector<QString> collectionOrder() const { return {}; }
+    /// The data accessed by `findStaticData`. Stages with overlapping
+    /// writes run in the provider order.
+    virtual StageAccess staticDataAccess() const { return { ALL_DATA, ALL_DATA }; }
+
+
+    /// Live updates: the directories where changes may affect the found games
+    virtual QStringList watchedDirs() const { return {}; }
+    /// Live updates: find the games directly inside a changed directory.
+    /// There should be an entry in the child lists for every collection that may
+    /// contain games from this directory, even if no games were found for it.
+    /// Called on a background thread, while no search is running.
+    virtual void findGamesInDir(const QString&,
+                                modeldata::GameStore&,
+                                HashMap<QString, std::vector<modeldata::GameId>>&)
     {}
 
 
     // events
-    virtual void onGameFavoriteChanged(const QVector<model::Game*>&) {}
-    virtual void onGameLaunched(model::Game* const) {}
-    virtual void onGameFinished(model::Game* const) {}
+    virtual void onGameFavoriteChanged(const model::GameLibrary&, const QVector<model::GameSlot>&) {}
+    virtual void onGameLaunched(model::GameLibrary&, const model::GameSlot) {}
+    virtual void onGameFinished(model::GameLibrary&, const model::GameSlot) {}
+
+    /// When enabled, the media directories are not searched in `findStaticData`,
+    /// see `findMediaRoots`
+    void setLazyAssets(bool enabled) { m_lazy_assets = enabled; }
 
 signals:
     void gameCountChanged(int);
+
+protected:
+    bool lazyAssets() const { return m_lazy_assets; }
+
+private:
+    bool m_lazy_assets;
 };
 
 } // namespace providers
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(providers::DataSets)
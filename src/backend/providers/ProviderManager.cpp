@@ -19,12 +19,20 @@
 
 #include "AppSettings.h"
 #include "LocaleUtils.h"
+#include "Trace.h"
+#include "filesystem/DirCache.h"
 #include "model/gaming/Collection.h"
-#include "model/gaming/Game.h"
+#include "model/gaming/GameLibrary.h"
+#include "model/gaming/GameListModel.h"
+#include "providers/LibrarySnapshot.h"
+#include "providers/MediaRoots.h"
 #include "providers/pegasus/PegasusProvider.h"
 #include "providers/pegasus_favorites/Favorites.h"
 #include "providers/pegasus_playtime/PlaytimeStats.h"
+#include "utils/Collation.h"
 #include "utils/HashMap.h"
+#include "utils/MemoryUsage.h"
+#include "utils/StringIntern.h"
 
 #ifdef WITH_COMPAT_ES2
   #include "providers/es2/Es2Provider.h"
@@ -44,30 +52,39 @@
 
 #include "QtQmlTricks/QQmlObjectListModel.h"
 #include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QSet>
 #include <QtConcurrent/QtConcurrent>
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <numeric>
 
 
 namespace {
-void sort_games(QVector<model::Game*>& games)
+QString provider_name(const providers::Provider* const provider)
 {
-    std::sort(games.begin(), games.end(),
-        [](const model::Game* const a, const model::Game* const b) {
-            return QString::localeAwareCompare(a->title(), b->title()) < 0;
-        }
-    );
+    return QString::fromLatin1(provider->metaObject()->className());
+}
+
+template<typename T>
+ProviderPtr reuse_or_create(std::vector<ProviderPtr>& providers)
+{
+    for (ProviderPtr& provider : providers) {
+        if (provider && qobject_cast<T*>(provider.get()))
+            return std::move(provider);
+    }
+    return ProviderPtr(new T());
 }
 
 void sort_collections(QVector<model::Collection*>& collections)
 {
-    std::sort(collections.begin(), collections.end(),
-        [](const model::Collection* const a, const model::Collection* const b) {
-            return QString::localeAwareCompare(a->name(), b->name()) < 0;
-        }
-    );
+    collation_sort(collections, [](const model::Collection* const coll){ return coll->name(); });
 }
 
 void remove_empty_collections(HashMap<QString, modeldata::Collection>& collections,
-                              HashMap<QString, std::vector<QString>>& collection_childs)
+                              HashMap<QString, std::vector<modeldata::GameId>>& collection_childs)
 {
     std::vector<QString> empty_colls;
 
@@ -86,47 +103,199 @@ void remove_empty_collections(HashMap<QString, modeldata::Collection>& collectio
     }
 }
 
-void run_list_providers(const std::vector<ProviderPtr>& providers,
-                        HashMap<QString, modeldata::Game>& games,
+using ListResultsPtr = std::unique_ptr<providers::sync::ListResults>;
+using ListResultsCallback = std::function<void(const modeldata::GameStore&,
+                                               const HashMap<QString, modeldata::Collection>&,
+                                               const HashMap<QString, std::vector<modeldata::GameId>>&)>;
+
+// Runs on any thread, the results are applied by `applyDynamicData`
+providers::sync::DynamicData find_dynamic_data(const std::vector<ProviderPtr>& providers,
+                                               const HashMap<QString, model::GameSlot>& gameid_to_slot)
+{
+    providers::sync::DynamicData dynamic_data;
+    for (const ProviderPtr& provider : providers) {
+        TRACE_SCOPE("findDynamicData", provider_name(provider.get()));
+        provider->findDynamicData(dynamic_data, gameid_to_slot);
+    }
+    return dynamic_data;
+}
+
+bool stages_conflict(const providers::StageAccess& a, const providers::StageAccess& b)
+{
+    const int a_reads = static_cast<int>(a.reads);
+    const int a_writes = static_cast<int>(a.writes);
+    const int b_reads = static_cast<int>(b.reads);
+    const int b_writes = static_cast<int>(b.writes);
+
+    // The games found only by one provider are never touched by the other
+    // providers of the same kind, but the stages working on any game (eg.
+    // through the metadata files) may reach them too
+    constexpr int any_game_data = providers::GAME_METADATA | providers::GAME_ASSETS;
+    if ((a_writes & providers::OWN_GAMES) && ((b_reads | b_writes) & any_game_data))
+        return true;
+    if ((b_writes & providers::OWN_GAMES) && ((a_reads | a_writes) & any_game_data))
+        return true;
+
+    constexpr int shared_data = providers::ALL_DATA & ~providers::OWN_GAMES;
+    return (a_writes & (b_reads | b_writes) & shared_data)
+        || (b_writes & a_reads & shared_data);
+}
+
+void run_list_providers(QThreadPool& pool,
+                        const std::vector<ProviderPtr>& providers,
+                        modeldata::GameStore& games,
                         HashMap<QString, modeldata::Collection>& collections,
-                        HashMap<QString, std::vector<QString>>& collection_childs)
+                        HashMap<QString, std::vector<modeldata::GameId>>& collection_childs,
+                        const ListResultsCallback& on_results)
 {
-    // run the providers in reverse, so higher priority providers can overwrite
-    // the previous data. The Pegasus provider will run last, when the other
-    // providers have already collected the extra dirs to check.
-    for (auto it = providers.crbegin(); it != providers.crend(); ++it)
-        (*it)->findLists(games, collections, collection_childs);
+    // The providers logically run in reverse, so higher priority providers can
+    // overwrite the previous data. Providers that only produce lists run in
+    // parallel into their own containers, and their results get merged in the
+    // same reverse order, regardless of which one finished first. A provider
+    // that reads the lists too has to wait for the previous ones to complete.
+    std::vector<ListResultsPtr> batch_results;
+    std::vector<QFuture<void>> batch_tasks;
+
+    const auto merge_batch = [&]{
+        for (QFuture<void>& task : batch_tasks)
+            task.waitForFinished();
+
+        TRACE_SCOPE("merge lists");
+        for (ListResultsPtr& results : batch_results)
+            providers::sync::merge_list_results(*results, games, collections, collection_childs);
+
+        batch_tasks.clear();
+        batch_results.clear();
+    };
+
+    for (auto it = providers.crbegin(); it != providers.crend(); ++it) {
+        providers::Provider* const provider = it->get();
+
+        const providers::StageAccess access = provider->listsAccess();
+        if (!access.writes)
+            continue;
+
+        if (access.reads) {
+            merge_batch();
+
+            TRACE_SCOPE("findLists", provider_name(provider));
+            provider->findLists(games, collections, collection_childs);
+            if (on_results)
+                on_results(games, collections, collection_childs);
+            continue;
+        }
+
+        batch_results.emplace_back(new providers::sync::ListResults());
+        providers::sync::ListResults* const results = batch_results.back().get();
+        batch_tasks.push_back(QtConcurrent::run(&pool, [provider, results, &on_results]{
+            TRACE_SCOPE("findLists", provider_name(provider));
+            provider->findLists(results->games, results->collections, results->collection_childs);
+            results->collection_order = provider->collectionOrder();
+            if (on_results)
+                on_results(results->games, results->collections, results->collection_childs);
+        }));
+    }
+    merge_batch();
 
     remove_empty_collections(collections, collection_childs);
 }
 
+void run_static_providers(QThreadPool& pool,
+                          const std::vector<ProviderPtr>& providers,
+                          modeldata::GameStore& games,
+                          const HashMap<QString, modeldata::Collection>& collections,
+                          const HashMap<QString, std::vector<modeldata::GameId>>& collection_childs)
+{
+    // the stages only read the game list, but they may use the path index,
+    // which would be built on its first use otherwise
+    {
+        TRACE_SCOPE("build game path index");
+        games.pathIndex();
+    }
+
+    // Every provider runs after all the previous ones it conflicts with,
+    // and together with the non-conflicting ones, level by level
+    std::vector<providers::StageAccess> accesses;
+    std::vector<std::vector<providers::Provider*>> levels;
+    std::vector<size_t> provider_levels;
+    accesses.reserve(providers.size());
+    provider_levels.reserve(providers.size());
+
+    for (const ProviderPtr& provider : providers) {
+        const providers::StageAccess access = provider->staticDataAccess();
+        accesses.push_back(access);
+
+        size_t level = 0;
+        for (size_t prev = 0; prev < provider_levels.size(); prev++) {
+            if (stages_conflict(accesses[prev], access))
+                level = std::max(level, provider_levels[prev] + 1);
+        }
+        provider_levels.push_back(level);
+
+        if (!access.writes)
+            continue;
+
+        if (levels.size() <= level)
+            levels.resize(level + 1);
+        levels[level].push_back(provider.get());
+    }
+
+    for (const std::vector<providers::Provider*>& level : levels) {
+        std::vector<QFuture<void>> tasks;
+        tasks.reserve(level.size());
+
+        for (providers::Provider* const provider : level) {
+            tasks.push_back(QtConcurrent::run(&pool, [provider, &games, &collections, &collection_childs]{
+                TRACE_SCOPE("findStaticData", provider_name(provider));
+                provider->findStaticData(games, collections, collection_childs);
+            }));
+        }
+        for (QFuture<void>& task : tasks)
+            task.waitForFinished();
+    }
+}
+
 void build_ui_layer(QThread* const ui_thread,
-                    HashMap<QString, modeldata::Game>& games,
+                    modeldata::GameStore& games,
                     HashMap<QString, modeldata::Collection>& collections,
-                    HashMap<QString, std::vector<QString>>& collection_childs,
-                    QQmlObjectListModel<model::Game>& game_model,
+                    HashMap<QString, std::vector<modeldata::GameId>>& collection_childs,
+                    model::GameListModel& game_model,
                     QQmlObjectListModel<model::Collection>& collection_model,
-                    HashMap<QString, model::Game*>& gameid_to_q_game)
+                    HashMap<QString, model::GameSlot>& gameid_to_slot)
 {
-    QVector<model::Game*> q_games;
-    q_games.reserve(static_cast<int>(games.size()));
-    gameid_to_q_game.reserve(games.size());
+    TRACE_SCOPE("build_ui_layer");
 
-    for (auto& keyval : games) {
-        auto qobj = new model::Game(std::move(keyval.second));
-        qobj->moveToThread(ui_thread);
-        q_games.append(qobj);
-        gameid_to_q_game.emplace(keyval.first, q_games.last());
+    const std::vector<modeldata::GameId> game_order = providers::sync::sorted_game_order(games);
+    providers::sync::order_collection_childs(game_order, collection_childs);
+
+    // the games are only copied to the library, the QObjects are created on request
+    model::GameLibrary& game_library = game_model.library();
+    game_library.reserve(game_library.slotCount() + games.size());
+
+    std::vector<model::GameSlot> slots_by_id;
+    slots_by_id.reserve(games.size());
+    gameid_to_slot.reserve(games.size());
+
+    for (modeldata::GameId game_id = 0; game_id < games.size(); game_id++) {
+        const model::GameSlot slot = game_library.add(std::move(games.at(game_id)));
+        slots_by_id.push_back(slot);
+        gameid_to_slot.emplace(games.key(game_id), slot);
     }
-    sort_games(q_games);
-    game_model.append(q_games);
+    TRACE_COUNT("games added", static_cast<qint64>(slots_by_id.size()));
+
+    QVector<model::GameSlot> game_slots;
+    game_slots.reserve(static_cast<int>(game_order.size()));
+    for (const modeldata::GameId game_id : game_order)
+        game_slots.append(slots_by_id[game_id]);
+
+    game_model.append(game_slots);
 
 
     QVector<model::Collection*> q_collections;
     q_collections.reserve(static_cast<int>(collections.size()));
 
     for (auto& keyval : collections) {
-        auto qobj = new model::Collection(std::move(keyval.second));
+        auto qobj = new model::Collection(std::move(keyval.second), game_library);
         qobj->moveToThread(ui_thread);
         q_collections.append(qobj);
     }
@@ -135,14 +304,14 @@ void build_ui_layer(QThread* const ui_thread,
 
 
     for (model::Collection* const q_coll : q_collections) {
-        QVector<model::Game*> q_childs;
+        QVector<model::GameSlot> child_slots;
 
-        const std::vector<QString>& game_keys = collection_childs[q_coll->name()];
-        for (const QString& game_key : game_keys)
-            q_childs.append(gameid_to_q_game.at(game_key));
+        const std::vector<modeldata::GameId>& game_ids = collection_childs[q_coll->name()];
+        child_slots.reserve(static_cast<int>(game_ids.size()));
+        for (const modeldata::GameId game_id : game_ids)
+            child_slots.append(slots_by_id[game_id]);
 
-        sort_games(q_childs);
-        q_coll->setGameList(q_childs);
+        q_coll->setGameList(child_slots);
     }
 }
 } // namespace
@@ -150,10 +319,49 @@ void build_ui_layer(QThread* const ui_thread,
 
 ProviderManager::ProviderManager(QObject* parent)
     : QObject(parent)
+    , m_searching(false)
+    , m_rescanning(false)
+    , m_caches_enabled(true)
+    , m_lazy_assets(false)
+    , m_accepts_events(false)
+    , m_applying_dynamic_data(false)
+    , m_favorites_changed(false)
+    , m_game_model(nullptr)
+    , m_collection_model(nullptr)
+    , m_streaming(true)
+    , m_pending_is_final(false)
+    , m_reading_dir_changes(false)
+{
+    createProviders();
+
+    // file operations usually come in bursts, eg. when copying a set of games
+    m_dir_change_timer.setSingleShot(true);
+    m_dir_change_timer.setInterval(1000);
+    connect(&m_dir_change_timer, &QTimer::timeout,
+            this, &ProviderManager::readDirChanges);
+    connect(&m_dir_watcher, &QFileSystemWatcher::directoryChanged,
+            this, &ProviderManager::onDirectoryChanged);
+    connect(this, &ProviderManager::thirdPhaseComplete,
+            this, &ProviderManager::onSearchFinished, Qt::QueuedConnection);
+}
+
+ProviderManager::~ProviderManager()
 {
+    // the background tasks refer to the members
+    m_init_seq.waitForFinished();
+    m_dir_change_seq.waitForFinished();
+}
+
+void ProviderManager::createProviders()
+{
+    // The dynamic data providers don't depend on the settings, and may still
+    // be writing their files in the background, so they are kept between searches
+    std::vector<ProviderPtr> old_providers;
+    old_providers.swap(m_providers);
+
     m_providers.emplace_back(new providers::pegasus::PegasusProvider());
-    m_providers.emplace_back(new providers::favorites::Favorites());
-    m_providers.emplace_back(new providers::playtime::PlaytimeStats());
+    m_providers.push_back(reuse_or_create<providers::favorites::Favorites>(old_providers));
+    m_providers.push_back(reuse_or_create<providers::playtime::PlaytimeStats>(old_providers));
 #ifdef WITH_COMPAT_STEAM
     if (AppSettings::ext_providers.at(ExtProvider::STEAM).enabled)
         m_providers.emplace_back(new providers::steam::SteamProvider());
@@ -175,71 +383,690 @@ ProviderManager::ProviderManager(QObject* parent)
         m_providers.emplace_back(new providers::skraper::SkraperAssetsProvider());
 #endif
 
-    for (const auto& provider : m_providers) {
-        connect(provider.get(), &providers::Provider::gameCountChanged,
-                this, &ProviderManager::gameCountChanged);
+    m_provider_game_counts.assign(m_providers.size(), 0);
+    for (size_t i = 0; i < m_providers.size(); i++) {
+        providers::Provider* const provider = m_providers[i].get();
+        disconnect(provider, &providers::Provider::gameCountChanged, this, nullptr);
+        connect(provider, &providers::Provider::gameCountChanged,
+                this, [this, i](int game_count){ onProviderGameCountChanged(i, game_count); });
     }
 }
 
-void ProviderManager::startSearch(QQmlObjectListModel<model::Game>& game_model,
+void ProviderManager::onProviderGameCountChanged(size_t provider_idx, int game_count)
+{
+    // the providers run in parallel and report only their own games,
+    // until the final count is known after merging
+    m_provider_game_counts.at(provider_idx) = game_count;
+
+    // the partial counts would be misleading while the previous library is shown
+    if (m_rescanning)
+        return;
+
+    const int sum = std::accumulate(m_provider_game_counts.cbegin(), m_provider_game_counts.cend(), 0);
+    emit gameCountChanged(sum);
+}
+
+void ProviderManager::startSearch(model::GameListModel& game_model,
                                   QQmlObjectListModel<model::Collection>& collection_model)
 {
-    Q_ASSERT(!m_init_seq.isRunning());
+    Q_ASSERT(!m_searching);
+    Q_ASSERT(!m_game_model && !m_collection_model);
 
-    m_init_seq = QtConcurrent::run([this, &game_model, &collection_model]{
-        HashMap<QString, modeldata::Game> games;
-        HashMap<QString, modeldata::Collection> collections;
-        HashMap<QString, std::vector<QString>> collection_childs;
+    m_game_model = &game_model;
+    m_collection_model = &collection_model;
+    runSearch(true);
+}
+
+void ProviderManager::startRescan()
+{
+    Q_ASSERT(m_game_model && m_collection_model);
+    if (m_searching)
+        return;
+
+    // the providers may still be reading the changed directories
+    m_dir_change_seq.waitForFinished();
+
+    // the game directories and the enabled providers may have changed
+    createProviders();
+    runSearch(false);
+}
+
+void ProviderManager::runSearch(const bool first_run)
+{
+    Q_ASSERT(!m_searching);
+
+    std::fill(m_provider_game_counts.begin(), m_provider_game_counts.end(), 0);
+    m_searching = true;
+    m_rescanning = !first_run;
+    // on a rescan, the library shown already has its dynamic data
+    if (first_run)
+        m_accepts_events = false;
+    m_media_roots.reset();
+
+    for (const ProviderPtr& provider : m_providers)
+        provider->setLazyAssets(m_lazy_assets);
+
+    m_init_seq = QtConcurrent::run([this, first_run]{
+        model::GameListModel& game_model = *m_game_model;
+        QQmlObjectListModel<model::Collection>& collection_model = *m_collection_model;
+
+        const auto publish = [this, &game_model, &collection_model]
+            (modeldata::GameStore& games,
+             HashMap<QString, modeldata::Collection>& collections,
+             HashMap<QString, std::vector<modeldata::GameId>>& collection_childs)
+        {
+            m_accepts_events = false;
+
+            m_gameid_to_slot.clear();
+            build_ui_layer(parent()->thread(),
+                           games, collections, collection_childs,
+                           game_model, collection_model, m_gameid_to_slot);
+            emit staticDataReady();
+
+            // the events are accepted again when the dynamic data is applied
+            queueDynamicData(find_dynamic_data(m_providers, m_gameid_to_slot));
+        };
 
         QElapsedTimer timer;
         timer.start();
 
 
-        run_list_providers(m_providers, games, collections, collection_childs);
+        // show the library of the previous run while the providers are searching;
+        // on a rescan, the models already contain it
+        const QString snapshot_path = providers::snapshot::default_path();
+        QByteArray snapshot_checksum = m_library_checksum;
+        if (first_run && m_caches_enabled) {
+            modeldata::GameStore games;
+            HashMap<QString, modeldata::Collection> collections;
+            HashMap<QString, std::vector<modeldata::GameId>> collection_childs;
+
+            {
+                TRACE_SCOPE("read library snapshot");
+                snapshot_checksum = providers::snapshot::read(snapshot_path, games, collections, collection_childs);
+            }
+            if (!snapshot_checksum.isEmpty()) {
+                qInfo().noquote() << tr_log("Library snapshot loaded in %1ms").arg(timer.elapsed());
+                emit gameCountChanged(static_cast<int>(games.size()));
+                publish(games, collections, collection_childs);
+            }
+        }
+        timer.restart();
+
+
+        // directories unchanged since the last run don't have to be read again
+        const QString dircache_path = filesystem::default_dircache_path();
+        if (!m_caches_enabled) {
+            filesystem::dir_cache().clear();
+        }
+        else {
+            // the listings were released after the previous scan
+            TRACE_SCOPE("load directory cache");
+            filesystem::dir_cache().load(dircache_path);
+        }
+        // every directory is read only once by all filters and providers
+        filesystem::dir_cache().startScan();
+
+        modeldata::GameStore games;
+        HashMap<QString, modeldata::Collection> collections;
+        HashMap<QString, std::vector<modeldata::GameId>> collection_childs;
+
+        ListResultsCallback on_list_results;
+        if (m_streaming) {
+            on_list_results = [this](const modeldata::GameStore& found_games,
+                                     const HashMap<QString, modeldata::Collection>& found_collections,
+                                     const HashMap<QString, std::vector<modeldata::GameId>>& found_childs)
+            {
+                queueGameBatch(found_games, found_collections, found_childs);
+            };
+        }
+
+        {
+            TRACE_SCOPE("first phase");
+            run_list_providers(m_worker_pool, m_providers, games, collections, collection_childs, on_list_results);
+        }
+        emit gameCountChanged(static_cast<int>(games.size()));
         emit firstPhaseComplete(timer.restart());
 
-        for (const auto& provider : m_providers)
-            provider->findStaticData(games, collections, collection_childs);
+        {
+            TRACE_SCOPE("second phase");
+            run_static_providers(m_worker_pool, m_providers, games, collections, collection_childs);
+        }
         emit secondPhaseComplete(timer.restart());
 
+        if (m_lazy_assets) {
+            TRACE_SCOPE("find media roots");
+            std::shared_ptr<providers::MediaRoots> media_roots(new providers::MediaRoots());
+            for (const ProviderPtr& provider : m_providers)
+                provider->findMediaRoots(*media_roots);
 
-        HashMap<QString, model::Game*> gameid_to_q_game;
+            m_media_roots = std::move(media_roots);
+        }
 
-        build_ui_layer(parent()->thread(),
-                       games, collections, collection_childs,
-                       game_model, collection_model, gameid_to_q_game);
-        emit staticDataReady();
+        filesystem::dir_cache().finishScan();
+        if (m_caches_enabled) {
+            TRACE_SCOPE("save directory cache");
+            filesystem::dir_cache().save(dircache_path);
+        }
+        filesystem::dir_cache().clear();
 
 
-        for (const auto& provider : m_providers)
-            provider->findDynamicData(game_model.asList(), collection_model.asList(), gameid_to_q_game);
+        QByteArray payload;
+        {
+            TRACE_SCOPE("serialize library snapshot");
+            payload = providers::snapshot::serialize(games, collections, collection_childs);
+        }
+        m_library_checksum = providers::snapshot::checksum(payload);
+        if (m_library_checksum != snapshot_checksum) {
+            if (m_caches_enabled) {
+                TRACE_SCOPE("write library snapshot");
+                providers::snapshot::write(snapshot_path, payload);
+            }
+
+            // the models already have content, which is updated on the main thread
+            if (m_streaming || !first_run || !snapshot_checksum.isEmpty()) {
+                if (!first_run)
+                    qInfo().noquote() << tr_log("The library has changed, updating");
+                else if (!snapshot_checksum.isEmpty())
+                    qInfo().noquote() << tr_log("The library has changed since the last run, updating");
+
+                providers::sync::Library library;
+                library.games = std::move(games);
+                library.collections = std::move(collections);
+                library.collection_childs = std::move(collection_childs);
+                providers::sync::sort_library(library);
+
+                m_publish_timer = timer;
+                queueFinalData(std::move(library));
+                return;
+            }
+
+            publish(games, collections, collection_childs);
+        }
         emit thirdPhaseComplete(timer.elapsed());
     });
 }
 
-void ProviderManager::onGameFavoriteChanged(const QVector<model::Game*>& all_games)
+void ProviderManager::onSearchFinished()
+{
+    // the queued dynamic data, if any, was applied before this call
+    acceptEvents();
+    m_searching = false;
+    m_rescanning = false;
+    emit gameCountChanged(m_game_model->count());
+
+    // the games shown from now on look up their assets in the background
+    if (m_media_roots) {
+        const std::shared_ptr<const providers::MediaRoots> media_roots = m_media_roots;
+        m_game_model->library().setAssetLoader(
+            [media_roots](const modeldata::GamePath& game_path, modeldata::GameAssets& assets){
+                media_roots->findAssets(game_path, assets);
+            });
+    }
+
+    // the temporary data of the providers is gone by now
+    {
+        TRACE_SCOPE("release interned strings");
+        release_interned_strings();
+        m_game_model->library().compactStrings();
+    }
+    {
+        TRACE_SCOPE("release free heap");
+        release_free_heap();
+    }
+
+    startWatching();
+}
+
+void ProviderManager::queueGameBatch(const modeldata::GameStore& games,
+                                     const HashMap<QString, modeldata::Collection>& collections,
+                                     const HashMap<QString, std::vector<modeldata::GameId>>& collection_childs)
 {
-    if (m_init_seq.isRunning())
+    // Only the basic details of the games are known at this point. The containers
+    // are still used by the providers, so the relevant parts are copied.
+    providers::sync::Library batch;
+    batch.games.reserve(games.size());
+    batch.collections.reserve(collections.size());
+
+    // adding the games in the same order keeps their IDs
+    for (modeldata::GameId game_id = 0; game_id < games.size(); game_id++) {
+        const modeldata::Game& source = games.at(game_id);
+
+        modeldata::Game game(source.path());
+        game.title = source.title;
+        game.launch_cmd = source.launch_cmd;
+        game.launch_workdir = source.launch_workdir;
+        batch.games.add(games.key(game_id), std::move(game));
+    }
+    for (const auto& keyval : collections) {
+        modeldata::Collection coll(keyval.second.name);
+        if (!keyval.second.shortName().isEmpty())
+            coll.setShortName(keyval.second.shortName());
+        coll.summary = keyval.second.summary;
+        coll.description = keyval.second.description;
+        coll.launch_cmd = keyval.second.launch_cmd;
+        coll.launch_workdir = keyval.second.launch_workdir;
+        batch.collections.emplace(keyval.first, std::move(coll));
+    }
+    batch.collection_childs = collection_childs;
+
+    // the games may inherit the launch command of their collection only later
+    for (const auto& keyval : batch.collection_childs) {
+        const auto coll_it = batch.collections.find(keyval.first);
+        if (coll_it == batch.collections.cend())
+            continue;
+
+        for (const modeldata::GameId game_id : keyval.second) {
+            modeldata::Game& game = batch.games.at(game_id);
+            if (!game.launch_cmd.isEmpty())
+                continue;
+
+            game.launch_cmd = coll_it->second.launch_cmd;
+            if (game.launch_workdir.isEmpty())
+                game.launch_workdir = coll_it->second.launch_workdir;
+        }
+    }
+
+    providers::sync::sort_library(batch);
+    TRACE_COUNT("games streamed", static_cast<qint64>(batch.games.size()));
+
+
+    QMutexLocker lock(&m_pending_guard);
+    if (m_pending_is_final)
         return;
 
-    for (const auto& provider : m_providers)
-        provider->onGameFavoriteChanged(all_games);
+    m_pending_batches.push_back(std::move(batch));
+    if (m_pending_batches.size() == 1)
+        QMetaObject::invokeMethod(this, "applyPendingData", Qt::QueuedConnection);
+}
+
+void ProviderManager::queueFinalData(providers::sync::Library library)
+{
+    QMutexLocker lock(&m_pending_guard);
+
+    // the complete data supersedes the batches not yet shown
+    const bool call_pending = m_pending_batches.empty();
+    m_pending_batches.clear();
+    m_pending_batches.push_back(std::move(library));
+    m_pending_is_final = true;
+
+    if (call_pending)
+        QMetaObject::invokeMethod(this, "applyPendingData", Qt::QueuedConnection);
 }
 
-void ProviderManager::onGameLaunched(model::Game* const game)
+void ProviderManager::applyPendingData()
 {
-    if (m_init_seq.isRunning())
+    Q_ASSERT(m_game_model && m_collection_model);
+
+    std::vector<providers::sync::Library> batches;
+    bool is_final = false;
+    {
+        QMutexLocker lock(&m_pending_guard);
+        batches.swap(m_pending_batches);
+        std::swap(is_final, m_pending_is_final);
+    }
+
+    if (!is_final) {
+        const bool had_content = !m_collection_model->isEmpty();
+
+        for (providers::sync::Library& batch : batches) {
+            const QVector<model::GameSlot> new_games = providers::sync::add_missing(
+                batch, *m_game_model, *m_collection_model, m_gameid_to_slot);
+            m_streamed_games.append(new_games);
+        }
+
+        // let the UI appear
+        if (!had_content && !m_collection_model->isEmpty())
+            emit staticDataReady();
+
         return;
+    }
+
+
+    Q_ASSERT(batches.size() == 1);
+    m_accepts_events = false;
+
+    QVector<model::GameSlot> new_games = providers::sync::apply(
+        batches.front(), *m_game_model, *m_collection_model, m_gameid_to_slot);
+    emit gameCountChanged(m_game_model->count());
+    emit staticDataReady();
+
+    // the games that were not part of the previous library have no dynamic data yet;
+    // the streamed ones that were removed since then are not in the map anymore
+    new_games.append(m_streamed_games);
+    m_streamed_games.clear();
+    const QSet<model::GameSlot> dynamicless = QSet<model::GameSlot>::fromList(new_games.toList());
+
+    HashMap<QString, model::GameSlot> dyn_gameid_map;
+    for (const auto& keyval : m_gameid_to_slot) {
+        if (dynamicless.contains(keyval.second))
+            dyn_gameid_map.emplace(keyval.first, keyval.second);
+    }
+
+    m_init_seq = QtConcurrent::run([this, dyn_gameid_map]{
+        queueDynamicData(find_dynamic_data(m_providers, dyn_gameid_map));
+        emit thirdPhaseComplete(m_publish_timer.elapsed());
+    });
+}
+
+void ProviderManager::queueDynamicData(providers::sync::DynamicData dynamic_data)
+{
+    QMutexLocker lock(&m_pending_guard);
+
+    m_pending_dynamic.push_back(std::move(dynamic_data));
+    if (m_pending_dynamic.size() == 1)
+        QMetaObject::invokeMethod(this, "applyPendingDynamicData", Qt::QueuedConnection);
+}
+
+void ProviderManager::applyPendingDynamicData()
+{
+    std::vector<providers::sync::DynamicData> pending;
+    {
+        QMutexLocker lock(&m_pending_guard);
+        pending.swap(m_pending_dynamic);
+    }
+
+    for (const providers::sync::DynamicData& dynamic_data : pending)
+        applyDynamicData(dynamic_data);
+
+    acceptEvents();
+}
+
+void ProviderManager::acceptEvents()
+{
+    m_accepts_events = true;
 
+    // the changes made while the dynamic data was loading
+    if (m_favorites_changed) {
+        m_favorites_changed = false;
+        onGameFavoriteChanged();
+    }
+}
+
+void ProviderManager::applyDynamicData(const providers::sync::DynamicData& dynamic_data)
+{
+    Q_ASSERT(m_game_model);
+
+    // the data coming from the providers is not a change to be saved
+    m_applying_dynamic_data = true;
+    providers::sync::apply_dynamic_data(dynamic_data, m_game_model->library());
+    m_applying_dynamic_data = false;
+}
+
+void ProviderManager::startWatching()
+{
+    static constexpr auto MSG_PREFIX = "Live updates:";
+
+    const QStringList old_dirs = m_dir_watcher.directories();
+    if (!old_dirs.isEmpty())
+        m_dir_watcher.removePaths(old_dirs);
+
+    QStringList dirs;
     for (const auto& provider : m_providers)
-        provider->onGameLaunched(game);
+        dirs.append(provider->watchedDirs());
+    dirs.removeDuplicates();
+
+    if (dirs.isEmpty())
+        return;
+
+    // usually all of them fail for the same reason (eg. the system limit of watches)
+    const QStringList failed_dirs = m_dir_watcher.addPaths(dirs);
+    if (!failed_dirs.isEmpty()) {
+        qWarning().noquote() << MSG_PREFIX
+            << tr_log("could not watch %1 directories for changes").arg(failed_dirs.size());
+    }
+
+    qInfo().noquote() << MSG_PREFIX
+        << tr_log("watching %1 directories for changes").arg(dirs.size() - failed_dirs.size());
+}
+
+void ProviderManager::onDirectoryChanged(const QString& dir_path)
+{
+    if (!m_changed_dirs.contains(dir_path))
+        m_changed_dirs.append(dir_path);
+
+    m_dir_change_timer.start();
+}
+
+void ProviderManager::readDirChanges()
+{
+    // the models are being rebuilt, or the previous changes are
+    // still being read, try again later
+    if (m_searching || m_reading_dir_changes) {
+        m_dir_change_timer.start();
+        return;
+    }
+    Q_ASSERT(m_game_model && m_collection_model);
+
+    QStringList changed_dirs;
+    changed_dirs.swap(m_changed_dirs);
+    if (changed_dirs.isEmpty())
+        return;
+
+    // the media of the new games may have been added too
+    if (m_media_roots)
+        m_media_roots->clearIndex();
+
+    const QStringList watched_list = m_dir_watcher.directories();
+    const QSet<QString> watched_dirs = QSet<QString>::fromList(watched_list);
+
+    // the directories are read in the background, like during a search
+    m_reading_dir_changes = true;
+    m_dir_change_seq = QtConcurrent::run([this, changed_dirs, watched_dirs]{
+        TRACE_SCOPE("read changed directories");
+
+        // the changed directories are read again, but only once
+        filesystem::DirCache& dir_cache = filesystem::dir_cache();
+        dir_cache.startScan();
+
+        QStringList dirs = changed_dirs;
+        QSet<QString> known_dirs = QSet<QString>::fromList(changed_dirs);
+        QStringList new_dirs;
+
+        // new subdirectories may contain games too
+        for (const QString& dir_path : changed_dirs) {
+            if (!QFileInfo(dir_path).isDir())
+                continue;
+
+            const QStringList subdirs = dir_cache.subdirs(dir_path);
+            for (const QString& subdir : subdirs) {
+                if (watched_dirs.contains(subdir) || known_dirs.contains(subdir))
+                    continue;
+
+                known_dirs.insert(subdir);
+                new_dirs.append(subdir);
+                dirs.append(subdir);
+            }
+        }
+
+        std::vector<DirChange> changes;
+        changes.reserve(static_cast<size_t>(dirs.size()));
+        for (const QString& dir_path : qAsConst(dirs)) {
+            DirChange change;
+            change.dir_path = dir_path;
+            for (const auto& provider : m_providers)
+                provider->findGamesInDir(dir_path, change.games, change.collection_childs);
+
+            changes.push_back(std::move(change));
+        }
+
+        dir_cache.finishScan();
+        dir_cache.clear();
+
+        QMutexLocker lock(&m_pending_guard);
+        m_pending_dir_changes = std::move(changes);
+        m_pending_watched_dirs = std::move(new_dirs);
+        QMetaObject::invokeMethod(this, "applyPendingDirChanges", Qt::QueuedConnection);
+    });
 }
 
-void ProviderManager::onGameFinished(model::Game* const game)
+void ProviderManager::applyPendingDirChanges()
 {
-    if (m_init_seq.isRunning())
+    static constexpr auto MSG_PREFIX = "Live updates:";
+
+    std::vector<DirChange> changes;
+    QStringList new_dirs;
+    {
+        QMutexLocker lock(&m_pending_guard);
+        changes.swap(m_pending_dir_changes);
+        new_dirs.swap(m_pending_watched_dirs);
+    }
+    m_reading_dir_changes = false;
+
+    // a search has started since then, which finds the same changes
+    if (m_searching)
         return;
 
+    if (!m_changed_dirs.isEmpty())
+        m_dir_change_timer.start();
+
+    if (!new_dirs.isEmpty())
+        m_dir_watcher.addPaths(new_dirs);
+
+    const QVector<model::Collection*>& q_collections = m_collection_model->asList();
+    model::GameLibrary& game_library = m_game_model->library();
+
+    HashMap<QString, model::Collection*> collections_by_name;
+    for (model::Collection* const coll : q_collections)
+        collections_by_name.emplace(coll->name(), coll);
+
+    // the games of every collection that are directly in the changed directories,
+    // grouped by directory; the directory of every game is only checked once
+    HashMap<QString, size_t> dir_indices;
+    for (const DirChange& change : changes)
+        dir_indices.emplace(QDir::cleanPath(change.dir_path), dir_indices.size());
+
+    using CollectionGames = HashMap<model::Collection*, QSet<model::GameSlot>>;
+    std::vector<CollectionGames> dir_games(dir_indices.size());
+
+    constexpr size_t NO_DIR = std::numeric_limits<size_t>::max();
+    std::vector<size_t> slot_dirs(game_library.slotCount(), NO_DIR);
+    for (const model::GameSlot slot : m_game_model->asList()) {
+        const auto it = dir_indices.find(QDir::cleanPath(game_library.at(slot).path().absoluteDirPath()));
+        if (it != dir_indices.cend())
+            slot_dirs[slot] = it->second;
+    }
+    for (model::Collection* const coll : q_collections) {
+        for (const model::GameSlot slot : coll->games().asList()) {
+            if (slot < slot_dirs.size() && slot_dirs[slot] != NO_DIR)
+                dir_games[slot_dirs[slot]][coll].insert(slot);
+        }
+    }
+
+    HashMap<QString, model::GameSlot> added_gameid_map;
+    // the games removed from a collection, with the index of their directory
+    HashMap<model::GameSlot, size_t> removed_games;
+
+    for (DirChange& change : changes) {
+        const size_t dir_idx = dir_indices.at(QDir::cleanPath(change.dir_path));
+
+        for (const auto& keyval : change.collection_childs) {
+            const auto coll_it = collections_by_name.find(keyval.first);
+            if (coll_it == collections_by_name.cend())
+                continue;
+
+            model::Collection* const coll = coll_it->second;
+            model::GameListModel& coll_games = coll->games();
+            QSet<model::GameSlot>& old_games = dir_games[dir_idx][coll];
+
+            QSet<model::GameSlot> found_games;
+            for (const modeldata::GameId game_id : keyval.second) {
+                const QString& game_key = change.games.key(game_id);
+                auto game_it = m_gameid_to_slot.find(game_key);
+                if (game_it == m_gameid_to_slot.end()) {
+                    modeldata::Game& gamedata = change.games.at(game_id);
+                    if (gamedata.launch_cmd.isEmpty())
+                        gamedata.launch_cmd = coll->data().launch_cmd;
+                    if (gamedata.launch_workdir.isEmpty())
+                        gamedata.launch_workdir = coll->data().launch_workdir;
+
+                    const model::GameSlot slot = game_library.add(std::move(gamedata));
+                    providers::sync::insert_sorted(*m_game_model, slot);
+                    game_it = m_gameid_to_slot.emplace(game_key, slot).first;
+
+                    added_gameid_map.emplace(game_key, slot);
+                    qInfo().noquote() << MSG_PREFIX << tr_log("found `%1`").arg(game_key);
+                }
+
+                const model::GameSlot slot = game_it->second;
+                if (!old_games.contains(slot) && !found_games.contains(slot))
+                    providers::sync::insert_sorted(coll_games, slot);
+                found_games.insert(slot);
+            }
+
+            QSet<model::GameSlot> gone_games = old_games;
+            gone_games.subtract(found_games);
+            providers::sync::remove_games(coll_games, gone_games);
+            for (const model::GameSlot slot : qAsConst(gone_games))
+                removed_games.emplace(slot, dir_idx);
+
+            old_games = std::move(found_games);
+        }
+    }
+
+    // games that are not in any collection anymore; a game can only be
+    // in the collections of its own directory
+    QSet<model::GameSlot> orphan_games;
+    for (const auto& keyval : removed_games) {
+        const CollectionGames& colls = dir_games[keyval.second];
+        const bool orphan = std::none_of(colls.cbegin(), colls.cend(),
+            [&keyval](const CollectionGames::value_type& coll){ return coll.second.contains(keyval.first); });
+        if (orphan)
+            orphan_games.insert(keyval.first);
+    }
+
+    // the keys are found in a single pass, as a large directory may remove many games at once
+    if (!orphan_games.isEmpty()) {
+        providers::sync::remove_games(*m_game_model, orphan_games);
+
+        for (auto it = m_gameid_to_slot.begin(); it != m_gameid_to_slot.end();) {
+            const model::GameSlot slot = it->second;
+            if (!orphan_games.contains(slot)) {
+                ++it;
+                continue;
+            }
+
+            qInfo().noquote() << MSG_PREFIX << tr_log("`%1` was removed").arg(it->first);
+            it = m_gameid_to_slot.erase(it);
+            game_library.remove(slot);
+        }
+    }
+
+    if (added_gameid_map.empty() && removed_games.empty())
+        return;
+
+    emit gameCountChanged(m_game_model->count());
+
+    if (added_gameid_map.empty())
+        return;
+
+    applyDynamicData(find_dynamic_data(m_providers, added_gameid_map));
+}
+
+void ProviderManager::onGameFavoriteChanged()
+{
+    if (m_applying_dynamic_data)
+        return;
+
+    // the favorites are saved as a whole, so the ones not loaded yet would be lost
+    if (!m_accepts_events) {
+        m_favorites_changed = true;
+        return;
+    }
+
+    for (const auto& provider : m_providers)
+        provider->onGameFavoriteChanged(m_game_model->library(), m_game_model->asList());
+}
+
+// The play times don't depend on the loaded data, and the launches
+// and finishes are always passed on in pairs
+void ProviderManager::onGameLaunched(const model::GameSlot slot)
+{
+    for (const auto& provider : m_providers)
+        provider->onGameLaunched(m_game_model->library(), slot);
+}
+
+void ProviderManager::onGameFinished(const model::GameSlot slot)
+{
     for (const auto& provider : m_providers)
-        provider->onGameFinished(game);
+        provider->onGameFinished(m_game_model->library(), slot);
 }
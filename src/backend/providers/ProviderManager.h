@@ -17,11 +17,20 @@
 
 #pragma once
 
+#include "ModelSync.h"
 #include "Provider.h"
 #include "utils/FwdDeclModel.h"
 
 #include <QObject>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QFileSystemWatcher>
 #include <QFuture>
+#include <QMutex>
+#include <QStringList>
+#include <QThreadPool>
+#include <QTimer>
+#include <atomic>
 #include <memory>
 
 template<typename T> class QQmlObjectListModel;
@@ -33,13 +42,28 @@ class ProviderManager : public QObject {
 
 public:
     explicit ProviderManager(QObject* parent);
+    ~ProviderManager();
 
     size_t providerCount() const { return m_providers.size(); }
+    /// When enabled, the games are added to the models as soon as they are found,
+    /// and their details are filled in when the scanning is complete
+    void setStreamingEnabled(bool enabled) { m_streaming = enabled; }
+    /// When disabled, the library snapshot and the directory cache are neither read
+    /// nor written, and every directory is read from the disk during the search
+    void setCachesEnabled(bool enabled) { m_caches_enabled = enabled; }
+    /// When enabled, the media directories are not searched during the scan;
+    /// the assets of a game are looked up there when it's first shown
+    void setLazyAssetsEnabled(bool enabled) { m_lazy_assets = enabled; }
 
-    void startSearch(QQmlObjectListModel<model::Game>&, QQmlObjectListModel<model::Collection>&);
-    void onGameLaunched(model::Game* const);
-    void onGameFinished(model::Game* const);
-    void onGameFavoriteChanged(const QVector<model::Game*>&);
+    void startSearch(model::GameListModel&, QQmlObjectListModel<model::Collection>&);
+    /// Runs the providers again with the current settings, and updates
+    /// the models in place, keeping the objects of the unchanged entries
+    void startRescan();
+    bool isSearching() const { return m_searching; }
+
+    void onGameLaunched(const model::GameSlot);
+    void onGameFinished(const model::GameSlot);
+    void onGameFavoriteChanged();
 
 signals:
     void gameCountChanged(int);
@@ -52,5 +76,67 @@ signals:
 
 private:
     std::vector<ProviderPtr> m_providers;
+    std::vector<int> m_provider_game_counts;
     QFuture<void> m_init_seq;
+    QThreadPool m_worker_pool;
+    bool m_searching;
+    bool m_rescanning;
+    bool m_caches_enabled;
+    bool m_lazy_assets;
+    std::shared_ptr<providers::MediaRoots> m_media_roots;
+    QByteArray m_library_checksum;
+    // the favorites can't be saved while the dynamic data is loading;
+    // the changes made in the meantime are saved afterwards
+    std::atomic<bool> m_accepts_events;
+    bool m_applying_dynamic_data;
+    bool m_favorites_changed;
+
+    model::GameListModel* m_game_model;
+    QQmlObjectListModel<model::Collection>* m_collection_model;
+    HashMap<QString, model::GameSlot> m_gameid_to_slot;
+
+    // data waiting to be added to the models, which live on the main thread
+    bool m_streaming;
+    QMutex m_pending_guard;
+    std::vector<providers::sync::Library> m_pending_batches;
+    bool m_pending_is_final;
+    QVector<model::GameSlot> m_streamed_games;
+    QElapsedTimer m_publish_timer;
+    std::vector<providers::sync::DynamicData> m_pending_dynamic;
+
+    // the games found in a changed directory, read in the background
+    struct DirChange {
+        QString dir_path;
+        modeldata::GameStore games;
+        HashMap<QString, std::vector<modeldata::GameId>> collection_childs;
+    };
+    QFileSystemWatcher m_dir_watcher;
+    QTimer m_dir_change_timer;
+    QStringList m_changed_dirs;
+    QFuture<void> m_dir_change_seq;
+    bool m_reading_dir_changes;
+    std::vector<DirChange> m_pending_dir_changes;
+    QStringList m_pending_watched_dirs;
+
+    void createProviders();
+    void onProviderGameCountChanged(size_t provider_idx, int game_count);
+    void runSearch(bool first_run);
+    void onSearchFinished();
+
+    void queueGameBatch(const modeldata::GameStore&,
+                        const HashMap<QString, modeldata::Collection>&,
+                        const HashMap<QString, std::vector<modeldata::GameId>>&);
+    void queueFinalData(providers::sync::Library);
+    void queueDynamicData(providers::sync::DynamicData);
+    void applyDynamicData(const providers::sync::DynamicData&);
+    void acceptEvents();
+
+    void startWatching();
+    void onDirectoryChanged(const QString&);
+    void readDirChanges();
+
+private slots:
+    void applyPendingData();
+    void applyPendingDynamicData();
+    void applyPendingDirChanges();
 };
@@ -20,6 +20,7 @@
 #include "LocaleUtils.h"
 #include "modeldata/gaming/CollectionData.h"
 #include "modeldata/gaming/GameData.h"
+#include "modeldata/gaming/GameStore.h"
 #include "providers/JsonCacheUtils.h"
 #include "utils/HashMap.h"
 
@@ -118,9 +119,9 @@ Metadata::Metadata()
     rx_screenshots.optimize();
 }
 
-void Metadata::findStaticData(HashMap<QString, modeldata::Game>& games,
+void Metadata::findStaticData(modeldata::GameStore& games,
                               const HashMap<QString, modeldata::Collection>&,
-                              const HashMap<QString, std::vector<QString>>& collection_childs)
+                              const HashMap<QString, std::vector<modeldata::GameId>>& collection_childs)
 {
     const auto cc_it = collection_childs.find(QStringLiteral("Android"));
     if (cc_it == collection_childs.cend())
@@ -130,15 +131,15 @@ void Metadata::findStaticData(HashMap<QString, modeldata::Game>& games,
     fill_from_network(uncached_entries, games);
 }
 
-std::vector<QString> Metadata::fill_from_cache(const std::vector<QString>& child_ids,
-                                               HashMap<QString, modeldata::Game>& all_games)
+std::vector<modeldata::GameId> Metadata::fill_from_cache(const std::vector<modeldata::GameId>& child_ids,
+                                                         modeldata::GameStore& all_games)
 {
-    std::vector<QString> uncached_entries;
+    std::vector<modeldata::GameId> uncached_entries;
 
-    for (auto& child_id : child_ids) {
+    for (const modeldata::GameId child_id : child_ids) {
         modeldata::Game& game = all_games.at(child_id);
 
-        const bool filled = fill_from_cached_json(child_id, game);
+        const bool filled = fill_from_cached_json(all_games.key(child_id), game);
         if (!filled)
             uncached_entries.push_back(child_id);
     }
@@ -146,8 +147,8 @@ std::vector<QString> Metadata::fill_from_cache(const std::vector<QString>& child
     return uncached_entries;
 }
 
-void Metadata::fill_from_network(const std::vector<QString>& child_ids,
-                                 HashMap<QString, modeldata::Game>& games)
+void Metadata::fill_from_network(const std::vector<modeldata::GameId>& child_ids,
+                                 modeldata::GameStore& games)
 {
     if (child_ids.empty())
         return;
@@ -186,7 +187,8 @@ void Metadata::fill_from_network(const std::vector<QString>& child_ids,
                      &loop, &QEventLoop::quit);
 
     for (size_t i = 0; i < child_ids.size(); i++) {
-        const QString& id = child_ids[i];
+        const modeldata::GameId game_id = child_ids[i];
+        const QString& id = games.key(game_id);
         const QUrl url(GPLAY_URL.arg(id));
 
         QNetworkRequest request(url);
@@ -194,7 +196,7 @@ void Metadata::fill_from_network(const std::vector<QString>& child_ids,
         QNetworkReply* reply = netman.get(request);
 
         QObject::connect(reply, &QNetworkReply::finished,
-            [&, reply](){
+            [&, reply, game_id](){
                 completed_transfers++;
                 if (completed_transfers == listeners.count())
                     loop.quit();
@@ -214,7 +216,7 @@ void Metadata::fill_from_network(const std::vector<QString>& child_ids,
                 QByteArray html_raw = reply->readAll();
                 if (parse_reply(html_raw, json)) {
                     const QJsonDocument json_doc(json);
-                    modeldata::Game& game = games.at(id);
+                    modeldata::Game& game = games.at(game_id);
 
                     if (read_json(game, json_doc)) {
                         providers::cache_json(message_prefix, cache_dir, id, json_doc.toJson(QJsonDocument::Compact));
@@ -29,9 +29,9 @@ class Metadata {
 public:
     Metadata();
 
-    void findStaticData(HashMap<QString, modeldata::Game>&,
+    void findStaticData(modeldata::GameStore&,
                         const HashMap<QString, modeldata::Collection>&,
-                        const HashMap<QString, std::vector<QString>>&);
+                        const HashMap<QString, std::vector<modeldata::GameId>>&);
 
 private:
     const QRegularExpression rx_meta_itemprops;
@@ -40,10 +40,10 @@ private:
     const QRegularExpression rx_category;
     const QRegularExpression rx_screenshots;
 
-    std::vector<QString> fill_from_cache(const std::vector<QString>&,
-                                         HashMap<QString, modeldata::Game>&);
-    void fill_from_network(const std::vector<QString>&,
-                           HashMap<QString, modeldata::Game>&);
+    std::vector<modeldata::GameId> fill_from_cache(const std::vector<modeldata::GameId>&,
+                                                   modeldata::GameStore&);
+    void fill_from_network(const std::vector<modeldata::GameId>&,
+                           modeldata::GameStore&);
     bool parse_reply(QByteArray&, QJsonObject&);
 };
 
@@ -19,6 +19,7 @@
 
 #include "modeldata/gaming/CollectionData.h"
 #include "modeldata/gaming/GameData.h"
+#include "modeldata/gaming/GameStore.h"
 
 #include <QFileInfo>
 #include <QtAndroidExtras/QAndroidJniEnvironment>
@@ -32,9 +33,9 @@ AndroidAppsProvider::AndroidAppsProvider(QObject* parent)
     : Provider(parent)
 {}
 
-void AndroidAppsProvider::findLists(HashMap<QString, modeldata::Game>& games,
+void AndroidAppsProvider::findLists(modeldata::GameStore& games,
                                     HashMap<QString, modeldata::Collection>& collections,
-                                    HashMap<QString, std::vector<QString>>& collection_childs)
+                                    HashMap<QString, std::vector<modeldata::GameId>>& collection_childs)
 {
     static constexpr auto JNI_CLASS = "org/pegasus_frontend/android/MainActivity";
     static constexpr auto APPLIST_METHOD = "appList";
@@ -50,7 +51,7 @@ void AndroidAppsProvider::findLists(HashMap<QString, modeldata::Game>& games,
         collections.emplace(COLLECTION_TAG, modeldata::Collection(COLLECTION_TAG));
 
     modeldata::Collection& collection = collections.at(COLLECTION_TAG);
-    std::vector<QString>& childs = collection_childs[COLLECTION_TAG];
+    std::vector<modeldata::GameId>& childs = collection_childs[COLLECTION_TAG];
     collection.setShortName(COLLECTION_TAG);
 
 
@@ -67,11 +68,12 @@ void AndroidAppsProvider::findLists(HashMap<QString, modeldata::Game>& games,
         const QString action = jni_app.callObjectMethod<jstring>(APP_LAUNCH_ACT).toString();
         const QString component = jni_app.callObjectMethod<jstring>(APP_LAUNCH_CPT).toString();
 
-        childs.emplace_back(package);
-        if (!games.count(package))
-            games.emplace(package, modeldata::Game(QFileInfo(package)));
+        modeldata::GameId game_id = games.find(package);
+        if (game_id == modeldata::INVALID_GAMEID)
+            game_id = games.add(package, modeldata::Game(QFileInfo(package)));
+        childs.push_back(game_id);
 
-        modeldata::Game& game = games.at(package);
+        modeldata::Game& game = games.at(game_id);
         game.title = appname;
         game.launch_cmd = QStringLiteral("am start --user 0 -a %1 -n %2").arg(action, component);
 
@@ -80,9 +82,9 @@ void AndroidAppsProvider::findLists(HashMap<QString, modeldata::Game>& games,
     }
 }
 
-void AndroidAppsProvider::findStaticData(HashMap<QString, modeldata::Game>& games,
+void AndroidAppsProvider::findStaticData(modeldata::GameStore& games,
                                          const HashMap<QString, modeldata::Collection>& collections,
-                                         const HashMap<QString, std::vector<QString>>& collection_childs)
+                                         const HashMap<QString, std::vector<modeldata::GameId>>& collection_childs)
 {
     m_metadata.findStaticData(games, collections, collection_childs);
 }
@@ -30,12 +30,16 @@ class AndroidAppsProvider : public Provider {
 public:
     AndroidAppsProvider(QObject* parent = nullptr);
 
-    void findLists(HashMap<QString, modeldata::Game>&,
+    void findLists(modeldata::GameStore&,
                    HashMap<QString, modeldata::Collection>&,
-                   HashMap<QString, std::vector<QString>>&) final;
-    void findStaticData(HashMap<QString, modeldata::Game>&,
+                   HashMap<QString, std::vector<modeldata::GameId>>&) final;
+    void findStaticData(modeldata::GameStore&,
                         const HashMap<QString, modeldata::Collection>&,
-                        const HashMap<QString, std::vector<QString>>&) final;
+                        const HashMap<QString, std::vector<modeldata::GameId>>&) final;
+
+    // modifies the already existing entries too
+    StageAccess listsAccess() const final { return { GAME_LIST, GAME_LIST }; }
+    StageAccess staticDataAccess() const final { return { GAME_LIST, OWN_GAMES }; }
 
 private:
     Metadata m_metadata;
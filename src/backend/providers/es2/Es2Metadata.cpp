@@ -19,51 +19,19 @@
 
 #include "LocaleUtils.h"
 #include "Paths.h"
-#include "PegasusAssets.h"
+#include "Trace.h"
+#include "filesystem/DirCache.h"
 #include "modeldata/gaming/CollectionData.h"
 #include "modeldata/gaming/GameData.h"
+#include "modeldata/gaming/GameStore.h"
+#include "providers/AssetResolver.h"
 #include "utils/PathCheck.h"
 
 #include <QDebug>
-#include <QDir>
-#include <QDirIterator>
 #include <QFile>
 #include <QStringBuilder>
 #include <QUrl>
-
-
-namespace pegasus_legacy_assets {
-struct AssetCheckResult {
-    const QString basename;
-    const AssetType asset_type;
-
-    bool isValid() const {
-        return asset_type != AssetType::UNKNOWN && !basename.isEmpty();
-    }
-};
-
-AssetCheckResult checkFile(const QFileInfo& file)
-{
-    const QString basename = file.completeBaseName();
-    const int last_dash = basename.lastIndexOf(QChar('-'));
-    const QString suffix = (last_dash == -1)
-        ? QString()
-        : basename.mid(last_dash + 1);
-
-    // missing/unknown suffix -> guess by extension
-    const AssetType type = pegasus_assets::str_to_type(suffix);
-    if (type == AssetType::UNKNOWN)
-        return { basename, pegasus_assets::ext_to_type(file.suffix()) };
-
-    // known suffix but wrong extension -> invalid
-    const QString game_basename = basename.left(last_dash);
-    if (!pegasus_assets::allowed_asset_exts(type).contains(file.suffix()))
-        return { game_basename, AssetType::UNKNOWN };
-
-    // known suffix and valid extension
-    return { game_basename, type };
-}
-} // pegasus_legacy_assets
+#include <array>
 
 
 namespace {
@@ -111,30 +79,26 @@ void resolveShellChars(QString& path, const QString& containing_dir)
 void convertToCanonicalPath(QString& path, const QString& containing_dir)
 {
     resolveShellChars(path, containing_dir);
-    path = QFileInfo(path).canonicalFilePath();
+    path = filesystem::dir_cache().canonicalFilePath(path);
 }
 
-void findPegasusAssetsInScrapedir(const QDir& scrapedir,
-                                  const HashMap<QString, modeldata::Game* const>& games_by_shortpath)
+void findPegasusAssetsInScrapedir(const QString& scrapedir_path,
+                                  const QString& collection_shortname,
+                                  providers::AssetResolver& resolver)
 {
-    // FIXME: except the short path, this function is the same as the Pegasus asset code
-    if (!scrapedir.exists())
+    const auto collection_games = resolver.findDir(collection_shortname);
+    if (!collection_games)
         return;
 
-    QDirIterator dir_it(scrapedir, QDirIterator::FollowSymlinks);
-    while (dir_it.hasNext()) {
-        dir_it.next();
-        const QFileInfo fileinfo = dir_it.fileInfo();
-        const auto detection_result = pegasus_legacy_assets::checkFile(fileinfo);
-        if (!detection_result.isValid())
+    const filesystem::DirListing listing = filesystem::dir_cache().list(scrapedir_path);
+    for (const filesystem::DirEntry& entry : listing.entries) {
+        if (entry.is_dir)
             continue;
 
-        const QString shortpath = scrapedir.dirName() % '/' % detection_result.basename;
-        if (!games_by_shortpath.count(shortpath))
-            continue;
-
-        modeldata::Game* const game = games_by_shortpath.at(shortpath);
-        game->assets.addFileMaybe(detection_result.asset_type, dir_it.filePath());
+        QStringRef game_basename;
+        const AssetType asset_type = providers::AssetResolver::typeByNameSuffix(entry, game_basename);
+        const modeldata::GameId game_id = providers::AssetResolver::findGame(collection_games, game_basename);
+        resolver.addFile(game_id, asset_type, scrapedir_path, entry.name);
     }
 }
 
@@ -162,6 +126,14 @@ enum class MetaTypes : unsigned char {
     FAVORITE,
 };
 
+/// The fields of a single `<game>` entry. A fixed array, so reading the
+/// thousands of entries of a gamelist doesn't allocate map nodes for each.
+struct MetaValues {
+    std::array<QString, static_cast<size_t>(MetaTypes::FAVORITE) + 1> values;
+
+    QString& operator[](MetaTypes type) { return values[static_cast<size_t>(type)]; }
+};
+
 HashMap<QString, MetaTypes>::const_iterator find_by_strref(const HashMap<QString, MetaTypes>& map,
                                                            const QStringRef& str)
 {
@@ -174,7 +146,7 @@ HashMap<QString, MetaTypes>::const_iterator find_by_strref(const HashMap<QString
 }
 
 void findAssets(modeldata::Game& game,
-                HashMap<MetaTypes, QString, EnumHash>& xml_props,
+                MetaValues& xml_props,
                 const QString& collection_dir)
 {
     const QString rom_dir = collection_dir % '/';
@@ -191,7 +163,7 @@ void findAssets(modeldata::Game& game,
         if (!path.isEmpty() && ::validExtPath(path))
             game.assets.addFileMaybe(AssetType::ARCADE_MARQUEE, path);
     }
-    if (xml_props.count(MetaTypes::VIDEO)) {
+    {
         QString& path = xml_props[MetaTypes::VIDEO];
         resolveShellChars(path, rom_dir);
         if (!path.isEmpty() && ::validExtPath(path))
@@ -222,28 +194,23 @@ MetadataParser::MetadataParser(QObject* parent)
     , m_players_regex(QStringLiteral("(\\d+)(-(\\d+))?"))
 {}
 
-void MetadataParser::enhance(HashMap<QString, modeldata::Game>& games,
+void MetadataParser::enhance(modeldata::GameStore& games,
                              const HashMap<QString, modeldata::Collection>& collections,
-                             const HashMap<QString, std::vector<QString>>& collection_childs,
+                             const HashMap<QString, std::vector<modeldata::GameId>>& collection_childs,
                              const HashMap<QString, QString>& collection_dirs)
 {
     const QString imgdir_base = paths::homePath()
                               % QStringLiteral("/.emulationstation/downloaded_images/");
-    // shortpath: dir name + extensionless filename
-    HashMap<QString, modeldata::Game* const> games_by_shortpath;
-    games_by_shortpath.reserve(games.size());
-    for (const auto& coll_titles_pair : collection_childs) {
-        Q_ASSERT(collections.count(coll_titles_pair.first));
-        const QString coll_shortname = collections.at(coll_titles_pair.first).shortName();
-
-        for (const auto& title : coll_titles_pair.second) {
-            Q_ASSERT(games.count(title));
-            modeldata::Game* const game = &games.at(title);
-
-            const QString gamefile = game->fileinfo().completeBaseName();
-            const QString shortpath = coll_shortname % '/' % gamefile;
-            games_by_shortpath.emplace(shortpath, game);
-        }
+    // the games can also be found by their collection's short name and their file name
+    providers::AssetResolver resolver(games);
+    for (const auto& coll_childs_pair : collection_childs) {
+        Q_ASSERT(collections.count(coll_childs_pair.first));
+        const QString& coll_shortname = collections.at(coll_childs_pair.first).shortName();
+        if (coll_shortname.isEmpty())
+            continue;
+
+        for (const modeldata::GameId game_id : coll_childs_pair.second)
+            resolver.addAlias(coll_shortname, game_id);
     }
 
 
@@ -273,22 +240,26 @@ void MetadataParser::enhance(HashMap<QString, modeldata::Game>& games,
         }
 
         // parse the file
-        QXmlStreamReader xml(&xml_file);
-        parseGamelistFile(xml, games, collection_dir);
-        if (xml.error())
-            qWarning().noquote() << MSG_PREFIX << xml.errorString();
+        {
+            TRACE_SCOPE("parse ES2 gamelist", gamelist_path);
+            TRACE_COUNT("bytes read", xml_file.size());
+
+            QXmlStreamReader xml(&xml_file);
+            parseGamelistFile(xml, games, collection_dir);
+            if (xml.error())
+                qWarning().noquote() << MSG_PREFIX << xml.errorString();
+        }
 
         // search for assets in `downloaded_images`
         if (!collection.shortName().isEmpty()) {
-            constexpr auto dir_filters = QDir::Files | QDir::Readable | QDir::NoDotAndDotDot;
-            const QDir imgdir(imgdir_base % collection.shortName(), QString(), QDir::NoSort, dir_filters);
-            findPegasusAssetsInScrapedir(imgdir, games_by_shortpath);
+            const QString imgdir_path = imgdir_base % collection.shortName();
+            findPegasusAssetsInScrapedir(imgdir_path, collection.shortName(), resolver);
         }
     }
 }
 
 void MetadataParser::parseGamelistFile(QXmlStreamReader& xml,
-                                       HashMap<QString, modeldata::Game>& games,
+                                       modeldata::GameStore& games,
                                        const QString& collection_dir) const
 {
     // find the root <gameList> element
@@ -315,13 +286,13 @@ void MetadataParser::parseGamelistFile(QXmlStreamReader& xml,
 }
 
 void MetadataParser::parseGameEntry(QXmlStreamReader& xml,
-                                    HashMap<QString, modeldata::Game>& games,
+                                    modeldata::GameStore& games,
                                     const QString& collection_dir) const
 {
     Q_ASSERT(xml.isStartElement() && xml.name() == "game");
 
-    // read all XML fields into a key-value map
-    HashMap<MetaTypes, QString, EnumHash> xml_props;
+    // read all known XML fields
+    MetaValues xml_props;
     while (xml.readNextStartElement()) {
         const auto map_iter = find_by_strref(m_key_types, xml.name());
         if (map_iter == m_key_types.cend()) {
@@ -350,16 +321,17 @@ void MetadataParser::parseGameEntry(QXmlStreamReader& xml,
     // apply
 
     convertToCanonicalPath(game_path, collection_dir);
-    if (!games.count(game_path))
+    const modeldata::GameId game_id = games.find(game_path);
+    if (game_id == modeldata::INVALID_GAMEID)
         return;
 
-    modeldata::Game& game = games.at(game_path);
+    modeldata::Game& game = games.at(game_id);
     applyMetadata(game, xml_props);
     findAssets(game, xml_props, collection_dir);
 }
 
 void MetadataParser::applyMetadata(modeldata::Game& game,
-                                   HashMap<MetaTypes, QString, EnumHash>& xml_props) const
+                                   MetaValues& xml_props) const
 {
     // first, the simple strings
     game.title = xml_props[MetaTypes::NAME];
@@ -29,15 +29,16 @@ namespace providers {
 namespace es2 {
 
 enum class MetaTypes : unsigned char;
+struct MetaValues;
 
 class MetadataParser : public QObject {
     Q_OBJECT
 
 public:
     MetadataParser(QObject* parent);
-    void enhance(HashMap<QString, modeldata::Game>& games,
+    void enhance(modeldata::GameStore& games,
                  const HashMap<QString, modeldata::Collection>& collections,
-                 const HashMap<QString, std::vector<QString>>& collection_childs,
+                 const HashMap<QString, std::vector<modeldata::GameId>>& collection_childs,
                  const HashMap<QString, QString>& collection_dirs);
 
 private:
@@ -46,13 +47,13 @@ private:
     const QRegularExpression m_players_regex;
 
     void parseGamelistFile(QXmlStreamReader&,
-                           HashMap<QString, modeldata::Game>&,
+                           modeldata::GameStore&,
                            const QString&) const;
     void parseGameEntry(QXmlStreamReader&,
-                        HashMap<QString, modeldata::Game>&,
+                        modeldata::GameStore&,
                         const QString&) const;
     void applyMetadata(modeldata::Game&,
-                       HashMap<MetaTypes, QString, EnumHash>&) const;
+                       MetaValues&) const;
 };
 
 } // namespace es2
@@ -31,16 +31,16 @@ Es2Provider::Es2Provider(QObject* parent)
             this, &Es2Provider::gameCountChanged);
 }
 
-void Es2Provider::findLists(HashMap<QString, modeldata::Game>& games,
+void Es2Provider::findLists(modeldata::GameStore& games,
                             HashMap<QString, modeldata::Collection>& collections,
-                            HashMap<QString, std::vector<QString>>& collection_childs)
+                            HashMap<QString, std::vector<modeldata::GameId>>& collection_childs)
 {
     systems.find(games, collections, collection_childs, m_collection_dirs);
 }
 
-void Es2Provider::findStaticData(HashMap<QString, modeldata::Game>& games,
+void Es2Provider::findStaticData(modeldata::GameStore& games,
                                  const HashMap<QString, modeldata::Collection>& collections,
-                                 const HashMap<QString, std::vector<QString>>& collection_childs)
+                                 const HashMap<QString, std::vector<modeldata::GameId>>& collection_childs)
 {
     metadata.enhance(games, collections, collection_childs, m_collection_dirs);
 }
@@ -32,12 +32,15 @@ class Es2Provider : public Provider {
 public:
     Es2Provider(QObject* parent = nullptr);
 
-    void findLists(HashMap<QString, modeldata::Game>&,
+    void findLists(modeldata::GameStore&,
                    HashMap<QString, modeldata::Collection>&,
-                   HashMap<QString, std::vector<QString>>&) final;
-    void findStaticData(HashMap<QString, modeldata::Game>&,
+                   HashMap<QString, std::vector<modeldata::GameId>>&) final;
+    void findStaticData(modeldata::GameStore&,
                         const HashMap<QString, modeldata::Collection>&,
-                        const HashMap<QString, std::vector<QString>>&) final;
+                        const HashMap<QString, std::vector<modeldata::GameId>>&) final;
+
+    StageAccess listsAccess() const final { return { NO_DATA, GAME_LIST }; }
+    StageAccess staticDataAccess() const final { return { GAME_LIST, GAME_METADATA | GAME_ASSETS }; }
 
 private:
     SystemsParser systems;
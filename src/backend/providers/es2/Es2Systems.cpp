@@ -19,13 +19,17 @@
 
 #include "LocaleUtils.h"
 #include "Paths.h"
+#include "Trace.h"
+#include "filesystem/DirCache.h"
 #include "modeldata/gaming/CollectionData.h"
 #include "modeldata/gaming/GameData.h"
+#include "modeldata/gaming/GameStore.h"
 #include "utils/PathCheck.h"
 
 #include <QDebug>
-#include <QDirIterator>
 #include <QFile>
+#include <QFileInfo>
+#include <QRegExp>
 #include <QStringBuilder>
 
 
@@ -82,9 +86,9 @@ SystemsParser::SystemsParser(QObject* parent)
     : QObject(parent)
 {}
 
-void SystemsParser::find(HashMap<QString, modeldata::Game>& games,
+void SystemsParser::find(modeldata::GameStore& games,
                          HashMap<QString, modeldata::Collection>& collections,
-                         HashMap<QString, std::vector<QString>>& collection_childs,
+                         HashMap<QString, std::vector<modeldata::GameId>>& collection_childs,
                          HashMap<QString, QString>& collection_dirs)
 {
     // find the systems file
@@ -102,6 +106,9 @@ void SystemsParser::find(HashMap<QString, modeldata::Game>& games,
     }
 
     // parse the systems file
+    TRACE_SCOPE("parse ES2 systems", xml_path);
+    TRACE_COUNT("bytes read", xml_file.size());
+
     QXmlStreamReader xml(&xml_file);
     readSystemsFile(xml, games, collections, collection_childs, collection_dirs);
     if (xml.error())
@@ -109,9 +116,9 @@ void SystemsParser::find(HashMap<QString, modeldata::Game>& games,
 }
 
 void SystemsParser::readSystemsFile(QXmlStreamReader& xml,
-                                    HashMap<QString, modeldata::Game>& games,
+                                    modeldata::GameStore& games,
                                     HashMap<QString, modeldata::Collection>& collections,
-                                    HashMap<QString, std::vector<QString>>& collection_childs,
+                                    HashMap<QString, std::vector<modeldata::GameId>>& collection_childs,
                                     HashMap<QString, QString>& collection_dirs)
 {
     // read the root <systemList> element
@@ -143,9 +150,9 @@ void SystemsParser::readSystemsFile(QXmlStreamReader& xml,
 }
 
 void SystemsParser::readSystemEntry(QXmlStreamReader& xml,
-                                    HashMap<QString, modeldata::Game>& games,
+                                    modeldata::GameStore& games,
                                     HashMap<QString, modeldata::Collection>& collections,
-                                    HashMap<QString, std::vector<QString>>& collection_childs,
+                                    HashMap<QString, std::vector<modeldata::GameId>>& collection_childs,
                                     HashMap<QString, QString>& collection_dirs)
 {
     Q_ASSERT(xml.isStartElement() && xml.name() == "system");
@@ -225,38 +232,45 @@ void SystemsParser::readSystemEntry(QXmlStreamReader& xml,
 
     // pass 1: find all (sub-)directories, but ignore 'media'
 
-    QStringList dirs;
-    {
-        static constexpr auto subdir_filters = QDir::Dirs | QDir::Readable | QDir::NoDotAndDotDot;
-        static constexpr auto subdir_flags = QDirIterator::FollowSymlinks | QDirIterator::Subdirectories;
+    filesystem::DirCache& dir_cache = filesystem::dir_cache();
+    const QString& base_dir = xml_props[QLatin1String("path")];
+    dir_cache.prefetch({ base_dir });
 
-        QDirIterator dirs_it(xml_props[QLatin1String("path")], subdir_filters, subdir_flags);
-        while (dirs_it.hasNext()) {
-            dirs << dirs_it.next();
-        }
-        dirs.removeOne(xml_props[QLatin1String("path")] + QStringLiteral("/media"));
-        dirs.append(xml_props[QLatin1String("path")]);
-    }
+    QStringList dirs = dir_cache.subdirs(base_dir);
+    dirs.removeOne(base_dir + QStringLiteral("/media"));
+    dirs.append(base_dir);
 
     // pass 2: scan for game files
 
-    static constexpr auto entry_filters = QDir::Files | QDir::Dirs | QDir::Readable | QDir::NoDotAndDotDot;
-    static constexpr auto entry_flags = QDirIterator::FollowSymlinks;
     const QStringList name_filters = parseFilters(xml_props[QLatin1String("extension")]);
+    std::vector<QRegExp> name_matchers;
+    name_matchers.reserve(static_cast<size_t>(name_filters.size()));
+    for (const QString& filter : name_filters)
+        name_matchers.emplace_back(filter, Qt::CaseInsensitive, QRegExp::Wildcard);
+
+    const auto name_matches = [&name_matchers](const QString& name){
+        for (const QRegExp& matcher : name_matchers) {
+            if (matcher.exactMatch(name))
+                return true;
+        }
+        return false;
+    };
 
     for (const QString& dir_path : qAsConst(dirs)) {
-        QDirIterator files_it(dir_path, name_filters, entry_filters, entry_flags);
-        while (files_it.hasNext()) {
-            files_it.next();
-            QFileInfo fileinfo = files_it.fileInfo();
-            const QString game_key = fileinfo.canonicalFilePath();
-
-            if (!games.count(game_key)) {
-                modeldata::Game game(std::move(fileinfo));
+        const filesystem::DirListing listing = dir_cache.list(dir_path);
+
+        for (const filesystem::DirEntry& entry : listing.entries) {
+            if (!name_matches(entry.name))
+                continue;
+
+            QString game_key = listing.canonicalFilePath(entry);
+            modeldata::GameId game_id = games.find(game_key);
+            if (game_id == modeldata::INVALID_GAMEID) {
+                modeldata::Game game { modeldata::GamePath(dir_path, entry.name, game_key) };
                 game.launch_cmd = collection.launch_cmd;
-                games.emplace(game_key, std::move(game));
+                game_id = games.add(std::move(game_key), std::move(game));
             }
-            collection_childs[collection_name].emplace_back(game_key);
+            collection_childs[collection_name].push_back(game_id);
         }
     }
 }
@@ -34,9 +34,9 @@ class SystemsParser : public QObject {
 public:
     SystemsParser(QObject* parent);
 
-    void find(HashMap<QString, modeldata::Game>& games,
+    void find(modeldata::GameStore& games,
               HashMap<QString, modeldata::Collection>& collections,
-              HashMap<QString, std::vector<QString>>& collection_childs,
+              HashMap<QString, std::vector<modeldata::GameId>>& collection_childs,
               HashMap<QString, QString>& collection_dirs);
 
 signals:
@@ -44,14 +44,14 @@ signals:
 
 private:
     void readSystemsFile(QXmlStreamReader&,
-                         HashMap<QString, modeldata::Game>&,
+                         modeldata::GameStore&,
                          HashMap<QString, modeldata::Collection>&,
-                         HashMap<QString, std::vector<QString>>&,
+                         HashMap<QString, std::vector<modeldata::GameId>>&,
                          HashMap<QString, QString>&);
     void readSystemEntry(QXmlStreamReader&,
-                         HashMap<QString, modeldata::Game>&,
+                         modeldata::GameStore&,
                          HashMap<QString, modeldata::Collection>&,
-                         HashMap<QString, std::vector<QString>>&,
+                         HashMap<QString, std::vector<modeldata::GameId>>&,
                          HashMap<QString, QString>&);
 };
 
@@ -22,6 +22,7 @@
 #include "Paths.h"
 #include "modeldata/gaming/CollectionData.h"
 #include "modeldata/gaming/GameData.h"
+#include "modeldata/gaming/GameStore.h"
 #include "utils/MoveOnly.h"
 
 #include <QDebug>
@@ -127,26 +128,27 @@ bool invalid_entry(const GogEntry& entry)
 }
 
 void register_entries(const std::vector<GogEntry>& entries,
-                      HashMap<QString, modeldata::Game>& games,
-                      std::vector<QString>& collection_childs)
+                      modeldata::GameStore& games,
+                      std::vector<modeldata::GameId>& collection_childs)
 {
     for (const GogEntry& entry : entries) {
         QFileInfo finfo(entry.exe);
-        const QString game_key = finfo.canonicalFilePath();
+        QString game_key = finfo.canonicalFilePath();
 
-        if (!games.count(game_key)) {
-            modeldata::Game game(std::move(finfo));
+        modeldata::GameId game_id = games.find(game_key);
+        if (game_id == modeldata::INVALID_GAMEID) {
+            modeldata::Game game(finfo);
             game.title = entry.name;
             game.launch_cmd = '"' % entry.launch_cmd % '"';
             game.launch_workdir = entry.workdir;
 
             if (!entry.id.isEmpty())
-                game.extra.emplace(providers::gog::gog_id_key(), entry.id);
+                game.setExtra(providers::gog::gog_id_key(), entry.id);
 
-            games.emplace(game_key, std::move(game));
+            game_id = games.add(std::move(game_key), std::move(game));
         }
 
-        collection_childs.emplace_back(game_key);
+        collection_childs.push_back(game_id);
     }
 }
 } // namespace
@@ -159,9 +161,9 @@ Gamelist::Gamelist(QObject* parent)
     : QObject(parent)
 {}
 
-void Gamelist::find(HashMap<QString, modeldata::Game>& games,
+void Gamelist::find(modeldata::GameStore& games,
                     HashMap<QString, modeldata::Collection>& collections,
-                    HashMap<QString, std::vector<QString>>& collection_childs)
+                    HashMap<QString, std::vector<modeldata::GameId>>& collection_childs)
 {
     static constexpr auto MSG_PREFIX = "GOG:";
     const QString GOG_TAG(QStringLiteral("GOG"));
@@ -182,7 +184,7 @@ void Gamelist::find(HashMap<QString, modeldata::Game>& games,
         collections.emplace(GOG_TAG, std::move(collection));
     }
 
-    std::vector<QString>& childs = collection_childs[GOG_TAG];
+    std::vector<modeldata::GameId>& childs = collection_childs[GOG_TAG];
 
     const size_t game_count_before = games.size();
     register_entries(entries, games, childs);
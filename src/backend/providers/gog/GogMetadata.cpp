@@ -21,6 +21,7 @@
 #include "LocaleUtils.h"
 #include "providers/JsonCacheUtils.h"
 #include "modeldata/gaming/GameData.h"
+#include "modeldata/gaming/GameStore.h"
 
 #include <QEventLoop>
 #include <QJsonArray>
@@ -95,7 +96,7 @@ bool read_embed_json(modeldata::Game& game, const QJsonDocument& json)
         return false;
 
 
-    const QString game_id = game.extra.at(providers::gog::gog_id_key());
+    const QString& game_id = game.extra(providers::gog::gog_id_key());
 
     const auto products = json_root[QLatin1String("products")].toArray();
     for (const auto& products_entry : products) {
@@ -118,13 +119,13 @@ bool read_embed_json(modeldata::Game& game, const QJsonDocument& json)
 
 bool fill_from_cache(modeldata::Game& entry)
 {
-    if (!entry.extra.count(providers::gog::gog_id_key()))
+    if (!entry.hasExtra(providers::gog::gog_id_key()))
         return false;
 
     const QString message_prefix = QLatin1String(MSG_PREFIX);
     const QString cache_dir = QLatin1String(JSON_CACHE_DIR);
-    const QString entry_api = entry.extra.at(providers::gog::gog_id_key()) + providers::gog::json_api_suffix();
-    const QString entry_embed = entry.extra.at(providers::gog::gog_id_key()) + providers::gog::json_embed_suffix();
+    const QString entry_api = entry.extra(providers::gog::gog_id_key()) + providers::gog::json_api_suffix();
+    const QString entry_embed = entry.extra(providers::gog::gog_id_key()) + providers::gog::json_embed_suffix();
 
     const auto json_api = providers::read_json_from_cache(message_prefix, cache_dir, entry_api);
     const bool json_api_success = read_api_json(entry, json_api);
@@ -165,7 +166,7 @@ void download_metadata(std::vector<modeldata::Game*>& entries, QNetworkAccessMan
     // FIXME: Remove this huge duplication -- or rather, rethink the process
 
     for (size_t i = 0; i < entries.size(); i++) {
-        const QString gog_id = entries[i]->extra.at(providers::gog::gog_id_key());
+        const QString gog_id = entries[i]->extra(providers::gog::gog_id_key());
 
         const QUrl url(API_URL.arg(gog_id));
         QNetworkRequest request(url);
@@ -187,7 +188,7 @@ void download_metadata(std::vector<modeldata::Game*>& entries, QNetworkAccessMan
                     const auto raw_data = reply->readAll();
                     const bool json_success = read_api_json(*entries[i], QJsonDocument::fromJson(raw_data));
                     if (json_success) {
-                        const QString json_name = entries[i]->extra.at(providers::gog::gog_id_key())
+                        const QString json_name = entries[i]->extra(providers::gog::gog_id_key())
                                                 + providers::gog::json_api_suffix();
                         providers::cache_json(message_prefix, cache_dir,
                                               json_name, raw_data);
@@ -207,7 +208,7 @@ void download_metadata(std::vector<modeldata::Game*>& entries, QNetworkAccessMan
     }
 
     for (size_t i = 0; i < entries.size(); i++) {
-        const QString gog_id = entries[i]->extra.at(providers::gog::gog_id_key());
+        const QString gog_id = entries[i]->extra(providers::gog::gog_id_key());
 
         const QUrl url(EMBED_URL.arg(entries[i]->title)); // TODO: this seems to work, but shouldn't it be escaped?
         QNetworkRequest request(url);
@@ -229,7 +230,7 @@ void download_metadata(std::vector<modeldata::Game*>& entries, QNetworkAccessMan
                     const auto raw_data = reply->readAll();
                     const bool json_success = read_embed_json(*entries[i], QJsonDocument::fromJson(raw_data));
                     if (json_success) {
-                        const QString json_name = entries[i]->extra.at(providers::gog::gog_id_key())
+                        const QString json_name = entries[i]->extra(providers::gog::gog_id_key())
                                                 + providers::gog::json_embed_suffix();
                         providers::cache_json(message_prefix, cache_dir,
                                               json_name, raw_data);
@@ -276,9 +277,9 @@ Metadata::Metadata(QObject* parent)
     : QObject(parent)
 {}
 
-void Metadata::enhance(HashMap<QString, modeldata::Game>& games,
+void Metadata::enhance(modeldata::GameStore& games,
                        const HashMap<QString, modeldata::Collection>&,
-                       const HashMap<QString, std::vector<QString>>& collection_childs)
+                       const HashMap<QString, std::vector<modeldata::GameId>>& collection_childs)
 {
     const QString GOG_TAG(QStringLiteral("GOG"));
     if (!collection_childs.count(GOG_TAG))
@@ -286,10 +287,10 @@ void Metadata::enhance(HashMap<QString, modeldata::Game>& games,
 
     std::vector<modeldata::Game*> entries;
 
-    const std::vector<QString>& childs = collection_childs.at(GOG_TAG);
-    for (const QString& game_key : childs) {
-        modeldata::Game* game = &games.at(game_key);
-        if (game->extra.count(gog_id_key()))
+    const std::vector<modeldata::GameId>& childs = collection_childs.at(GOG_TAG);
+    for (const modeldata::GameId game_id : childs) {
+        modeldata::Game* game = &games.at(game_id);
+        if (game->hasExtra(gog_id_key()))
             entries.emplace_back(game);
     }
 
@@ -32,9 +32,9 @@ class Metadata : public QObject {
 public:
     explicit Metadata(QObject* parent);
 
-    void enhance(HashMap<QString, modeldata::Game>&,
+    void enhance(modeldata::GameStore&,
                  const HashMap<QString, modeldata::Collection>&,
-                 const HashMap<QString, std::vector<QString>>&);
+                 const HashMap<QString, std::vector<modeldata::GameId>>&);
 };
 
 } // namespace gog
@@ -30,16 +30,16 @@ GogProvider::GogProvider(QObject* parent)
             this, &GogProvider::gameCountChanged);
 }
 
-void GogProvider::findLists(HashMap<QString, modeldata::Game>& games,
+void GogProvider::findLists(modeldata::GameStore& games,
                             HashMap<QString, modeldata::Collection>& collections,
-                            HashMap<QString, std::vector<QString>>& collection_childs)
+                            HashMap<QString, std::vector<modeldata::GameId>>& collection_childs)
 {
     gamelist.find(games, collections, collection_childs);
 }
 
-void GogProvider::findStaticData(HashMap<QString, modeldata::Game>& games,
+void GogProvider::findStaticData(modeldata::GameStore& games,
                                  const HashMap<QString, modeldata::Collection>& collections,
-                                 const HashMap<QString, std::vector<QString>>& collection_childs)
+                                 const HashMap<QString, std::vector<modeldata::GameId>>& collection_childs)
 {
     metadata.enhance(games, collections, collection_childs);
 }
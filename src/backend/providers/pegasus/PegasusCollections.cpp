@@ -22,12 +22,15 @@
 #include "Paths.h"
 #include "PegasusAssets.h"
 #include "PegasusCommon.h"
+#include "PegasusFilter.h"
+#include "filesystem/DirCache.h"
 #include "modeldata/gaming/CollectionData.h"
 #include "modeldata/gaming/GameData.h"
+#include "modeldata/gaming/GameStore.h"
 #include "utils/PathCheck.h"
 
 #include <QDebug>
-#include <QDirIterator>
+#include <QFileInfo>
 #include <QRegularExpression>
 #include <QStringBuilder>
 
@@ -40,6 +43,7 @@ enum class CollAttribType : unsigned char {
     DIRECTORIES,
     EXTENSIONS,
     FILES,
+    FILE_GLOBS,
     REGEX,
     SHORT_DESC,
     LONG_DESC,
@@ -55,32 +59,16 @@ namespace {
 static constexpr auto MSG_PREFIX = "Collections:";
 
 using AttribType = providers::pegasus::CollAttribType;
-
-struct GameFilterGroup {
-    QStringList extensions;
-    QStringList files;
-    QString regex;
-};
-struct GameFilter {
-    QString parent_collection;
-    QStringList directories;
-    GameFilterGroup include;
-    GameFilterGroup exclude;
-    QStringList extra;
-
-    GameFilter(QString parent, QString base_dir)
-        : parent_collection(parent)
-        , directories(base_dir)
-    {}
-};
+using GameFilter = providers::pegasus::GameFilter;
+using GameFilterGroup = providers::pegasus::GameFilterGroup;
 
 std::vector<GameFilter> read_collections_file(const HashMap<QString, AttribType>& key_types,
                                               const QString& dir_path,
                                               HashMap<QString, modeldata::Collection>& collections)
 {
     // reminder: sections are collection names
-    // including keys: extensions, files, regex
-    // excluding keys: ignore-extensions, ignore-files, ignore-regex
+    // including keys: extensions, files, files-glob, regex
+    // excluding keys: ignore-extensions, ignore-files, ignore-files-glob, ignore-regex
     // optional: name, launch, directories
 
     const QRegularExpression rx_asset_key(QStringLiteral(R"(^assets?\.default-?(.+)$)"));
@@ -158,8 +146,11 @@ std::vector<GameFilter> read_collections_file(const HashMap<QString, AttribType>
             case AttribType::FILES:
                 filter_group.files.append(val);
                 break;
+            case AttribType::FILE_GLOBS:
+                filter_group.file_globs.append(val);
+                break;
             case AttribType::REGEX:
-                filter_group.regex = val;
+                filter_group.regex.setPattern(val);
                 break;
             case AttribType::SHORT_DESC:
                 curr_coll->summary = val;
@@ -198,67 +189,47 @@ std::vector<GameFilter> read_collections_file(const HashMap<QString, AttribType>
         filter.directories.removeDuplicates();
         filter.include.extensions.removeDuplicates();
         filter.include.files.removeDuplicates();
+        filter.include.file_globs.removeDuplicates();
         filter.exclude.extensions.removeDuplicates();
         filter.exclude.files.removeDuplicates();
+        filter.exclude.file_globs.removeDuplicates();
         filter.extra.removeDuplicates();
+        filter.compile();
     }
     return filters;
 }
 
 void process_filter(const GameFilter& filter,
-                    HashMap<QString, modeldata::Game>& games,
+                    modeldata::GameStore& games,
                     HashMap<QString, modeldata::Collection>& collections,
-                    HashMap<QString, std::vector<QString>>& collection_childs)
+                    HashMap<QString, std::vector<modeldata::GameId>>& collection_childs)
 {
-    constexpr auto entry_filters = QDir::Files | QDir::Dirs | QDir::Readable | QDir::NoDotAndDotDot;
-    constexpr auto subdir_filters = QDir::Dirs | QDir::Readable | QDir::NoDotAndDotDot;
-    constexpr auto entry_flags = QDirIterator::FollowSymlinks;
-    constexpr auto subdir_flags = QDirIterator::FollowSymlinks | QDirIterator::Subdirectories;
-
-    const QRegularExpression include_regex(filter.include.regex);
-    const QRegularExpression exclude_regex(filter.exclude.regex);
-
+    filesystem::DirCache& dir_cache = filesystem::dir_cache();
 
     for (const QString& filter_dir : filter.directories)
     {
         // find all dirs and subdirectories, but ignore 'media'
-        QStringList dirs_to_check;
-        {
-            QDirIterator dirs_it(filter_dir, subdir_filters, subdir_flags);
-            while (dirs_it.hasNext())
-                dirs_to_check << dirs_it.next();
-
-            dirs_to_check.removeOne(filter_dir + QStringLiteral("/media"));
-            dirs_to_check.append(filter_dir + QStringLiteral("/")); // added "/" so all entries have base + 1 length
-        }
+        QStringList dirs_to_check = dir_cache.subdirs(filter_dir);
+        dirs_to_check.removeOne(filter_dir + QStringLiteral("/media"));
+        dirs_to_check.append(filter_dir);
 
         // run through the directories
         for (const QString& subdir : qAsConst(dirs_to_check)) {
-            QDirIterator subdir_it(subdir, entry_filters, entry_flags);
-            while (subdir_it.hasNext()) {
-                subdir_it.next();
-                QFileInfo fileinfo = subdir_it.fileInfo();
-                const QString relative_path = fileinfo.filePath().mid(filter_dir.length() + 1);
-
-                const bool exclude = filter.exclude.extensions.contains(fileinfo.suffix())
-                    || filter.exclude.files.contains(relative_path)
-                    || (!filter.exclude.regex.isEmpty() && exclude_regex.match(fileinfo.filePath()).hasMatch());
-                if (exclude)
-                    continue;
+            const filesystem::DirListing listing = dir_cache.list(subdir);
 
-                const bool include = filter.include.extensions.contains(fileinfo.suffix())
-                    || filter.include.files.contains(relative_path)
-                    || (!filter.include.regex.isEmpty() && include_regex.match(fileinfo.filePath()).hasMatch());
-                if (!include)
+            for (const filesystem::DirEntry& entry : listing.entries) {
+                const QString file_path = subdir % '/' % entry.name;
+                if (!filter.accepts(filter_dir, file_path, entry.suffixRef()))
                     continue;
 
-                const QString game_key = fileinfo.canonicalFilePath();
-                if (!games.count(game_key)) {
-                    modeldata::Game game(std::move(fileinfo));
+                QString game_key = listing.canonicalFilePath(entry);
+                modeldata::GameId game_id = games.find(game_key);
+                if (game_id == modeldata::INVALID_GAMEID) {
+                    modeldata::Game game { modeldata::GamePath(subdir, entry.name, game_key) };
                     game.launch_cmd = collections.at(filter.parent_collection).launch_cmd;
-                    games.emplace(game_key, std::move(game));
+                    game_id = games.add(std::move(game_key), std::move(game));
                 }
-                collection_childs[filter.parent_collection].emplace_back(game_key);
+                collection_childs[filter.parent_collection].push_back(game_id);
             }
         }
     }
@@ -281,11 +252,15 @@ PegasusCollections::PegasusCollections()
         { QStringLiteral("extensions"), AttribType::EXTENSIONS },
         { QStringLiteral("file"), AttribType::FILES },
         { QStringLiteral("files"), AttribType::FILES },
+        { QStringLiteral("file-glob"), AttribType::FILE_GLOBS },
+        { QStringLiteral("files-glob"), AttribType::FILE_GLOBS },
         { QStringLiteral("regex"), AttribType::REGEX },
         { QStringLiteral("ignore-extension"), AttribType::EXTENSIONS },
         { QStringLiteral("ignore-extensions"), AttribType::EXTENSIONS },
         { QStringLiteral("ignore-file"), AttribType::FILES },
         { QStringLiteral("ignore-files"), AttribType::FILES },
+        { QStringLiteral("ignore-file-glob"), AttribType::FILE_GLOBS },
+        { QStringLiteral("ignore-files-glob"), AttribType::FILE_GLOBS },
         { QStringLiteral("ignore-regex"), AttribType::REGEX },
         { QStringLiteral("summary"), AttribType::SHORT_DESC },
         { QStringLiteral("description"), AttribType::LONG_DESC },
@@ -296,11 +271,11 @@ PegasusCollections::PegasusCollections()
 {
 }
 
-void PegasusCollections::find_in_dirs(const std::vector<QString>& dir_list,
-                                      HashMap<QString, modeldata::Game>& games,
-                                      HashMap<QString, modeldata::Collection>& collections,
-                                      HashMap<QString, std::vector<QString>>& collection_childs,
-                                      const std::function<void(int)>& update_gamecount_maybe) const
+std::vector<GameFilter> PegasusCollections::find_in_dirs(const std::vector<QString>& dir_list,
+                                                         modeldata::GameStore& games,
+                                                         HashMap<QString, modeldata::Collection>& collections,
+                                                         HashMap<QString, std::vector<modeldata::GameId>>& collection_childs,
+                                                         const std::function<void(int)>& update_gamecount_maybe) const
 {
     std::vector<GameFilter> all_filters;
 
@@ -311,10 +286,80 @@ void PegasusCollections::find_in_dirs(const std::vector<QString>& dir_list,
                            std::make_move_iterator(filters.begin()),
                            std::make_move_iterator(filters.end()));
     }
+
+    // read the game directories in parallel first, the filters then walk them in order
+    QStringList filter_dirs;
+    for (const GameFilter& filter : all_filters)
+        filter_dirs.append(filter.directories);
+    filter_dirs.removeDuplicates();
+    filesystem::dir_cache().prefetch(filter_dirs);
+
     for (const GameFilter& filter : all_filters)
         process_filter(filter, games, collections, collection_childs);
 
     update_gamecount_maybe(static_cast<int>(games.size()));
+    return all_filters;
+}
+
+QStringList PegasusCollections::watched_dirs(const std::vector<GameFilter>& filters) const
+{
+    filesystem::DirCache& dir_cache = filesystem::dir_cache();
+
+    QStringList dirs;
+    for (const GameFilter& filter : filters) {
+        for (const QString& filter_dir : filter.directories) {
+            dirs.append(filter_dir);
+
+            // the asset trees can be large, and would only use up the watches
+            const QString media_dir = filter_dir + QStringLiteral("/media");
+            const QString media_prefix = media_dir + QLatin1Char('/');
+            const QStringList subdirs = dir_cache.subdirs(filter_dir);
+            for (const QString& subdir : subdirs) {
+                if (subdir != media_dir && !subdir.startsWith(media_prefix))
+                    dirs.append(subdir);
+            }
+        }
+    }
+
+    dirs.removeDuplicates();
+    return dirs;
+}
+
+void PegasusCollections::find_in_changed_dir(const std::vector<GameFilter>& filters,
+                                             const QString& dir_path,
+                                             modeldata::GameStore& games,
+                                             HashMap<QString, std::vector<modeldata::GameId>>& collection_childs) const
+{
+    filesystem::DirCache& dir_cache = filesystem::dir_cache();
+    const filesystem::DirListing listing = dir_cache.list(dir_path);
+
+    for (const GameFilter& filter : filters) {
+        for (const QString& filter_dir : filter.directories) {
+            const bool in_filter_dir = dir_path == filter_dir
+                || (dir_path.startsWith(filter_dir + QLatin1Char('/'))
+                    && dir_path != filter_dir + QStringLiteral("/media"));
+            if (!in_filter_dir)
+                continue;
+
+            // the collection may lose all of its games from this directory
+            std::vector<modeldata::GameId>& childs = collection_childs[filter.parent_collection];
+
+            for (const filesystem::DirEntry& entry : listing.entries) {
+                const QString file_path = dir_path % '/' % entry.name;
+                if (!filter.accepts(filter_dir, file_path, entry.suffixRef()))
+                    continue;
+
+                QString game_key = listing.canonicalFilePath(entry);
+                modeldata::GameId game_id = games.find(game_key);
+                if (game_id == modeldata::INVALID_GAMEID) {
+                    modeldata::Game game { modeldata::GamePath(dir_path, entry.name, game_key) };
+                    game_id = games.add(std::move(game_key), std::move(game));
+                }
+
+                childs.push_back(game_id);
+            }
+        }
+    }
 }
 
 } // namespace pegasus
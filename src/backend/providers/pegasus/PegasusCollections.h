@@ -17,10 +17,12 @@
 
 #pragma once
 
+#include "PegasusFilter.h"
 #include "utils/FwdDeclModelData.h"
 #include "utils/HashMap.h"
 
 #include <QString>
+#include <QStringList>
 #include <functional>
 #include <vector>
 
@@ -34,11 +36,19 @@ class PegasusCollections {
 public:
     PegasusCollections();
 
-    void find_in_dirs(const std::vector<QString>&,
-                      HashMap<QString, modeldata::Game>&,
-                      HashMap<QString, modeldata::Collection>&,
-                      HashMap<QString, std::vector<QString>>&,
-                      const std::function<void(int)>&) const;
+    std::vector<GameFilter> find_in_dirs(const std::vector<QString>&,
+                                         modeldata::GameStore&,
+                                         HashMap<QString, modeldata::Collection>&,
+                                         HashMap<QString, std::vector<modeldata::GameId>>&,
+                                         const std::function<void(int)>&) const;
+
+    /// All directories the filters may find games in, except the `media` trees
+    QStringList watched_dirs(const std::vector<GameFilter>&) const;
+    /// Finds the games directly inside a single directory
+    void find_in_changed_dir(const std::vector<GameFilter>&,
+                             const QString&,
+                             modeldata::GameStore&,
+                             HashMap<QString, std::vector<modeldata::GameId>>&) const;
 
 private:
     const HashMap<QString, CollAttribType> m_key_types;
@@ -18,7 +18,6 @@
 #include "PegasusCommon.h"
 
 #include <QFileInfo>
-#include <QUrl>
 
 
 namespace providers {
@@ -38,19 +37,16 @@ void add_asset(modeldata::GameAssets& game_assets, const AssetType asset_type, c
 {
     Q_ASSERT(asset_type != AssetType::UNKNOWN);
 
-    QString url;
     if (value.startsWith(QStringLiteral("http://")) || value.startsWith(QStringLiteral("https://"))) {
-        url = value;
+        game_assets.addUrlMaybe(asset_type, value);
+        return;
     }
-    else {
-        QFileInfo finfo(value);
-        if (finfo.isRelative())
-            finfo.setFile(relative_dir + '/' + value);
 
-        url = QUrl::fromLocalFile(finfo.absoluteFilePath()).toString();
-    }
+    QFileInfo finfo(value);
+    if (finfo.isRelative())
+        finfo.setFile(relative_dir + '/' + value);
 
-    game_assets.addUrlMaybe(asset_type, std::move(url));
+    game_assets.addFileMaybe(asset_type, finfo.absoluteFilePath());
 }
 
 } // namespace pegasus
@@ -0,0 +1,389 @@
+// Pegasus Frontend
+// Copyright (C) 2018  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "PegasusFilter.h"
+
+#include "LocaleUtils.h"
+
+#include <QDebug>
+#include <QHash>
+
+
+namespace {
+static constexpr auto MSG_PREFIX = "Collections:";
+
+/// If there is a well-formed bracket set starting at `start`, returns the index
+/// of its closing bracket, otherwise -1. A `]` right after the opening bracket
+/// (and the optional `!`) is part of the set, and the set can't be empty, so
+/// tags like `[!]` are not sets.
+int glob_set_end(const QString& glob, int start)
+{
+    Q_ASSERT(glob.at(start) == QLatin1Char('['));
+
+    int i = start + 1;
+    if (i < glob.length() && glob.at(i) == QLatin1Char('!'))
+        i++;
+    if (i >= glob.length())
+        return -1;
+
+    // the first item, which can be a `]`
+    i++;
+    const int end = glob.indexOf(QLatin1Char(']'), i);
+    if (end < 0)
+        return -1;
+
+    // sets don't span directories
+    const int sep = glob.indexOf(QLatin1Char('/'), start);
+    return (0 <= sep && sep < end) ? -1 : end;
+}
+
+/// Converts a glob pattern to a regular expression; the wildcards don't match
+/// the directory separator, except `**`, which matches any number of directories.
+/// Brackets that don't form a valid set are matched literally.
+QString glob_to_regex(const QString& glob)
+{
+    QString rx;
+    rx.reserve(glob.length() * 2);
+
+    for (int i = 0; i < glob.length(); i++) {
+        const QChar c = glob.at(i);
+
+        if (c == QLatin1Char('*')) {
+            const bool double_star = i + 1 < glob.length() && glob.at(i + 1) == QLatin1Char('*');
+            if (!double_star) {
+                rx += QLatin1String("[^/]*");
+                continue;
+            }
+
+            // `**/` can match no directory at all
+            const bool with_sep = i + 2 < glob.length() && glob.at(i + 2) == QLatin1Char('/');
+            rx += with_sep ? QLatin1String("(?:.*/)?") : QLatin1String(".*");
+            i += with_sep ? 2 : 1;
+            continue;
+        }
+        if (c == QLatin1Char('?')) {
+            rx += QLatin1String("[^/]");
+            continue;
+        }
+        if (c == QLatin1Char('[')) {
+            const int end = glob_set_end(glob, i);
+            if (end > 0) {
+                QString set = glob.mid(i + 1, end - i - 1);
+                set.replace(QLatin1Char('\\'), QLatin1String("\\\\"));
+                set.replace(QLatin1Char('['), QLatin1String("\\["));
+                if (set.startsWith(QLatin1Char('!')))
+                    set[0] = QLatin1Char('^');
+
+                rx += QLatin1Char('[');
+                rx += set;
+                rx += QLatin1Char(']');
+                i = end;
+                continue;
+            }
+        }
+
+        rx += QRegularExpression::escape(QString(c));
+    }
+
+    return rx;
+}
+
+/// The text after the last wildcard of the glob pattern
+QString glob_literal_tail(const QString& glob)
+{
+    int tail_start = 0;
+    for (int i = 0; i < glob.length(); i++) {
+        const QChar c = glob.at(i);
+        if (c == QLatin1Char('*') || c == QLatin1Char('?')) {
+            tail_start = i + 1;
+            continue;
+        }
+        if (c == QLatin1Char('[')) {
+            const int end = glob_set_end(glob, i);
+            if (end > 0) {
+                i = end;
+                tail_start = end + 1;
+            }
+        }
+    }
+    return glob.mid(tail_start);
+}
+
+/// If there is a counted quantifier (`{n}`, `{n,}` or `{n,m}`) starting at
+/// `start`, returns the index of its closing brace, otherwise -1
+int regex_quantifier_end(const QString& pattern, int start)
+{
+    Q_ASSERT(pattern.at(start) == QLatin1Char('{'));
+
+    int i = start + 1;
+    const int min_start = i;
+    while (i < pattern.length() && pattern.at(i).isDigit())
+        i++;
+    if (i == min_start || i >= pattern.length())
+        return -1;
+
+    if (pattern.at(i) == QLatin1Char(',')) {
+        i++;
+        while (i < pattern.length() && pattern.at(i).isDigit())
+            i++;
+        if (i >= pattern.length())
+            return -1;
+    }
+
+    return pattern.at(i) == QLatin1Char('}') ? i : -1;
+}
+
+/// Returns a text that appears in every match of the regular expression, or an
+/// empty string if there is no such text that could be found easily
+QString regex_required_literal(const QRegularExpression& regex)
+{
+    const QString pattern = regex.pattern();
+
+    // alternatives, inline options and quoting could change the meaning of any part
+    const auto unsupported_options = QRegularExpression::CaseInsensitiveOption
+                                       | QRegularExpression::ExtendedPatternSyntaxOption;
+    if ((regex.patternOptions() & unsupported_options)
+        || pattern.contains(QLatin1Char('|'))
+        || pattern.contains(QLatin1String("(?"))
+        || pattern.contains(QLatin1String("\\Q"))
+        || pattern.contains(QLatin1String("[:")))
+        return QString();
+
+    QString longest;
+    QString current;
+    const auto end_run = [&]{
+        if (current.length() > longest.length())
+            longest = current;
+        current.clear();
+    };
+    const auto is_quantifier = [&pattern](int i){
+        return i < pattern.length()
+            && (pattern.at(i) == QLatin1Char('?')
+                || pattern.at(i) == QLatin1Char('*')
+                || pattern.at(i) == QLatin1Char('{'));
+    };
+
+    int depth = 0;
+    for (int i = 0; i < pattern.length(); i++) {
+        QChar c = pattern.at(i);
+
+        if (c == QLatin1Char('(') || c == QLatin1Char(')')) {
+            end_run();
+            depth += c == QLatin1Char('(') ? 1 : -1;
+            if (depth < 0)
+                return QString();
+            continue;
+        }
+        if (c == QLatin1Char('[')) {
+            end_run();
+            // skip the set, where a leading `]` is a literal
+            int j = i + 1;
+            if (j < pattern.length() && pattern.at(j) == QLatin1Char('^'))
+                j++;
+            if (j < pattern.length() && pattern.at(j) == QLatin1Char(']'))
+                j++;
+            while (j < pattern.length() && pattern.at(j) != QLatin1Char(']'))
+                j += pattern.at(j) == QLatin1Char('\\') ? 2 : 1;
+            if (j >= pattern.length())
+                return QString();
+            i = j;
+            continue;
+        }
+        if (c == QLatin1Char('{')) {
+            // the character before the quantifier was already left out by
+            // `is_quantifier`; a brace that is not a quantifier is not
+            // worth guessing about
+            const int end = regex_quantifier_end(pattern, i);
+            if (end < 0)
+                return QString();
+
+            end_run();
+            i = end;
+            continue;
+        }
+        if (c == QLatin1Char('\\')) {
+            if (i + 1 >= pattern.length())
+                return QString();
+
+            // escapes with arguments (code points, control characters, references,
+            // properties) can't be skipped reliably, as the arguments can be of any length
+            c = pattern.at(++i);
+            if (c.isDigit() || QStringLiteral("xcgkNpPo").contains(c))
+                return QString();
+
+            // the other escaped letters are classes or assertions
+            if (c.isLetterOrNumber()) {
+                end_run();
+                continue;
+            }
+        }
+        else if (QStringLiteral(".^$*+?").contains(c)) {
+            end_run();
+            continue;
+        }
+
+        if (depth > 0)
+            continue;
+
+        // an optional character can't be part of the required text
+        if (is_quantifier(i + 1)) {
+            end_run();
+            continue;
+        }
+
+        current += c;
+        if (i + 1 < pattern.length() && pattern.at(i + 1) == QLatin1Char('+'))
+            end_run();
+    }
+    end_run();
+    if (depth != 0)
+        return QString();
+
+    return longest.length() >= 2 ? longest : QString();
+}
+} // namespace
+
+
+namespace providers {
+namespace pegasus {
+
+void StringRefSet::insert(const QString& str)
+{
+    if (contains(QStringRef(&str)))
+        return;
+
+    // qHash gives the same value for a string and a reference with the same content
+    m_index.insert(qHash(str), m_items.count());
+    m_items.append(str);
+}
+
+bool StringRefSet::contains(const QStringRef& str) const
+{
+    const uint hash = qHash(str);
+    for (auto it = m_index.constFind(hash); it != m_index.cend() && it.key() == hash; ++it) {
+        if (m_items.at(it.value()) == str)
+            return true;
+    }
+    return false;
+}
+
+
+GameFilterGroup::GameFilterGroup()
+    : m_has_file_globs(false)
+    , m_has_regex(false)
+    , m_compiled(false)
+{}
+
+void GameFilterGroup::compile()
+{
+    m_extension_set = StringRefSet();
+    for (const QString& ext : qAsConst(extensions))
+        m_extension_set.insert(ext);
+
+    m_file_set = StringRefSet();
+    m_glob_tails.clear();
+    QStringList glob_patterns;
+    bool all_globs_have_tail = true;
+    // names with tags like `Game (USA) [b1].zip` are common,
+    // so the plain file entries are never treated as patterns
+    for (const QString& file : qAsConst(files))
+        m_file_set.insert(file);
+
+    for (const QString& glob : qAsConst(file_globs)) {
+        const QString pattern = glob_to_regex(glob);
+        if (!QRegularExpression(pattern).isValid()) {
+            qWarning().noquote() << MSG_PREFIX
+                << tr_log("the file pattern `%1` is not valid, ignored").arg(glob);
+            continue;
+        }
+        glob_patterns.append(pattern);
+
+        const QString tail = glob_literal_tail(glob);
+        all_globs_have_tail &= !tail.isEmpty();
+        m_glob_tails.append(tail);
+    }
+    if (!all_globs_have_tail)
+        m_glob_tails.clear();
+
+    m_has_file_globs = !glob_patterns.isEmpty();
+    if (m_has_file_globs) {
+        m_file_globs.setPattern(QStringLiteral("^(?:") + glob_patterns.join(QLatin1Char('|')) + QStringLiteral(")$"));
+        m_file_globs.optimize();
+    }
+
+    m_has_regex = !regex.pattern().isEmpty();
+    m_regex_literal.clear();
+    if (m_has_regex) {
+        m_regex_literal = regex_required_literal(regex);
+        regex.optimize();
+    }
+
+    m_compiled = true;
+}
+
+bool GameFilterGroup::matches(const QStringRef& suffix, const QStringRef& relative_path, const QString& path) const
+{
+    Q_ASSERT(m_compiled);
+
+    if (m_extension_set.contains(suffix) || m_file_set.contains(relative_path))
+        return true;
+
+    if (m_has_file_globs && globTailMatches(relative_path) && m_file_globs.match(relative_path).hasMatch())
+        return true;
+
+    if (!m_has_regex)
+        return false;
+    if (!m_regex_literal.isEmpty() && !path.contains(m_regex_literal))
+        return false;
+
+    return regex.match(path).hasMatch();
+}
+
+bool GameFilterGroup::globTailMatches(const QStringRef& relative_path) const
+{
+    if (m_glob_tails.isEmpty())
+        return true;
+
+    for (const QString& tail : m_glob_tails) {
+        if (relative_path.endsWith(tail))
+            return true;
+    }
+    return false;
+}
+
+
+GameFilter::GameFilter(QString parent, QString base_dir)
+    : parent_collection(std::move(parent))
+    , directories(std::move(base_dir))
+{}
+
+void GameFilter::compile()
+{
+    include.compile();
+    exclude.compile();
+}
+
+bool GameFilter::accepts(const QString& filter_dir, const QString& path, const QStringRef& suffix) const
+{
+    const QStringRef relative_path = path.midRef(filter_dir.length() + 1);
+
+    return !exclude.matches(suffix, relative_path, path)
+        && include.matches(suffix, relative_path, path);
+}
+
+} // namespace pegasus
+} // namespace providers
@@ -0,0 +1,94 @@
+// Pegasus Frontend
+// Copyright (C) 2018  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <QMultiHash>
+#include <QRegularExpression>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+
+namespace providers {
+namespace pegasus {
+
+/// A set of strings that can be searched with string references, so the
+/// per-file lookups don't have to allocate new strings
+class StringRefSet {
+public:
+    void insert(const QString&);
+    bool contains(const QStringRef&) const;
+    bool isEmpty() const { return m_items.isEmpty(); }
+
+private:
+    QVector<QString> m_items;
+    QMultiHash<uint, int> m_index;
+};
+
+
+struct GameFilterGroup {
+    QStringList extensions;
+    /// Relative paths, matched exactly
+    QStringList files;
+    /// Relative glob patterns (`*`, `?`, `[...]`, and `**` for any subdirectory);
+    /// brackets that don't form a valid set are matched literally
+    QStringList file_globs;
+    QRegularExpression regex;
+
+    GameFilterGroup();
+
+    /// Prepares the rules for matching; has to be called after the rules above are changed
+    void compile();
+    /// True if the file is matched by any of the rules of this group
+    bool matches(const QStringRef& suffix, const QStringRef& relative_path, const QString& path) const;
+
+private:
+    StringRefSet m_extension_set;
+    StringRefSet m_file_set;
+    /// All the valid patterns of `file_globs`, in a single expression
+    QRegularExpression m_file_globs;
+    /// A text that every match of `regex` contains, to skip most of the regex calls
+    QString m_regex_literal;
+    /// The texts the globs end with, to skip most of the glob matching;
+    /// empty if a glob ends with a wildcard
+    QStringList m_glob_tails;
+    bool m_has_file_globs;
+    bool m_has_regex;
+    bool m_compiled;
+
+    bool globTailMatches(const QStringRef& relative_path) const;
+};
+
+struct GameFilter {
+    QString parent_collection;
+    QStringList directories;
+    GameFilterGroup include;
+    GameFilterGroup exclude;
+    QStringList extra;
+
+    GameFilter(QString parent, QString base_dir);
+
+    /// Prepares the filter for matching, after all the rules have been read
+    void compile();
+    /// True if the file, found under the filter directory `filter_dir`,
+    /// should be added to the parent collection
+    bool accepts(const QString& filter_dir, const QString& path, const QStringRef& suffix) const;
+};
+
+} // namespace pegasus
+} // namespace providers
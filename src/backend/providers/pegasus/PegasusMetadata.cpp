@@ -22,62 +22,49 @@
 #include "Paths.h"
 #include "PegasusAssets.h"
 #include "PegasusCommon.h"
+#include "filesystem/DirCache.h"
 #include "modeldata/gaming/GameData.h"
+#include "modeldata/gaming/GameStore.h"
+#include "providers/AssetResolver.h"
+#include "providers/MediaRoots.h"
 #include "utils/PathCheck.h"
 
 #include <QDebug>
 #include <QDir>
-#include <QDirIterator>
-#include <QFileInfo>
 #include <QStringBuilder>
 
 
 namespace {
 
-AssetType detect_asset_type(const QString& basename, const QString& ext)
+void find_assets(const std::vector<QString>& dir_list, modeldata::GameStore& games)
 {
-    const AssetType type = pegasus_assets::str_to_type(basename);
-    if (pegasus_assets::allowed_asset_exts(type).contains(ext))
-        return type;
-
-    return AssetType::UNKNOWN;
-}
-
-void find_assets(const std::vector<QString>& dir_list, HashMap<QString, modeldata::Game>& games)
-{
-    // shortpath: canonical path to dir + extensionless filename
-    HashMap<QString, modeldata::Game*> games_by_shortpath;
-    games_by_shortpath.reserve(games.size());
-    for (auto& pair : games) {
-        QString shortpath = pair.second.fileinfo().canonicalPath()
-                          % '/'
-                          % pair.second.fileinfo().completeBaseName();
-        games_by_shortpath.emplace(std::move(shortpath), &pair.second);
-    }
-
-
-    constexpr auto dir_filters = QDir::Files | QDir::Readable | QDir::NoDotAndDotDot;
-    constexpr auto dir_flags = QDirIterator::Subdirectories | QDirIterator::FollowSymlinks;
-
-    for (const QString& dir_base : dir_list) {
-        const QString media_dir = dir_base + QStringLiteral("/media");
-
-        QDirIterator dir_it(media_dir, dir_filters, dir_flags);
-        while (dir_it.hasNext()) {
-            dir_it.next();
-            const QFileInfo fileinfo = dir_it.fileInfo();
-
-            const QString shortpath = fileinfo.canonicalPath().remove(dir_base.length(), 6); // len of `/media`
-            if (!games_by_shortpath.count(shortpath))
-                continue;
-
-            const AssetType asset_type = detect_asset_type(fileinfo.completeBaseName(), fileinfo.suffix());
-            if (asset_type == AssetType::UNKNOWN)
-                continue;
-
-            modeldata::Game* const game = games_by_shortpath[shortpath];
-            game->assets.addFileMaybe(asset_type, dir_it.filePath());
-        }
+    providers::AssetResolver resolver(games);
+    filesystem::DirCache& dir_cache = filesystem::dir_cache();
+
+    QStringList media_dirs;
+    for (const QString& dir_base : dir_list)
+        media_dirs.append(dir_base + QStringLiteral("/media"));
+    dir_cache.prefetch(media_dirs);
+
+    for (size_t i = 0; i < dir_list.size(); i++) {
+        // `media/<sub path>/<game basename>/` contains the assets of the game
+        // in `<sub path>`, in files named after the asset types
+        resolver.forEachMirroredDir(dir_list[i], media_dirs.at(static_cast<int>(i)),
+            [&resolver](const QString& game_path, const QString& dir_path, const filesystem::DirListing& listing){
+                const int last_sep = game_path.lastIndexOf(QLatin1Char('/'));
+                const auto dir_games = resolver.findDir(game_path.left(last_sep));
+                const modeldata::GameId game_id = providers::AssetResolver::findGame(dir_games, game_path.midRef(last_sep + 1));
+                if (game_id == modeldata::INVALID_GAMEID)
+                    return;
+
+                for (const filesystem::DirEntry& entry : listing.entries) {
+                    if (entry.is_dir)
+                        continue;
+
+                    const AssetType asset_type = providers::AssetResolver::typeByName(entry.completeBaseNameRef(), entry.suffixRef());
+                    resolver.addFile(game_id, asset_type, dir_path, entry.name);
+                }
+            });
     }
 }
 
@@ -130,19 +117,29 @@ PegasusMetadata::PegasusMetadata()
 }
 
 void PegasusMetadata::enhance_in_dirs(const std::vector<QString>& dir_list,
-                                      HashMap<QString, modeldata::Game>& games,
+                                      modeldata::GameStore& games,
                                       const HashMap<QString, modeldata::Collection>&,
-                                      const HashMap<QString, std::vector<QString>>&) const
+                                      const HashMap<QString, std::vector<modeldata::GameId>>&) const
+{
+    for (const QString& dir_path : dir_list)
+        read_metadata_file(dir_path, games);
+}
+
+void PegasusMetadata::find_assets_in_dirs(const std::vector<QString>& dir_list,
+                                          modeldata::GameStore& games) const
 {
     find_assets(dir_list, games);
+}
 
+void PegasusMetadata::find_media_roots(const std::vector<QString>& dir_list, MediaRoots& media_roots) const
+{
     for (const QString& dir_path : dir_list)
-        read_metadata_file(dir_path, games);
+        media_roots.addNamedRoot(dir_path, dir_path + QStringLiteral("/media"));
 }
 
 
 void PegasusMetadata::read_metadata_file(const QString& dir_path,
-                                         HashMap<QString, modeldata::Game>& games) const
+                                         modeldata::GameStore& games) const
 {
     static constexpr auto MSG_PREFIX = "Collections:";
     const QRegularExpression rx_asset_key(QStringLiteral(R"(^assets?\.(.+)$)"));
@@ -156,20 +153,22 @@ void PegasusMetadata::read_metadata_file(const QString& dir_path,
     };
     const auto on_attribute = [&](const int lineno, const QString key, const QString val){
         if (key == QLatin1String("file")) {
-            QFileInfo finfo(val);
-            if (finfo.isRelative())
-                finfo.setFile(dir_path % '/' % val);
+            const QString file_path = QDir::isRelativePath(val)
+                ? QString(dir_path % '/' % val)
+                : val;
 
             curr_game = nullptr;
 
-            const auto it = games.find(finfo.canonicalFilePath());
-            if (it == games.cend()) {
+            // the directories of the games were already read during the scan
+            const QString game_key = filesystem::dir_cache().canonicalFilePath(file_path);
+            const modeldata::GameId game_id = games.find(game_key);
+            if (game_id == modeldata::INVALID_GAMEID) {
                 on_error(lineno,
                     tr_log("the game `%1` is either missing or excluded, values for it will be ignored").arg(val));
                 return;
             }
 
-            curr_game = &it->second;
+            curr_game = &games.at(game_id);
             return;
         }
         if (!curr_game) {
@@ -26,6 +26,8 @@
 
 
 namespace providers {
+class MediaRoots;
+
 namespace pegasus {
 
 enum class MetaAttribType : unsigned char;
@@ -35,9 +37,13 @@ public:
     PegasusMetadata();
 
     void enhance_in_dirs(const std::vector<QString>&,
-                         HashMap<QString, modeldata::Game>&,
+                         modeldata::GameStore&,
                          const HashMap<QString, modeldata::Collection>&,
-                         const HashMap<QString, std::vector<QString>>&) const;
+                         const HashMap<QString, std::vector<modeldata::GameId>>&) const;
+    /// Searches the `media` directories of the game directories for assets
+    void find_assets_in_dirs(const std::vector<QString>&, modeldata::GameStore&) const;
+    /// For the lazy asset lookup: only adds the existing `media` directories
+    void find_media_roots(const std::vector<QString>&, MediaRoots&) const;
 
 private:
     const HashMap<QString, MetaAttribType> m_key_types;
@@ -46,7 +52,7 @@ private:
     const QRegularExpression m_rating_float_regex;
     const QRegularExpression m_release_regex;
 
-    void read_metadata_file(const QString&, HashMap<QString, modeldata::Game>&) const;
+    void read_metadata_file(const QString&, modeldata::GameStore&) const;
 };
 
 } // namespace pegasus
@@ -25,6 +25,7 @@
 #include <QFile>
 #include <QFileInfo>
 #include <QTextStream>
+#include <algorithm>
 
 
 namespace {
@@ -67,20 +68,52 @@ PegasusProvider::PegasusProvider(std::vector<QString> game_dirs, QObject* parent
     , m_game_dirs(std::move(game_dirs))
 {}
 
-void PegasusProvider::findLists(HashMap<QString, modeldata::Game>& games,
+void PegasusProvider::findLists(modeldata::GameStore& games,
                                 HashMap<QString, modeldata::Collection>& collections,
-                                HashMap<QString, std::vector<QString>>& collection_childs)
+                                HashMap<QString, std::vector<modeldata::GameId>>& collection_childs)
 {
-    collection_finder.find_in_dirs(m_game_dirs, games, collections, collection_childs,
-                                   [this](int game_count){ emit gameCountChanged(game_count); });
+    m_filters = collection_finder.find_in_dirs(m_game_dirs, games, collections, collection_childs,
+                                               [this](int game_count){ emit gameCountChanged(game_count); });
 }
 
-void PegasusProvider::findStaticData(HashMap<QString, modeldata::Game>& games,
+std::vector<QString> PegasusProvider::collectionOrder() const
+{
+    // the filters were processed in this order
+    std::vector<QString> order;
+    for (const GameFilter& filter : m_filters) {
+        if (std::find(order.cbegin(), order.cend(), filter.parent_collection) == order.cend())
+            order.push_back(filter.parent_collection);
+    }
+    return order;
+}
+
+void PegasusProvider::findStaticData(modeldata::GameStore& games,
                                      const HashMap<QString, modeldata::Collection>& collections,
-                                     const HashMap<QString, std::vector<QString>>& collection_childs)
+                                     const HashMap<QString, std::vector<modeldata::GameId>>& collection_childs)
 {
+    // the files found in the media directories take priority over the ones in the metadata files
+    if (!lazyAssets())
+        metadata_finder.find_assets_in_dirs(m_game_dirs, games);
+
     metadata_finder.enhance_in_dirs(m_game_dirs, games, collections, collection_childs);
 }
 
+void PegasusProvider::findMediaRoots(MediaRoots& media_roots) const
+{
+    metadata_finder.find_media_roots(m_game_dirs, media_roots);
+}
+
+QStringList PegasusProvider::watchedDirs() const
+{
+    return collection_finder.watched_dirs(m_filters);
+}
+
+void PegasusProvider::findGamesInDir(const QString& dir_path,
+                                     modeldata::GameStore& games,
+                                     HashMap<QString, std::vector<modeldata::GameId>>& collection_childs)
+{
+    collection_finder.find_in_changed_dir(m_filters, dir_path, games, collection_childs);
+}
+
 } // namespace pegasus
 } // namespace providers
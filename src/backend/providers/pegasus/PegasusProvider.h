@@ -34,17 +34,29 @@ public:
     explicit PegasusProvider(QObject* parent = nullptr);
     explicit PegasusProvider(std::vector<QString> game_dirs, QObject* parent = nullptr);
 
-    void findLists(HashMap<QString, modeldata::Game>&,
+    void findLists(modeldata::GameStore&,
                    HashMap<QString, modeldata::Collection>&,
-                   HashMap<QString, std::vector<QString>>&) final;
-    void findStaticData(HashMap<QString, modeldata::Game>&,
+                   HashMap<QString, std::vector<modeldata::GameId>>&) final;
+    void findStaticData(modeldata::GameStore&,
                         const HashMap<QString, modeldata::Collection>&,
-                        const HashMap<QString, std::vector<QString>>&) final;
+                        const HashMap<QString, std::vector<modeldata::GameId>>&) final;
+    void findMediaRoots(MediaRoots&) const final;
+
+    StageAccess listsAccess() const final { return { NO_DATA, GAME_LIST }; }
+    std::vector<QString> collectionOrder() const final;
+    StageAccess staticDataAccess() const final { return { GAME_LIST, GAME_METADATA | GAME_ASSETS }; }
+
+    QStringList watchedDirs() const final;
+    void findGamesInDir(const QString&,
+                        modeldata::GameStore&,
+                        HashMap<QString, std::vector<modeldata::GameId>>&) final;
 
 private:
     const std::vector<QString> m_game_dirs;
     const PegasusCollections collection_finder;
     const PegasusMetadata metadata_finder;
+
+    std::vector<GameFilter> m_filters;
 };
 
 } // namespace pegasus
@@ -19,7 +19,8 @@
 
 #include "LocaleUtils.h"
 #include "Paths.h"
-#include "model/gaming/Game.h"
+#include "model/gaming/GameLibrary.h"
+#include "providers/ModelSync.h"
 
 #include <QDebug>
 #include <QFile>
@@ -51,9 +52,8 @@ Favorites::Favorites(QString db_path, QObject* parent)
     , m_db_path(std::move(db_path))
 {}
 
-void Favorites::findDynamicData(const QVector<model::Game*>&,
-                                const QVector<model::Collection*>&,
-                                const HashMap<QString, model::Game*>& modelgame_map)
+void Favorites::findDynamicData(sync::DynamicData& dynamic_data,
+                                const HashMap<QString, model::GameSlot>& slot_map)
 {
     if (!QFileInfo::exists(m_db_path))
         return;
@@ -72,20 +72,23 @@ void Favorites::findDynamicData(const QVector<model::Game*>&,
         if (line.startsWith('#'))
             continue;
 
-        if (modelgame_map.count(line))
-            modelgame_map.at(line)->setFavorite(true);
+        const auto it = slot_map.find(line);
+        if (it != slot_map.cend())
+            dynamic_data.favorites.push_back(it->second);
     }
 }
 
-void Favorites::onGameFavoriteChanged(const QVector<model::Game*>& game_list)
+void Favorites::onGameFavoriteChanged(const model::GameLibrary& game_library,
+                                      const QVector<model::GameSlot>& game_list)
 {
     QMutexLocker lock(&m_task_guard);
 
     m_pending_task.clear();
     m_pending_task << QStringLiteral("# List of favorites, one path per line");
-    for (const model::Game* const game : game_list) {
-        if (game->data().is_favorite)
-            m_pending_task << game->data().fileinfo().canonicalFilePath();
+    for (const model::GameSlot slot : game_list) {
+        const modeldata::Game& game = game_library.at(slot);
+        if (game.is_favorite)
+            m_pending_task << game.path().canonicalFilePath();
     }
 
     if (m_active_task.isEmpty())
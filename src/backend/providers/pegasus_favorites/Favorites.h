@@ -32,10 +32,11 @@ public:
     explicit Favorites(QObject* parent = nullptr);
     explicit Favorites(QString db_path, QObject* parent = nullptr);
 
-    void findDynamicData(const QVector<model::Game*>&,
-                         const QVector<model::Collection*>&,
-                         const HashMap<QString, model::Game*>&) final;
-    void onGameFavoriteChanged(const QVector<model::Game*>&) final;
+    void findDynamicData(sync::DynamicData&,
+                         const HashMap<QString, model::GameSlot>&) final;
+    StageAccess listsAccess() const final { return { NO_DATA, NO_DATA }; }
+    StageAccess staticDataAccess() const final { return { NO_DATA, NO_DATA }; }
+    void onGameFavoriteChanged(const model::GameLibrary&, const QVector<model::GameSlot>&) final;
 
 signals:
     void startedWriting();
@@ -19,7 +19,8 @@
 
 #include "LocaleUtils.h"
 #include "Paths.h"
-#include "model/gaming/Game.h"
+#include "model/gaming/GameLibrary.h"
+#include "providers/ModelSync.h"
 
 #include <QDebug>
 #include <QFileInfo>
@@ -169,13 +170,6 @@ void save_play_entry(const int path_id, const QDateTime& start_time, const qint6
         print_query_error(query);
 }
 
-void update_modelgame(model::Game* const game, const QDateTime& start_time, const qint64 duration)
-{
-    Q_ASSERT(game);
-
-    game->updatePlayStats(duration, start_time.addSecs(duration));
-}
-
 } // namespace
 
 
@@ -191,9 +185,8 @@ PlaytimeStats::PlaytimeStats(QString db_path, QObject* parent)
     , m_db_path(std::move(db_path))
 {}
 
-void PlaytimeStats::findDynamicData(const QVector<model::Game*>&,
-                                    const QVector<model::Collection*>&,
-                                    const HashMap<QString, model::Game*>& modelgame_map)
+void PlaytimeStats::findDynamicData(sync::DynamicData& dynamic_data,
+                                    const HashMap<QString, model::GameSlot>& slot_map)
 {
     if (!QFileInfo::exists(m_db_path))
         return;
@@ -230,7 +223,7 @@ void PlaytimeStats::findDynamicData(const QVector<model::Game*>&,
 
     while (query.next()) {
         const QString path = query.value(0).toString();
-        if (!modelgame_map.count(path))
+        if (!slot_map.count(path))
             continue;
 
         const qint64 start_epoch = query.value(1).toLongLong();
@@ -242,31 +235,33 @@ void PlaytimeStats::findDynamicData(const QVector<model::Game*>&,
         stats.playcount++;
     }
     // trigger update only once
+    dynamic_data.play_stats.reserve(dynamic_data.play_stats.size() + stat_map.size());
     for (const auto& pair : stat_map) {
-        model::Game* game = modelgame_map.at(pair.first);
-        const Stats& stats = stat_map.at(pair.first);
-        game->addPlayStats(stats.playcount, stats.playtime, stats.last_played);
+        const model::GameSlot slot = slot_map.at(pair.first);
+        const Stats& stats = pair.second;
+        dynamic_data.play_stats.push_back({ slot, stats.playcount, stats.playtime, stats.last_played });
     }
 }
 
-void PlaytimeStats::onGameLaunched(model::Game* const game)
+void PlaytimeStats::onGameLaunched(model::GameLibrary&, const model::GameSlot)
 {
-    Q_ASSERT(game);
     m_last_launch_time = QDateTime::currentDateTimeUtc();
 }
 
-void PlaytimeStats::onGameFinished(model::Game* const game)
+void PlaytimeStats::onGameFinished(model::GameLibrary& game_library, const model::GameSlot slot)
 {
-    Q_ASSERT(game);
     Q_ASSERT(m_last_launch_time.isValid());
 
-    QMutexLocker lock(&m_queue_guard);
-
     const auto now = QDateTime::currentDateTimeUtc();
     const auto duration = m_last_launch_time.secsTo(now);
 
+    // the library may change during the writing, so it's updated here, on its own thread
+    game_library.updatePlayStats(slot, duration, m_last_launch_time.addSecs(duration));
+
+    QMutexLocker lock(&m_queue_guard);
+
     m_pending_tasks.emplace_back(
-        game,
+        game_library.at(slot).path().canonicalFilePath(),
         m_last_launch_time,
         duration
     );
@@ -299,12 +294,11 @@ void PlaytimeStats::start_processing()
                 break;
 
             for (const QueueEntry& entry : m_active_tasks) {
-                const int path_id = get_path_id(entry.game->data().fileinfo().canonicalFilePath());
+                const int path_id = get_path_id(entry.path);
                 if (path_id == -1)
                     continue;
 
                 save_play_entry(path_id, entry.launch_time, entry.duration);
-                update_modelgame(entry.game, entry.launch_time, entry.duration);
             }
 
             channel.commit();
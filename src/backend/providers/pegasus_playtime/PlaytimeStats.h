@@ -33,11 +33,12 @@ public:
     explicit PlaytimeStats(QObject* parent = nullptr);
     explicit PlaytimeStats(QString db_path, QObject* parent = nullptr);
 
-    void findDynamicData(const QVector<model::Game*>&,
-                         const QVector<model::Collection*>&,
-                         const HashMap<QString, model::Game*>&) final;
-    void onGameLaunched(model::Game* const) final;
-    void onGameFinished(model::Game* const) final;
+    void findDynamicData(sync::DynamicData&,
+                         const HashMap<QString, model::GameSlot>&) final;
+    StageAccess listsAccess() const final { return { NO_DATA, NO_DATA }; }
+    StageAccess staticDataAccess() const final { return { NO_DATA, NO_DATA }; }
+    void onGameLaunched(model::GameLibrary&, const model::GameSlot) final;
+    void onGameFinished(model::GameLibrary&, const model::GameSlot) final;
 
 signals:
     void startedWriting();
@@ -49,12 +50,12 @@ private:
     QDateTime m_last_launch_time;
 
     struct QueueEntry {
-        model::Game* const game;
+        const QString path;
         const QDateTime launch_time;
         const qint64 duration;
 
-        QueueEntry(model::Game* const game, QDateTime launch_time, qint64 duration)
-            : game(std::move(game))
+        QueueEntry(QString path, QDateTime launch_time, qint64 duration)
+            : path(std::move(path))
             , launch_time(std::move(launch_time))
             , duration(std::move(duration))
         {}
@@ -1,18 +1,28 @@
 HEADERS += \
+    $$PWD/AssetResolver.h \
+    $$PWD/LibrarySnapshot.h \
+    $$PWD/MediaRoots.h \
+    $$PWD/ModelSync.h \
     $$PWD/Provider.h \
     $$PWD/ProviderManager.h \
     $$PWD/pegasus/PegasusCollections.h \
     $$PWD/pegasus/PegasusCommon.h \
+    $$PWD/pegasus/PegasusFilter.h \
     $$PWD/pegasus/PegasusMetadata.h \
     $$PWD/pegasus/PegasusProvider.h \
     $$PWD/pegasus_favorites/Favorites.h \
     $$PWD/pegasus_playtime/PlaytimeStats.h \
 
 SOURCES += \
+    $$PWD/AssetResolver.cpp \
+    $$PWD/LibrarySnapshot.cpp \
+    $$PWD/MediaRoots.cpp \
+    $$PWD/ModelSync.cpp \
     $$PWD/Provider.cpp \
     $$PWD/ProviderManager.cpp \
     $$PWD/pegasus/PegasusCollections.cpp \
     $$PWD/pegasus/PegasusCommon.cpp \
+    $$PWD/pegasus/PegasusFilter.cpp \
     $$PWD/pegasus/PegasusMetadata.cpp \
     $$PWD/pegasus/PegasusProvider.cpp \
     $$PWD/pegasus_favorites/Favorites.cpp \
@@ -19,10 +19,14 @@
 
 #include "AppSettings.h"
 #include "LocaleUtils.h"
+#include "filesystem/DirCache.h"
 #include "modeldata/gaming/GameData.h"
+#include "modeldata/gaming/GameStore.h"
+#include "providers/AssetResolver.h"
+#include "providers/MediaRoots.h"
 
 #include <QDebug>
-#include <QDirIterator>
+#include <QFileInfo>
 #include <QStringBuilder>
 
 
@@ -39,20 +43,6 @@ std::vector<QString> get_game_dirs()
 
     return game_dirs;
 }
-
-HashMap<QString, modeldata::Game* const> build_gamepath_db(HashMap<QString, modeldata::Game>& games)
-{
-    HashMap<QString, modeldata::Game* const> map;
-
-    for (auto& pair : games) {
-        const QFileInfo& finfo = pair.second.fileinfo();
-
-        QString path = finfo.canonicalPath() % '/' % finfo.completeBaseName();
-        map.emplace(std::move(path), &pair.second);
-    }
-
-    return map;
-}
 } // namespace
 
 
@@ -92,49 +82,70 @@ SkraperAssetsProvider::SkraperAssetsProvider(QObject* parent)
     }
 {}
 
-void SkraperAssetsProvider::findStaticData(HashMap<QString, modeldata::Game>& games,
+void SkraperAssetsProvider::findStaticData(modeldata::GameStore& games,
                                            const HashMap<QString, modeldata::Collection>&,
-                                           const HashMap<QString, std::vector<QString>>&)
+                                           const HashMap<QString, std::vector<modeldata::GameId>>&)
 {
+    // the media directories are recorded in findMediaRoots instead
+    if (lazyAssets())
+        return;
+
     qInfo().noquote() << tr_log("Skraper: Looking for assets...");
-    unsigned found_assets_cnt = 0;
 
     const std::vector<QString> game_dirs = get_game_dirs();
-    const HashMap<QString, modeldata::Game* const> extless_path_to_game = build_gamepath_db(games);
+    AssetResolver resolver(games);
 
-    constexpr auto dir_filters = QDir::Files | QDir::Readable | QDir::NoDotAndDotDot;
-    constexpr auto dir_flags = QDirIterator::Subdirectories | QDirIterator::FollowSymlinks;
+    filesystem::DirCache& dir_cache = filesystem::dir_cache();
 
+    QStringList game_media_dirs;
+    for (const QString& game_dir : game_dirs) {
+        for (const QString& media_dir : m_media_dirs) {
+            QString game_media_dir = game_dir % media_dir;
+            if (QFileInfo::exists(game_media_dir))
+                game_media_dirs.append(std::move(game_media_dir));
+        }
+    }
+    // all media directories are read in parallel, then walked in order below
+    dir_cache.prefetch(game_media_dirs);
 
     for (const QString& game_dir : game_dirs) {
         for (const QString& media_dir : m_media_dirs) {
             const QString game_media_dir = game_dir % media_dir;
-            if (!QFileInfo::exists(game_media_dir))
+            if (!game_media_dirs.contains(game_media_dir))
                 continue;
 
             for (const SkraperDir& asset_dir : m_asset_dirs) {
-                const QString search_dir = game_media_dir % asset_dir.dir_name;
-                const int subpath_len = media_dir.length() + asset_dir.dir_name.length();
-
-                QDirIterator dir_it(search_dir, dir_filters, dir_flags);
-                while (dir_it.hasNext()) {
-                    dir_it.next();
-                    const QFileInfo finfo = dir_it.fileInfo();
-
-                    const QString game_path = finfo.canonicalPath().remove(game_dir.length(), subpath_len)
-                                            % '/' % finfo.completeBaseName();
-                    if (!extless_path_to_game.count(game_path))
-                        continue;
-
-                    modeldata::Game* const game = extless_path_to_game.at(game_path);
-                    game->assets.addFileMaybe(asset_dir.asset_type, dir_it.filePath());
-                    found_assets_cnt++;
-                }
+                // `<asset dir>/<sub path>/` contains the assets of the games in `<sub path>`,
+                // in files named after the games
+                resolver.forEachMirroredDir(game_dir, QString(game_media_dir % asset_dir.dir_name),
+                    [&resolver, &asset_dir](const QString& game_dir_path, const QString& dir_path, const filesystem::DirListing& listing){
+                        const auto dir_games = resolver.findDir(game_dir_path);
+                        if (!dir_games)
+                            return;
+
+                        for (const filesystem::DirEntry& entry : listing.entries) {
+                            if (entry.is_dir)
+                                continue;
+
+                            const modeldata::GameId game_id = AssetResolver::findGame(dir_games, entry.completeBaseNameRef());
+                            resolver.addFile(game_id, asset_dir.asset_type, dir_path, entry.name);
+                        }
+                    });
             }
         }
     }
 
-    qInfo().noquote() << tr_log("Skraper: %1 assets found").arg(found_assets_cnt);
+    qInfo().noquote() << tr_log("Skraper: %1 assets found").arg(resolver.addedCount());
+}
+
+void SkraperAssetsProvider::findMediaRoots(MediaRoots& media_roots) const
+{
+    for (const QString& game_dir : get_game_dirs()) {
+        for (const QString& media_dir : m_media_dirs) {
+            for (const SkraperDir& asset_dir : m_asset_dirs)
+                media_roots.addTypedRoot(game_dir, QString(game_dir % media_dir % asset_dir.dir_name), asset_dir.asset_type);
+        }
+    }
 }
 
 } // namespace skraper
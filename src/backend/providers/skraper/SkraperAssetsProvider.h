@@ -34,9 +34,13 @@ class SkraperAssetsProvider : public Provider {
 public:
     explicit SkraperAssetsProvider(QObject* parent = nullptr);
 
-    void findStaticData(HashMap<QString, modeldata::Game>&,
+    void findStaticData(modeldata::GameStore&,
                         const HashMap<QString, modeldata::Collection>&,
-                        const HashMap<QString, std::vector<QString>>&) final;
+                        const HashMap<QString, std::vector<modeldata::GameId>>&) final;
+    void findMediaRoots(MediaRoots&) const final;
+
+    StageAccess listsAccess() const final { return { NO_DATA, NO_DATA }; }
+    StageAccess staticDataAccess() const final { return { GAME_LIST, GAME_ASSETS }; }
 
 private:
     struct SkraperDir {
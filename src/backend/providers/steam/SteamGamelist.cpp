@@ -19,12 +19,13 @@
 
 #include "LocaleUtils.h"
 #include "Paths.h"
+#include "filesystem/DirCache.h"
 #include "modeldata/gaming/CollectionData.h"
 #include "modeldata/gaming/GameData.h"
+#include "modeldata/gaming/GameStore.h"
 
 #include <QDebug>
 #include <QDir>
-#include <QDirIterator>
 #include <QFileInfo>
 #include <QRegularExpression>
 #include <QSettings>
@@ -106,25 +107,30 @@ std::vector<QString> find_steam_installdirs(const QString& steam_datadir)
     return installdirs;
 }
 
-void register_appmanifests(HashMap<QString, modeldata::Game>& games,
-                           std::vector<QString>& childs,
+void register_appmanifests(modeldata::GameStore& games,
+                           std::vector<modeldata::GameId>& childs,
                            const std::vector<QString>& installdirs)
 {
-    const auto dir_filters = QDir::Files | QDir::Readable | QDir::NoDotAndDotDot;
-    const auto dir_flags = QDirIterator::FollowSymlinks;
-    const QStringList name_filters = { QStringLiteral("appmanifest_*.acf") };
+    filesystem::DirCache& dir_cache = filesystem::dir_cache();
 
     for (const QString& dir_path : installdirs) {
-        QDirIterator dir_it(dir_path, name_filters, dir_filters, dir_flags);
-        while (dir_it.hasNext()) {
-            dir_it.next();
-            QFileInfo fileinfo = dir_it.fileInfo();
-            const QString game_key = fileinfo.canonicalFilePath();
-
-            if (!games.count(game_key))
-                games.emplace(game_key, modeldata::Game(std::move(fileinfo)));
-
-            childs.emplace_back(game_key);
+        const filesystem::DirListing listing = dir_cache.list(dir_path);
+
+        for (const filesystem::DirEntry& entry : listing.entries) {
+            const bool is_manifest = !entry.is_dir
+                && entry.name.startsWith(QLatin1String("appmanifest_"))
+                && entry.name.endsWith(QLatin1String(".acf"));
+            if (!is_manifest)
+                continue;
+
+            QString game_key = listing.canonicalFilePath(entry);
+            modeldata::GameId game_id = games.find(game_key);
+            if (game_id == modeldata::INVALID_GAMEID) {
+                modeldata::Game game { modeldata::GamePath(dir_path, entry.name, game_key) };
+                game_id = games.add(std::move(game_key), std::move(game));
+            }
+
+            childs.push_back(game_id);
         }
     }
 }
@@ -139,9 +145,9 @@ Gamelist::Gamelist(QObject* parent)
     : QObject(parent)
 {}
 
-void Gamelist::find(HashMap<QString, modeldata::Game>& games,
+void Gamelist::find(modeldata::GameStore& games,
                     HashMap<QString, modeldata::Collection>& collections,
-                    HashMap<QString, std::vector<QString>>& collection_childs)
+                    HashMap<QString, std::vector<modeldata::GameId>>& collection_childs)
 {
     const QString steamdir = find_steam_datadir();
     if (steamdir.isEmpty())
@@ -160,7 +166,7 @@ void Gamelist::find(HashMap<QString, modeldata::Game>& games,
     modeldata::Collection& collection = collections.at(STEAM_TAG);
     collection.setShortName(STEAM_TAG);
 
-    std::vector<QString>& childs = collection_childs[STEAM_TAG];
+    std::vector<modeldata::GameId>& childs = collection_childs[STEAM_TAG];
 
 
     const size_t game_count_before = games.size();
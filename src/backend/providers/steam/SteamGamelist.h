@@ -32,9 +32,9 @@ class Gamelist : public QObject {
 public:
     explicit Gamelist(QObject* parent);
 
-    void find(HashMap<QString, modeldata::Game>& games,
+    void find(modeldata::GameStore& games,
               HashMap<QString, modeldata::Collection>& collections,
-              HashMap<QString, std::vector<QString>>& collection_childs);
+              HashMap<QString, std::vector<modeldata::GameId>>& collection_childs);
 
 signals:
     void gameCountChanged(int count);
@@ -21,6 +21,7 @@
 #include "Paths.h"
 #include "modeldata/gaming/CollectionData.h"
 #include "modeldata/gaming/GameData.h"
+#include "modeldata/gaming/GameStore.h"
 #include "providers/JsonCacheUtils.h"
 
 #include <QDebug>
@@ -301,25 +302,25 @@ Metadata::Metadata(QObject* parent)
     : QObject(parent)
 {}
 
-void Metadata::enhance(HashMap<QString, modeldata::Game>& games,
+void Metadata::enhance(modeldata::GameStore& games,
                        const HashMap<QString, modeldata::Collection>&,
-                       const HashMap<QString, std::vector<QString>>& collection_childs)
+                       const HashMap<QString, std::vector<modeldata::GameId>>& collection_childs)
 {
     const QString STEAM_TAG(QStringLiteral("Steam"));
     if (!collection_childs.count(STEAM_TAG))
         return;
 
-    const std::vector<QString>& childs = collection_childs.at(STEAM_TAG);
+    const std::vector<modeldata::GameId>& childs = collection_childs.at(STEAM_TAG);
     const QString steamexe = find_steam_exe();
 
     // try to fill using manifest files
 
     std::vector<SteamGameEntry> entries;
 
-    for (const QString& game_key : childs) {
-        modeldata::Game& game = games.at(game_key);
+    for (const modeldata::GameId game_id : childs) {
+        modeldata::Game& game = games.at(game_id);
 
-        SteamGameEntry entry = read_manifest(game.fileinfo().filePath());
+        SteamGameEntry entry = read_manifest(game.path().filePath());
         if (!entry.appid.isEmpty()) {
             if (entry.title.isEmpty())
                 entry.title = QLatin1String("App #") % entry.appid;
@@ -0,0 +1,107 @@
+// Pegasus Frontend
+// Copyright (C) 2018  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#include "Collation.h"
+
+#include <QCollator>
+#include <QFuture>
+#include <QThread>
+#include <QThreadStorage>
+#include <QtConcurrent/QtConcurrent>
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+
+
+namespace {
+// Below this, starting a new thread costs more than it saves
+constexpr size_t MIN_CHUNK_SIZE = 512;
+
+// QCollator instances should not be shared between threads
+const QCollator& thread_collator()
+{
+    static QThreadStorage<QCollator> collators;
+
+    QCollator& collator = collators.localData();
+    if (collator.locale() != QLocale())
+        collator.setLocale(QLocale());
+
+    return collator;
+}
+
+void fill_keys(const std::vector<QString>& texts, size_t begin, size_t end,
+               std::vector<QCollatorSortKey>& out)
+{
+    const QCollator& collator = thread_collator();
+
+    out.reserve(out.size() + (end - begin));
+    for (size_t i = begin; i < end; i++)
+        out.push_back(collator.sortKey(texts[i]));
+}
+} // namespace
+
+
+int collation_compare(const QString& a, const QString& b)
+{
+    return thread_collator().compare(a, b);
+}
+
+std::vector<QCollatorSortKey> collation_keys(const std::vector<QString>& texts)
+{
+    const size_t max_chunks = static_cast<size_t>(std::max(1, QThread::idealThreadCount()));
+    const size_t chunk_count = std::max<size_t>(1, std::min(max_chunks, texts.size() / MIN_CHUNK_SIZE));
+
+    std::vector<QCollatorSortKey> keys;
+    if (chunk_count == 1) {
+        fill_keys(texts, 0, texts.size(), keys);
+        return keys;
+    }
+
+    // the first chunk is done on the current thread
+    std::vector<std::vector<QCollatorSortKey>> chunk_keys(chunk_count);
+    std::vector<QFuture<void>> tasks;
+    tasks.reserve(chunk_count - 1);
+    for (size_t chunk = 1; chunk < chunk_count; chunk++) {
+        const size_t begin = texts.size() * chunk / chunk_count;
+        const size_t end = texts.size() * (chunk + 1) / chunk_count;
+        std::vector<QCollatorSortKey>& out = chunk_keys[chunk];
+        tasks.push_back(QtConcurrent::run([&texts, &out, begin, end]{
+            fill_keys(texts, begin, end, out);
+        }));
+    }
+    fill_keys(texts, 0, texts.size() / chunk_count, chunk_keys.front());
+    for (QFuture<void>& task : tasks)
+        task.waitForFinished();
+
+    keys.reserve(texts.size());
+    for (std::vector<QCollatorSortKey>& chunk : chunk_keys)
+        std::move(chunk.begin(), chunk.end(), std::back_inserter(keys));
+
+    return keys;
+}
+
+std::vector<size_t> collation_order(const std::vector<QCollatorSortKey>& keys)
+{
+    std::vector<size_t> order(keys.size());
+    std::iota(order.begin(), order.end(), 0);
+
+    std::stable_sort(order.begin(), order.end(),
+        [&keys](const size_t a, const size_t b){ return keys[a].compare(keys[b]) < 0; });
+
+    return order;
+}
@@ -0,0 +1,52 @@
+// Pegasus Frontend
+// Copyright (C) 2018  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#pragma once
+
+#include <QCollatorSortKey>
+#include <QString>
+#include <utility>
+#include <vector>
+
+
+/// Compares the strings the same way as their collation keys would be compared
+int collation_compare(const QString&, const QString&);
+
+/// Returns the locale-aware collation key of every string, in the same order.
+/// Larger inputs are processed on multiple threads.
+std::vector<QCollatorSortKey> collation_keys(const std::vector<QString>&);
+
+/// Returns the indices of the keys in ascending key order; equal keys keep their original order
+std::vector<size_t> collation_order(const std::vector<QCollatorSortKey>&);
+
+/// Sorts the items by the text returned by `text_of`, calculating the collation keys only once
+template<typename Container, typename TextFn>
+void collation_sort(Container& items, TextFn text_of)
+{
+    std::vector<QString> texts;
+    texts.reserve(static_cast<size_t>(items.size()));
+    for (const auto& item : items)
+        texts.push_back(text_of(item));
+
+    Container sorted;
+    sorted.reserve(items.size());
+    for (const size_t idx : collation_order(collation_keys(texts)))
+        sorted.push_back(std::move(items[idx]));
+
+    items = std::move(sorted);
+}
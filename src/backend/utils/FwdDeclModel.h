@@ -17,5 +17,10 @@
 
 #pragma once
 
+#include <cstdint>
+
 namespace model { class Collection; }
 namespace model { class Game; }
+namespace model { class GameLibrary; }
+namespace model { class GameListModel; }
+namespace model { using GameSlot = uint32_t; }
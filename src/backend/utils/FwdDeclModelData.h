@@ -17,6 +17,11 @@
 
 #pragma once
 
+#include <cstdint>
+
 namespace modeldata { struct Collection; }
 namespace modeldata { struct Game; }
 namespace modeldata { struct GameAssets; }
+namespace modeldata { class GamePath; }
+namespace modeldata { class GameStore; }
+namespace modeldata { using GameId = uint32_t; }
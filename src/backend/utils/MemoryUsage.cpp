@@ -0,0 +1,119 @@
+// Pegasus Frontend
+// Copyright (C) 2018  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "MemoryUsage.h"
+
+#include <QFile>
+#include <QMap>
+
+#ifdef Q_OS_LINUX
+#include <malloc.h>
+#endif
+
+
+size_t heap_size(const QString& str)
+{
+    // the null, empty and literal strings have no allocated data
+    if (str.capacity() == 0)
+        return 0;
+
+    return sizeof(QArrayData) + static_cast<size_t>(str.capacity() + 1) * sizeof(QChar);
+}
+
+size_t heap_size(const QStringList& list)
+{
+    if (list.isEmpty())
+        return 0;
+
+    // QList stores the strings in an array of pointer-sized slots
+    size_t sum = sizeof(QListData::Data) + static_cast<size_t>(list.size()) * sizeof(void*);
+    for (const QString& str : list)
+        sum += heap_size(str);
+
+    return sum;
+}
+
+size_t heap_size(const QVariant& var)
+{
+    switch (static_cast<int>(var.type())) {
+        case QMetaType::QString:
+            return heap_size(*static_cast<const QString*>(var.constData()));
+        case QMetaType::QStringList:
+            return heap_size(*static_cast<const QStringList*>(var.constData()));
+        case QMetaType::QVariantMap:
+            return heap_size(*static_cast<const QVariantMap*>(var.constData()));
+        case QMetaType::QVariantList:
+            return heap_size(*static_cast<const QVariantList*>(var.constData()));
+        default:
+            // the rest of the types used by the themes are small enough to be stored in place
+            return 0;
+    }
+}
+
+size_t heap_size(const QVariantMap& map)
+{
+    size_t sum = static_cast<size_t>(map.size()) * sizeof(QMapNode<QString, QVariant>);
+    for (auto it = map.cbegin(); it != map.cend(); ++it)
+        sum += heap_size(it.key()) + heap_size(it.value());
+
+    return sum;
+}
+
+size_t heap_size(const QVariantList& list)
+{
+    if (list.isEmpty())
+        return 0;
+
+    // QVariant is too large to be stored in place, so every item is allocated separately
+    size_t sum = sizeof(QListData::Data) + static_cast<size_t>(list.size()) * (sizeof(void*) + sizeof(QVariant));
+    for (const QVariant& var : list)
+        sum += heap_size(var);
+
+    return sum;
+}
+
+size_t process_resident_size()
+{
+#ifdef Q_OS_LINUX
+    QFile file(QStringLiteral("/proc/self/status"));
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+        return 0;
+
+    while (!file.atEnd()) {
+        const QByteArray line = file.readLine();
+        if (line.startsWith("VmRSS:")) {
+            const qint64 kib = line.mid(6).trimmed().split(' ').first().toLongLong();
+            return static_cast<size_t>(qMax(Q_INT64_C(0), kib)) * 1024;
+        }
+    }
+#endif
+    return 0;
+}
+
+void release_free_heap()
+{
+#if defined(Q_OS_LINUX) && defined(__GLIBC__)
+    // glibc keeps the freed memory of every thread's arena by default
+    ::malloc_trim(0);
+#endif
+}
+
+QString format_mem_size(size_t bytes)
+{
+    constexpr double MIB = 1024.0 * 1024.0;
+    return QString::number(static_cast<double>(bytes) / MIB, 'f', 1) + QStringLiteral(" MiB");
+}
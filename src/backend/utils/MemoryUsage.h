@@ -0,0 +1,56 @@
+// Pegasus Frontend
+// Copyright (C) 2018  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include "HashMap.h"
+
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <QVariantMap>
+
+
+// Estimates of the heap memory held by some commonly used types, not counting
+// the size of the object itself. Implicitly shared data is counted for every
+// owner, and the allocator overhead is not included, so these are rough values.
+
+size_t heap_size(const QString&);
+size_t heap_size(const QStringList&);
+size_t heap_size(const QVariant&);
+size_t heap_size(const QVariantMap&);
+size_t heap_size(const QVariantList&);
+
+/// The buckets and the nodes of the map, not counting the heap data of the keys and values
+template<typename Key, typename Val, typename Hash>
+size_t hashmap_heap_size(const HashMap<Key, Val, Hash>& map)
+{
+    // every entry is allocated in a separate node, with a next pointer and the cached hash
+    using Entry = typename HashMap<Key, Val, Hash>::value_type;
+    return map.bucket_count() * sizeof(void*)
+        + map.size() * (sizeof(Entry) + 2 * sizeof(void*));
+}
+
+/// The resident memory of the whole process, or 0 if it's not known on this platform
+size_t process_resident_size();
+
+/// Returns the free memory at the top of the heap to the system, where supported.
+/// Useful after a large number of temporary objects were freed, eg. after a scan.
+void release_free_heap();
+
+/// Formats the size for the log, eg. `12.3 MiB`
+QString format_mem_size(size_t bytes);
@@ -0,0 +1,78 @@
+// Pegasus Frontend
+// Copyright (C) 2018  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "MonotonicArena.h"
+
+#include <QtGlobal>
+#include <cstdint>
+
+
+namespace {
+char* align_ptr(char* ptr, size_t alignment)
+{
+    const auto addr = reinterpret_cast<std::uintptr_t>(ptr);
+    const auto aligned = (addr + alignment - 1) & ~static_cast<std::uintptr_t>(alignment - 1);
+    return ptr + (aligned - addr);
+}
+} // namespace
+
+
+MonotonicArena::MonotonicArena(size_t block_size)
+    : m_block_size(block_size)
+    , m_allocated_size(0)
+    , m_pos(nullptr)
+    , m_end(nullptr)
+{
+    Q_ASSERT(block_size > 0);
+}
+
+char* MonotonicArena::newBlock(size_t size)
+{
+    m_blocks.emplace_back(new char[size]);
+    m_allocated_size += size;
+    return m_blocks.back().get();
+}
+
+void* MonotonicArena::allocate(size_t size, size_t alignment)
+{
+    Q_ASSERT(alignment > 0 && (alignment & (alignment - 1)) == 0);
+    const size_t padded_size = size + alignment - 1;
+
+    // large requests (eg. the buckets of a big map) get a block of their own,
+    // so the rest of the current block can still be used
+    if (padded_size > m_block_size)
+        return align_ptr(newBlock(padded_size), alignment);
+
+    // the alignment may push the pointer past the end of the block
+    char* ptr = m_pos ? align_ptr(m_pos, alignment) : nullptr;
+    if (!ptr || ptr > m_end || size > static_cast<size_t>(m_end - ptr)) {
+        m_pos = newBlock(m_block_size);
+        m_end = m_pos + m_block_size;
+        ptr = align_ptr(m_pos, alignment);
+    }
+
+    m_pos = ptr + size;
+    return ptr;
+}
+
+void MonotonicArena::release()
+{
+    m_blocks.clear();
+    m_allocated_size = 0;
+    m_pos = nullptr;
+    m_end = nullptr;
+}
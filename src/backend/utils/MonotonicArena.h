@@ -0,0 +1,92 @@
+// Pegasus Frontend
+// Copyright (C) 2018  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include "HashMap.h"
+#include "NoCopyNoMove.h"
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+
+/// Memory for a large number of small, short-lived objects, eg. the nodes of
+/// the lookup tables built during a scan. The allocations only move a pointer
+/// forward in the current block, and the whole memory is freed at once when
+/// the arena is released or destroyed. Not thread safe, every task should use
+/// its own arena.
+class MonotonicArena {
+public:
+    explicit MonotonicArena(size_t block_size = 64 * 1024);
+    NO_COPY_NO_MOVE(MonotonicArena)
+
+    void* allocate(size_t size, size_t alignment);
+    /// Frees all memory; the objects allocated from the arena must be gone by then
+    void release();
+
+    /// The total size of the blocks allocated from the system
+    size_t allocatedSize() const { return m_allocated_size; }
+
+private:
+    const size_t m_block_size;
+    std::vector<std::unique_ptr<char[]>> m_blocks;
+    size_t m_allocated_size;
+    char* m_pos;
+    char* m_end;
+
+    char* newBlock(size_t size);
+};
+
+
+/// Standard allocator that takes its memory from a MonotonicArena. Freeing
+/// does nothing, the memory is returned when the arena is released.
+template<typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    explicit ArenaAllocator(MonotonicArena& arena) noexcept : m_arena(&arena) {}
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept : m_arena(other.arena()) {}
+
+    T* allocate(size_t n) { return static_cast<T*>(m_arena->allocate(n * sizeof(T), alignof(T))); }
+    void deallocate(T*, size_t) noexcept {}
+
+    MonotonicArena* arena() const noexcept { return m_arena; }
+
+private:
+    MonotonicArena* m_arena;
+};
+
+template<typename T, typename U>
+bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) { return a.arena() == b.arena(); }
+template<typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) { return a.arena() != b.arena(); }
+
+
+template<typename Key, typename Val, typename Hash = std::hash<Key>>
+using ArenaHashMap = std::unordered_map<Key, Val, Hash, std::equal_to<Key>,
+                                        ArenaAllocator<std::pair<const Key, Val>>>;
+
+/// Creates an empty hash map that allocates its nodes and buckets from the arena
+template<typename Key, typename Val, typename Hash = std::hash<Key>>
+ArenaHashMap<Key, Val, Hash> arena_hashmap(MonotonicArena& arena)
+{
+    using Map = ArenaHashMap<Key, Val, Hash>;
+    return Map(typename Map::allocator_type(arena));
+}
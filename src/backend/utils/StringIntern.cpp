@@ -0,0 +1,196 @@
+// Pegasus Frontend
+// Copyright (C) 2018  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "StringIntern.h"
+
+#include "HashMap.h"
+
+#include <QDataStream>
+#include <QMutex>
+#include <QReadWriteLock>
+#include <QSet>
+#include <limits>
+#include <vector>
+
+
+namespace {
+// the scanning threads intern most of their strings at the same time,
+// so the table is split to shards with their own locks
+constexpr size_t INTERN_SHARD_COUNT = 16;
+
+struct InternShard {
+    QMutex mutex;
+    QSet<QString> strings;
+};
+
+InternShard* intern_shards()
+{
+    static InternShard shards[INTERN_SHARD_COUNT];
+    return shards;
+}
+
+struct StringTable {
+    QReadWriteLock lock;
+    HashMap<QString, StringId> ids;
+    std::vector<QString> strings;
+};
+
+StringTable& string_table()
+{
+    static StringTable table;
+    return table;
+}
+} // namespace
+
+
+QString intern_string(const QString& str)
+{
+    InternShard& shard = intern_shards()[qHash(str) % INTERN_SHARD_COUNT];
+
+    QMutexLocker lock(&shard.mutex);
+    const auto it = shard.strings.constFind(str);
+    if (it != shard.strings.cend())
+        return *it;
+
+    shard.strings.insert(str);
+    return str;
+}
+
+void release_interned_strings()
+{
+    InternShard* const shards = intern_shards();
+    for (size_t i = 0; i < INTERN_SHARD_COUNT; i++) {
+        QMutexLocker lock(&shards[i].mutex);
+        shards[i].strings = QSet<QString>();
+    }
+}
+
+StringId string_id(const QString& str)
+{
+    StringTable& table = string_table();
+    {
+        // most of the strings are already known after the first few games
+        QReadLocker lock(&table.lock);
+        const auto it = table.ids.find(str);
+        if (it != table.ids.cend())
+            return it->second;
+    }
+
+    QWriteLocker lock(&table.lock);
+    const auto it = table.ids.find(str);
+    if (it != table.ids.cend())
+        return it->second;
+
+    const StringId id = static_cast<StringId>(table.strings.size());
+    table.strings.push_back(str);
+    table.ids.emplace(str, id);
+    return id;
+}
+
+QString string_by_id(StringId id)
+{
+    StringTable& table = string_table();
+
+    QReadLocker lock(&table.lock);
+    Q_ASSERT(id < table.strings.size());
+    return table.strings[id];
+}
+
+void compact_string_table(const std::vector<InternedStringList*>& lists)
+{
+    constexpr StringId NO_ID = std::numeric_limits<StringId>::max();
+
+    StringTable& table = string_table();
+    QWriteLocker lock(&table.lock);
+
+    // the strings get new IDs in the order they are found
+    std::vector<StringId> new_ids(table.strings.size(), NO_ID);
+    HashMap<QString, StringId> ids;
+    std::vector<QString> strings;
+
+    for (InternedStringList* const list : lists) {
+        for (StringId& id : list->m_ids) {
+            Q_ASSERT(id < table.strings.size());
+            StringId& new_id = new_ids[id];
+            if (new_id == NO_ID) {
+                new_id = static_cast<StringId>(strings.size());
+                strings.push_back(table.strings[id]);
+                ids.emplace(table.strings[id], new_id);
+            }
+            id = new_id;
+        }
+    }
+
+    table.ids.swap(ids);
+    table.strings.swap(strings);
+}
+
+
+void InternedStringList::append(const QString& str)
+{
+    if (!str.isEmpty())
+        m_ids.append(string_id(str));
+}
+
+void InternedStringList::append(const QStringList& list)
+{
+    m_ids.reserve(m_ids.count() + list.count());
+    for (const QString& str : list)
+        append(str);
+}
+
+QStringList InternedStringList::toStringList() const
+{
+    StringTable& table = string_table();
+
+    QStringList out;
+    out.reserve(m_ids.count());
+
+    QReadLocker lock(&table.lock);
+    for (const StringId id : m_ids)
+        out.append(table.strings[id]);
+
+    return out;
+}
+
+QString InternedStringList::join(const QString& separator) const
+{
+    return toStringList().join(separator);
+}
+
+size_t InternedStringList::heapSize() const
+{
+    if (m_ids.capacity() == 0)
+        return 0;
+
+    return sizeof(QArrayData) + static_cast<size_t>(m_ids.capacity()) * sizeof(StringId);
+}
+
+QDataStream& operator<<(QDataStream& stream, const InternedStringList& list)
+{
+    return stream << list.toStringList();
+}
+
+QDataStream& operator>>(QDataStream& stream, InternedStringList& list)
+{
+    QStringList strings;
+    stream >> strings;
+
+    list = InternedStringList();
+    list.append(strings);
+    return stream;
+}
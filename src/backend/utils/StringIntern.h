@@ -0,0 +1,83 @@
+// Pegasus Frontend
+// Copyright (C) 2018  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <vector>
+
+class QDataStream;
+class InternedStringList;
+
+
+/// Returns a copy of the string that shares its data with every other copy
+/// returned for the same text, so the frequently repeated strings (eg. the
+/// paths of directories) are stored only once. Can be called from multiple
+/// threads. The stored strings are kept until release_interned_strings().
+QString intern_string(const QString&);
+/// Forgets the interned strings, eg. after a scan; the copies already
+/// returned keep sharing their data
+void release_interned_strings();
+
+
+/// The index of a string in the global string table
+using StringId = quint32;
+
+/// Returns the ID of the string, adding it to the table on the first call.
+/// Equal strings get the same ID until the table is compacted, and the IDs
+/// are not stable between runs. Can be called from multiple threads.
+StringId string_id(const QString&);
+/// Returns the string registered with the ID
+QString string_by_id(StringId);
+/// Rebuilds the table with only the strings used by the lists, changing their IDs.
+/// Every list still in use has to be passed, and no other thread may use the
+/// table at the same time.
+void compact_string_table(const std::vector<InternedStringList*>&);
+
+
+/// A list of strings that are often repeated between the games (eg. developers
+/// or genres), stored as IDs in the global string table. Empty strings are not stored.
+class InternedStringList {
+public:
+    void append(const QString&);
+    void append(const QStringList&);
+    InternedStringList& operator<<(const QString& str) { append(str); return *this; }
+
+    bool isEmpty() const { return m_ids.isEmpty(); }
+    int count() const { return m_ids.count(); }
+    bool contains(StringId id) const { return m_ids.contains(id); }
+    const QVector<StringId>& ids() const { return m_ids; }
+
+    QStringList toStringList() const;
+    QString join(const QString& separator) const;
+
+    size_t heapSize() const;
+
+    bool operator==(const InternedStringList& other) const { return m_ids == other.m_ids; }
+    bool operator!=(const InternedStringList& other) const { return m_ids != other.m_ids; }
+
+private:
+    QVector<StringId> m_ids;
+
+    friend void compact_string_table(const std::vector<InternedStringList*>&);
+};
+
+// the IDs are only valid during the current run, so the strings are stored
+QDataStream& operator<<(QDataStream&, const InternedStringList&);
+QDataStream& operator>>(QDataStream&, InternedStringList&);
@@ -1,19 +1,27 @@
 HEADERS += \
+    $$PWD/Collation.h \
     $$PWD/FwdDeclModelData.h \
     $$PWD/HashMap.h \
     $$PWD/FwdDeclModel.h \
     $$PWD/FolderListModel.h \
+    $$PWD/MonotonicArena.h \
     $$PWD/MoveOnly.h \
     $$PWD/NoCopyNoMove.h \
     $$PWD/StrBoolConverter.h \
     $$PWD/PathCheck.h \
     $$PWD/FakeQKeyEvent.h \
     $$PWD/KeySequenceTools.h \
-    $$PWD/QmlHelpers.h
+    $$PWD/MemoryUsage.h \
+    $$PWD/QmlHelpers.h \
+    $$PWD/StringIntern.h
 
 SOURCES += \
+    $$PWD/Collation.cpp \
     $$PWD/FolderListModel.cpp \
     $$PWD/StrBoolConverter.cpp \
+    $$PWD/StringIntern.cpp \
     $$PWD/PathCheck.cpp \
     $$PWD/FakeQKeyEvent.cpp \
     $$PWD/KeySequenceTools.cpp \
+    $$PWD/MemoryUsage.cpp \
+    $$PWD/MonotonicArena.cpp \
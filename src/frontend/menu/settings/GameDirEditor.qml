@@ -39,6 +39,19 @@ FocusScope {
         }
     }
 
+    // the library is updated when the editor is closed
+    property bool libraryChanged: false
+    onClose: {
+        if (libraryChanged) {
+            libraryChanged = false;
+            api.internal.meta.rescanLibrary();
+        }
+    }
+    Connections {
+        target: api.internal.settings
+        onGameDirsChanged: root.libraryChanged = true
+    }
+
 
     property var selectedIndices: [] // we don't have Set yet
     function isSelected(index) {
@@ -296,7 +309,6 @@ FocusScope {
         }
     }
 
-    NeedsRestartNotice {}
 
 
     FilePicker {
@@ -38,6 +38,19 @@ FocusScope {
         }
     }
 
+    // the library is updated when the editor is closed
+    property bool libraryChanged: false
+    onClose: {
+        if (libraryChanged) {
+            libraryChanged = false;
+            api.internal.meta.rescanLibrary();
+        }
+    }
+    Connections {
+        target: api.internal.settings.providers
+        onDataChanged: root.libraryChanged = true
+    }
+
 
     Rectangle {
         id: shade
@@ -192,5 +205,4 @@ FocusScope {
         }
     }
 
-    NeedsRestartNotice {}
 }
@@ -3,6 +3,8 @@ TEMPLATE = subdirs
 SUBDIRS += \
     api \
     configfile \
+    filesystem \
     model \
     providers \
+    trace \
     utils \
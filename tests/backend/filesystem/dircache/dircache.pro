@@ -0,0 +1,12 @@
+CONFIG += testcase no_testcase_installs
+
+QT += testlib
+CONFIG += c++11 warn_on exceptions_off
+
+TARGET = test_DirCache
+SOURCES = $${TARGET}.cpp
+HEADERS = $${TOP_SRCDIR}/tests/backend/TestFiles.h
+INCLUDEPATH += $${TOP_SRCDIR}/tests/backend
+DEFINES *= $${COMMON_DEFINES}
+
+include($${TOP_SRCDIR}/src/link_to_backend.pri)
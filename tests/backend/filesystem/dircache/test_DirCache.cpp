@@ -0,0 +1,359 @@
+// Pegasus Frontend
+// Copyright (C) 2018  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <QtTest/QtTest>
+
+#include "TestFiles.h"
+#include "filesystem/DirCache.h"
+
+#include <QTemporaryDir>
+
+
+namespace {
+QStringList entry_names(const filesystem::DirListing& listing)
+{
+    QStringList names;
+    for (const filesystem::DirEntry& entry : listing.entries)
+        names << entry.name;
+
+    names.sort();
+    return names;
+}
+} // namespace
+
+
+class test_DirCache : public QObject {
+    Q_OBJECT
+
+private slots:
+    void list();
+    void list_changed();
+    void list_resource();
+    void list_special_entries();
+    void list_during_scan();
+    void list_unreadable();
+    void canonical_file_path();
+    void subdirs();
+    void symlink_loop();
+    void prefetch();
+    void save_load();
+    void entry_parts_data();
+    void entry_parts();
+};
+
+void test_DirCache::list()
+{
+    QTemporaryDir tmp_dir;
+    QVERIFY(tmp_dir.isValid());
+    QVERIFY(touch(tmp_dir.path() + "/a.txt"));
+    QVERIFY(QDir(tmp_dir.path()).mkdir("sub"));
+
+    filesystem::DirCache cache;
+    const filesystem::DirListing listing = cache.list(tmp_dir.path());
+
+    QCOMPARE(listing.canonical_path, QFileInfo(tmp_dir.path()).canonicalFilePath());
+    QCOMPARE(entry_names(listing), QStringList({ "a.txt", "sub" }));
+
+    for (const filesystem::DirEntry& entry : listing.entries) {
+        QCOMPARE(entry.is_dir, entry.name == QLatin1String("sub"));
+        QCOMPARE(listing.canonicalFilePath(entry), listing.canonical_path + '/' + entry.name);
+    }
+}
+
+void test_DirCache::list_changed()
+{
+    QTemporaryDir tmp_dir;
+    QVERIFY(tmp_dir.isValid());
+    QVERIFY(touch(tmp_dir.path() + "/a.txt"));
+
+    filesystem::DirCache cache;
+    QCOMPARE(cache.list(tmp_dir.path()).entries.size(), 1);
+
+    QVERIFY(touch(tmp_dir.path() + "/b.txt"));
+    QCOMPARE(entry_names(cache.list(tmp_dir.path())), QStringList({ "a.txt", "b.txt" }));
+
+    QVERIFY(QFile::remove(tmp_dir.path() + "/a.txt"));
+    QCOMPARE(entry_names(cache.list(tmp_dir.path())), QStringList({ "b.txt" }));
+}
+
+void test_DirCache::list_during_scan()
+{
+    QTemporaryDir tmp_dir;
+    QVERIFY(tmp_dir.isValid());
+    QVERIFY(touch(tmp_dir.path() + "/a.txt"));
+
+    filesystem::DirCache cache;
+    cache.startScan();
+    QCOMPARE(entry_names(cache.list(tmp_dir.path())), QStringList({ "a.txt" }));
+
+    // the directory is read only once per scan
+    QVERIFY(touch(tmp_dir.path() + "/b.txt"));
+    QCOMPARE(entry_names(cache.list(tmp_dir.path())), QStringList({ "a.txt" }));
+    cache.finishScan();
+
+    QCOMPARE(entry_names(cache.list(tmp_dir.path())), QStringList({ "a.txt", "b.txt" }));
+
+    // a new scan checks the directory again
+    QVERIFY(QFile::remove(tmp_dir.path() + "/a.txt"));
+    cache.startScan();
+    QCOMPARE(entry_names(cache.list(tmp_dir.path())), QStringList({ "b.txt" }));
+    cache.finishScan();
+}
+
+void test_DirCache::list_unreadable()
+{
+#ifdef Q_OS_LINUX
+    QTemporaryDir tmp_dir;
+    QVERIFY(tmp_dir.isValid());
+    QVERIFY(touch(tmp_dir.path() + "/sub/a.txt"));
+
+    const QString sub_path = tmp_dir.path() + "/sub";
+    QVERIFY(QFile::setPermissions(sub_path, QFile::WriteOwner));
+    if (QDir(sub_path).entryList(QDir::Files).count() > 0) {
+        QFile::setPermissions(sub_path, QFile::ReadOwner | QFile::WriteOwner | QFile::ExeOwner);
+        QSKIP("the permissions are not enforced for this user");
+    }
+
+    filesystem::DirCache cache;
+    cache.startScan();
+    const filesystem::DirListing listing = cache.list(sub_path);
+    QVERIFY(listing.read_failed);
+    QVERIFY(listing.entries.isEmpty());
+
+    // failed listings are not kept, not even during the scan
+    QVERIFY(QFile::setPermissions(sub_path, QFile::ReadOwner | QFile::WriteOwner | QFile::ExeOwner));
+    const filesystem::DirListing retry = cache.list(sub_path);
+    QVERIFY(!retry.read_failed);
+    QCOMPARE(entry_names(retry), QStringList({ "a.txt" }));
+    cache.finishScan();
+#else
+    QSKIP("only the native Linux listing reports read errors");
+#endif
+}
+
+void test_DirCache::list_resource()
+{
+    filesystem::DirCache cache;
+    const filesystem::DirListing missing = cache.list(QStringLiteral(":/nonexistent"));
+    QVERIFY(missing.canonical_path.isEmpty());
+    QVERIFY(missing.entries.isEmpty());
+}
+
+void test_DirCache::list_special_entries()
+{
+#ifdef Q_OS_UNIX
+    QTemporaryDir tmp_dir;
+    QVERIFY(tmp_dir.isValid());
+    QVERIFY(touch(tmp_dir.path() + "/a.txt"));
+    QVERIFY(touch(tmp_dir.path() + "/.hidden"));
+    QVERIFY(QDir(tmp_dir.path()).mkdir("sub"));
+    QVERIFY(QFile::link(tmp_dir.path() + "/a.txt", tmp_dir.path() + "/sub/link.txt"));
+    QVERIFY(QFile::link(tmp_dir.path() + "/missing.txt", tmp_dir.path() + "/sub/broken.txt"));
+    QVERIFY(QFile::link(tmp_dir.path() + "/sub", tmp_dir.path() + "/dirlink"));
+
+    filesystem::DirCache cache;
+    const filesystem::DirListing listing = cache.list(tmp_dir.path());
+    QCOMPARE(entry_names(listing), QStringList({ "a.txt", "dirlink", "sub" }));
+    QVERIFY(listing.inode != 0);
+
+    for (const filesystem::DirEntry& entry : listing.entries) {
+        if (entry.name == QLatin1String("dirlink")) {
+            QVERIFY(entry.is_dir);
+            QCOMPARE(entry.link_target, listing.canonical_path + "/sub");
+        }
+    }
+
+    const filesystem::DirListing sub_listing = cache.list(tmp_dir.path() + "/sub");
+    QCOMPARE(entry_names(sub_listing), QStringList({ "link.txt" }));
+    QVERIFY(!sub_listing.entries.first().is_dir);
+    QCOMPARE(sub_listing.canonicalFilePath(sub_listing.entries.first()), listing.canonical_path + "/a.txt");
+#else
+    QSKIP("symbolic links are not supported");
+#endif
+}
+
+void test_DirCache::canonical_file_path()
+{
+    QTemporaryDir tmp_dir;
+    QVERIFY(tmp_dir.isValid());
+    QVERIFY(QDir(tmp_dir.path()).mkdir("sub"));
+    QVERIFY(touch(tmp_dir.path() + "/sub/a.txt"));
+
+    const QString canonical_dir = QFileInfo(tmp_dir.path()).canonicalFilePath();
+
+    filesystem::DirCache cache;
+    cache.startScan();
+    QCOMPARE(cache.canonicalFilePath(tmp_dir.path() + "/sub/a.txt"), canonical_dir + "/sub/a.txt");
+    QCOMPARE(cache.canonicalFilePath(tmp_dir.path() + "/sub/../sub/a.txt"), canonical_dir + "/sub/a.txt");
+    QCOMPARE(cache.canonicalFilePath(tmp_dir.path() + "/sub/missing.txt"), QString());
+    QCOMPARE(cache.canonicalFilePath(tmp_dir.path() + "/missing/a.txt"), QString());
+
+#ifdef Q_OS_UNIX
+    QVERIFY(QFile::link(tmp_dir.path() + "/sub", tmp_dir.path() + "/dirlink"));
+    QVERIFY(QFile::link(tmp_dir.path() + "/sub/a.txt", tmp_dir.path() + "/filelink.txt"));
+    QCOMPARE(cache.canonicalFilePath(tmp_dir.path() + "/dirlink/a.txt"), canonical_dir + "/sub/a.txt");
+    QCOMPARE(cache.canonicalFilePath(tmp_dir.path() + "/filelink.txt"), canonical_dir + "/sub/a.txt");
+
+    // the files of a listed directory come from the listing
+    QVERIFY(QFile::link(tmp_dir.path() + "/sub/a.txt", tmp_dir.path() + "/sub/link.txt"));
+    QVERIFY(touch(tmp_dir.path() + "/sub/.hidden.txt"));
+    QCOMPARE(cache.list(tmp_dir.path() + "/sub").entries.count(), 2);
+    QCOMPARE(cache.canonicalFilePath(tmp_dir.path() + "/sub/a.txt"), canonical_dir + "/sub/a.txt");
+    QCOMPARE(cache.canonicalFilePath(tmp_dir.path() + "/sub/link.txt"), canonical_dir + "/sub/a.txt");
+    QCOMPARE(cache.canonicalFilePath(tmp_dir.path() + "/sub/.hidden.txt"), canonical_dir + "/sub/.hidden.txt");
+#endif
+    cache.finishScan();
+}
+
+void test_DirCache::subdirs()
+{
+    QTemporaryDir tmp_dir;
+    QVERIFY(tmp_dir.isValid());
+
+    QDir root(tmp_dir.path());
+    QVERIFY(root.mkpath("a/b/c"));
+    QVERIFY(root.mkpath("d"));
+    QVERIFY(touch(tmp_dir.path() + "/a/file.txt"));
+
+    filesystem::DirCache cache;
+    QStringList found = cache.subdirs(tmp_dir.path());
+    found.sort();
+
+    const QStringList expected {
+        tmp_dir.path() + "/a",
+        tmp_dir.path() + "/a/b",
+        tmp_dir.path() + "/a/b/c",
+        tmp_dir.path() + "/d",
+    };
+    QCOMPARE(found, expected);
+
+    QStringList files;
+    cache.forEachFile(tmp_dir.path(),
+        [&files](const QString& dir_path, const filesystem::DirListing&, const filesystem::DirEntry& entry){
+            files << dir_path + '/' + entry.name;
+        });
+    QCOMPARE(files, QStringList({ tmp_dir.path() + "/a/file.txt" }));
+}
+
+void test_DirCache::symlink_loop()
+{
+#ifdef Q_OS_UNIX
+    QTemporaryDir tmp_dir;
+    QVERIFY(tmp_dir.isValid());
+
+    QDir root(tmp_dir.path());
+    QVERIFY(root.mkpath("a"));
+    QVERIFY(QFile::link(tmp_dir.path(), tmp_dir.path() + "/a/loop"));
+
+    filesystem::DirCache cache;
+    QCOMPARE(cache.subdirs(tmp_dir.path()), QStringList({ tmp_dir.path() + "/a" }));
+#else
+    QSKIP("symbolic links are not supported");
+#endif
+}
+
+void test_DirCache::prefetch()
+{
+    QTemporaryDir tmp_dir;
+    QVERIFY(tmp_dir.isValid());
+
+    QDir root(tmp_dir.path());
+    for (int i = 0; i < 20; i++) {
+        const QString sub = QString("dir%1/sub").arg(i);
+        QVERIFY(root.mkpath(sub));
+        QVERIFY(touch(tmp_dir.path() + '/' + sub + "/game.bin"));
+    }
+
+    filesystem::DirCache reference;
+    const QStringList expected = reference.subdirs(tmp_dir.path());
+    QCOMPARE(expected.size(), 40);
+
+    filesystem::DirCache cache;
+    cache.startScan();
+    cache.prefetch({ tmp_dir.path() });
+
+    // the walks use the prefetched listings, and keep the order of a sequential walk
+    QVERIFY(touch(tmp_dir.path() + "/dir0/sub/late.bin"));
+    QCOMPARE(cache.subdirs(tmp_dir.path()), expected);
+
+    int file_count = 0;
+    cache.forEachFile(tmp_dir.path(),
+        [&file_count](const QString&, const filesystem::DirListing&, const filesystem::DirEntry& entry){
+            QCOMPARE(entry.name, QStringLiteral("game.bin"));
+            file_count++;
+        });
+    QCOMPARE(file_count, 20);
+    cache.finishScan();
+}
+
+void test_DirCache::save_load()
+{
+    QTemporaryDir tmp_dir;
+    QVERIFY(tmp_dir.isValid());
+    QVERIFY(touch(tmp_dir.path() + "/a.txt"));
+
+    const QString cache_path = tmp_dir.path() + "/../" + QFileInfo(tmp_dir.path()).fileName() + ".cache";
+
+    {
+        // only the listings of a scan are kept
+        filesystem::DirCache cache;
+        cache.startScan();
+        cache.list(tmp_dir.path());
+        cache.finishScan();
+        cache.save(cache_path);
+    }
+    {
+        // recently changed directories may not be stored, but
+        // the listing must be correct either way
+        filesystem::DirCache cache;
+        cache.load(cache_path);
+        QCOMPARE(entry_names(cache.list(tmp_dir.path())), QStringList({ "a.txt" }));
+    }
+
+    QFile::remove(cache_path);
+}
+
+void test_DirCache::entry_parts_data()
+{
+    QTest::addColumn<QString>("name");
+    QTest::addColumn<QString>("basename");
+    QTest::addColumn<QString>("suffix");
+
+    QTest::newRow("simple") << "game.bin" << "game" << "bin";
+    QTest::newRow("multiple dots") << "game.tar.gz" << "game.tar" << "gz";
+    QTest::newRow("no suffix") << "game" << "game" << "";
+    QTest::newRow("hidden") << ".game" << "" << "game";
+}
+
+void test_DirCache::entry_parts()
+{
+    QFETCH(QString, name);
+    QFETCH(QString, basename);
+    QFETCH(QString, suffix);
+
+    const filesystem::DirEntry entry { name, QString(), false };
+    QCOMPARE(entry.completeBaseName(), QFileInfo(name).completeBaseName());
+    QCOMPARE(entry.completeBaseName(), basename);
+    QCOMPARE(entry.completeBaseNameRef().toString(), basename);
+    QCOMPARE(entry.suffix(), QFileInfo(name).suffix());
+    QCOMPARE(entry.suffix(), suffix);
+    QCOMPARE(entry.suffixRef().toString(), suffix);
+}
+
+
+QTEST_MAIN(test_DirCache)
+#include "test_DirCache.moc"
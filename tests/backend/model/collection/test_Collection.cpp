@@ -18,7 +18,7 @@
 #include <QtTest/QtTest>
 
 #include "model/gaming/Collection.h"
-#include "model/gaming/Game.h"
+#include "model/gaming/GameLibrary.h"
 
 
 class test_Collection : public QObject {
@@ -34,7 +34,8 @@ void test_Collection::names()
     modeldata::Collection modeldata("myname");
     modeldata.setShortName("abbrev");
     modeldata.launch_cmd = "runner";
-    model::Collection collection(std::move(modeldata));
+    model::GameLibrary library;
+    model::Collection collection(std::move(modeldata), library);
     collection.setGameList({});
 
     // the properties are read-only and should be called only after the initial setup
@@ -44,19 +45,20 @@ void test_Collection::names()
 
 void test_Collection::games()
 {
-    QVector<model::Game*> games = {
-        new model::Game(modeldata::Game(QFileInfo("a")), this),
-        new model::Game(modeldata::Game(QFileInfo("b")), this),
-        new model::Game(modeldata::Game(QFileInfo("c")), this),
+    model::GameLibrary library;
+    QVector<model::GameSlot> games = {
+        library.add(modeldata::Game(QFileInfo("a"))),
+        library.add(modeldata::Game(QFileInfo("b"))),
+        library.add(modeldata::Game(QFileInfo("c"))),
     };
-    model::Collection collection(modeldata::Collection("test"));
+    model::Collection collection(modeldata::Collection("test"), library);
     collection.setGameList(std::move(games));
 
     // matching count and sorted by title
-    QCOMPARE(collection.games()->count(), 3);
-    QCOMPARE(collection.games()->at(0)->title(), QStringLiteral("a"));
-    QCOMPARE(collection.games()->at(1)->title(), QStringLiteral("b"));
-    QCOMPARE(collection.games()->at(2)->title(), QStringLiteral("c"));
+    QCOMPARE(collection.games().count(), 3);
+    QCOMPARE(collection.games().get(0)->title(), QStringLiteral("a"));
+    QCOMPARE(collection.games().get(1)->title(), QStringLiteral("b"));
+    QCOMPARE(collection.games().get(2)->title(), QStringLiteral("c"));
 }
 
 
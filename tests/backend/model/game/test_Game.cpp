@@ -18,6 +18,7 @@
 #include <QtTest/QtTest>
 
 #include "model/gaming/Game.h"
+#include "model/gaming/GameLibrary.h"
 
 
 class test_Game : public QObject {
@@ -30,18 +31,22 @@ private slots:
     void release();
 
     void launch();
+
+    void path_parts();
+    void path_missing_file();
 };
 
 void testStrAndList(std::function<void(modeldata::Game&, const QString&)> fn_add,
                     const char* str_name,
                     const char* list_name)
 {
-    modeldata::Game modeldata({});
+    modeldata::Game modeldata { QFileInfo() };
     fn_add(modeldata, "test1");
     fn_add(modeldata, "test2");
     fn_add(modeldata, "test3");
 
-    model::Game game(std::move(modeldata));
+    model::GameLibrary library;
+    const model::Game& game = *library.object(library.add(std::move(modeldata)));
 
     QCOMPARE(game.property(str_name).toString(), QStringLiteral("test1, test2, test3"));
     QCOMPARE(game.property(list_name).toStringList(), QStringList({"test1", "test2", "test3"}));
@@ -67,10 +72,11 @@ void test_Game::genres()
 
 void test_Game::release()
 {
-    modeldata::Game modeldata({});
+    modeldata::Game modeldata { QFileInfo() };
     modeldata.release_date = QDate(1999,1,2);
 
-    model::Game game(std::move(modeldata));
+    model::GameLibrary library;
+    const model::Game& game = *library.object(library.add(std::move(modeldata)));
     QCOMPARE(game.property("releaseYear").toInt(), 1999);
     QCOMPARE(game.property("releaseMonth").toInt(), 1);
     QCOMPARE(game.property("releaseDay").toInt(), 2);
@@ -78,14 +84,44 @@ void test_Game::release()
 
 void test_Game::launch()
 {
-    model::Game game(modeldata::Game({}));
+    model::GameLibrary library;
+    model::Game* const game = library.object(library.add(modeldata::Game(QFileInfo())));
 
-    QSignalSpy spy_launch(&game, &model::Game::launchRequested);
-    QVERIFY(spy_launch.isValid());
+    QSignalSpy spy_launch(game, &model::Game::launchRequested);
+    QSignalSpy spy_library_launch(&library, &model::GameLibrary::launchRequested);
+    QVERIFY(spy_launch.isValid() && spy_library_launch.isValid());
 
     // FIXME: "Unable to handle parameter '' of type ..."
-    QMetaObject::invokeMethod(&game, "launch");
+    QMetaObject::invokeMethod(game, "launch");
     QVERIFY(spy_launch.count() == 1 || spy_launch.wait());
+    QCOMPARE(spy_library_launch.count(), 1);
+}
+
+void test_Game::path_parts()
+{
+    const modeldata::GamePath path(QStringLiteral("/roms/snes"),
+                                   QStringLiteral("Some Game.v1.sfc"),
+                                   QStringLiteral("/mnt/roms/snes/Some Game.v1.sfc"));
+
+    QCOMPARE(path.dirPath(), QStringLiteral("/roms/snes"));
+    QCOMPARE(path.filePath(), QStringLiteral("/roms/snes/Some Game.v1.sfc"));
+    QCOMPARE(path.completeBaseName(), QStringLiteral("Some Game.v1"));
+    QCOMPARE(path.suffix(), QStringLiteral("sfc"));
+    QCOMPARE(path.canonicalDirPath(), QStringLiteral("/mnt/roms/snes"));
+    QCOMPARE(path.canonicalFilePath(), QStringLiteral("/mnt/roms/snes/Some Game.v1.sfc"));
+
+    const modeldata::Game game(path);
+    QCOMPARE(game.title, QStringLiteral("Some Game.v1"));
+}
+
+void test_Game::path_missing_file()
+{
+    const modeldata::GamePath path(QFileInfo(QStringLiteral("/nonexistent/game")));
+
+    QCOMPARE(path.filePath(), QStringLiteral("/nonexistent/game"));
+    QCOMPARE(path.completeBaseName(), QStringLiteral("game"));
+    QCOMPARE(path.suffix(), QString());
+    QVERIFY(path.canonicalFilePath().isEmpty());
 }
 
 
@@ -27,6 +27,9 @@ class test_GameAssets : public QObject
 private slots:
     void setSingle();
     void appendMulti();
+    void missing();
+    void local_files();
+    void lookup_pending();
 };
 
 void test_GameAssets::setSingle()
@@ -48,6 +51,56 @@ void test_GameAssets::appendMulti()
     QCOMPARE(assets.property("videos").toStringList().constFirst(), QLatin1String("file:///dummy"));
 }
 
+void test_GameAssets::missing()
+{
+    const modeldata::GameAssets modeldata;
+    QVERIFY(modeldata.single(AssetType::BOX_FRONT).isEmpty());
+    QVERIFY(modeldata.multi(AssetType::SCREENSHOTS).isEmpty());
+
+    // reading doesn't allocate anything
+    QCOMPARE(modeldata.heapSize(), static_cast<size_t>(0));
+}
+
+void test_GameAssets::local_files()
+{
+    const QString dir_path = QStringLiteral("/my games/media");
+    modeldata::GameAssets modeldata;
+    modeldata.addFileMaybe(AssetType::BOX_FRONT, dir_path + QStringLiteral("/box.png"));
+    modeldata.addFileMaybe(AssetType::SCREENSHOTS, dir_path, QStringLiteral("shot.png"));
+    // the same file, only once
+    modeldata.addFileMaybe(AssetType::SCREENSHOTS, dir_path + QStringLiteral("/shot.png"));
+    QCOMPARE(modeldata.multi(AssetType::SCREENSHOTS).count(), 1);
+
+    model::GameAssets assets(&modeldata);
+    QCOMPARE(assets.property("boxFront").toString(),
+             QUrl::fromLocalFile(dir_path + QStringLiteral("/box.png")).toString());
+    QCOMPARE(assets.property("screenshots").toStringList(),
+             QStringList(QUrl::fromLocalFile(dir_path + QStringLiteral("/shot.png")).toString()));
+
+    // the cached values are dropped on refresh
+    modeldata.setSingle(AssetType::BOX_FRONT, modeldata::Asset::fromFile(dir_path + QStringLiteral("/other.png")));
+    assets.refresh();
+    QCOMPARE(assets.property("boxFront").toString(),
+             QUrl::fromLocalFile(dir_path + QStringLiteral("/other.png")).toString());
+}
+
+void test_GameAssets::lookup_pending()
+{
+    modeldata::GameAssets modeldata;
+    model::GameAssets assets(&modeldata);
+    QSignalSpy spy(&assets, &model::GameAssets::lookupRequested);
+    QVERIFY(spy.isValid());
+
+    assets.property("boxFront");
+    QCOMPARE(spy.count(), 0);
+
+    // only the first read requests the lookup
+    assets.setLookupPending(true);
+    assets.property("logo");
+    assets.property("videos");
+    QCOMPARE(spy.count(), 1);
+}
+
 
 QTEST_MAIN(test_GameAssets)
 #include "test_GameAssets.moc"
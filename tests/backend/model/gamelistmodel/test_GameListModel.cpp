@@ -0,0 +1,181 @@
+// Pegasus Frontend
+// Copyright (C) 2018  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <QtTest/QtTest>
+
+#include "model/gaming/Game.h"
+#include "model/gaming/GameLibrary.h"
+#include "model/gaming/GameListModel.h"
+
+
+class test_GameListModel : public QObject {
+    Q_OBJECT
+
+private slots:
+    void roles();
+    void lazy_objects();
+    void change_signals();
+    void slot_reuse();
+    void list_functions();
+};
+
+void test_GameListModel::roles()
+{
+    modeldata::Game modeldata(QFileInfo("mygame"));
+    modeldata.developers.append(QStringList { "dev1", "dev2" });
+    modeldata.release_date = QDate(1999, 1, 2);
+
+    model::GameLibrary library;
+    model::GameListModel games(library);
+    games.append({ library.add(std::move(modeldata)) });
+
+    const QHash<int, QByteArray> role_names = games.roleNames();
+    const auto role_data = [&games, &role_names](const char* name){
+        return games.data(games.index(0), role_names.key(name));
+    };
+
+    QCOMPARE(games.rowCount(), 1);
+    QCOMPARE(role_data("title").toString(), QStringLiteral("mygame"));
+    QCOMPARE(role_data("developer").toString(), QStringLiteral("dev1, dev2"));
+    QCOMPARE(role_data("developerList").toStringList(), QStringList({"dev1", "dev2"}));
+    QCOMPARE(role_data("releaseYear").toInt(), 1999);
+    QCOMPARE(role_data("favorite").toBool(), false);
+}
+
+void test_GameListModel::lazy_objects()
+{
+    model::GameLibrary library;
+    model::GameListModel games(library);
+    games.append({
+        library.add(modeldata::Game(QFileInfo("a"))),
+        library.add(modeldata::Game(QFileInfo("b"))),
+    });
+
+    // the plain roles don't need the objects
+    games.data(games.index(1), model::GameListModel::Title);
+    QCOMPARE(library.findChildren<model::Game*>().count(), 0);
+
+    model::Game* const game = games.get(1);
+    QVERIFY(game != nullptr);
+    QCOMPARE(game->title(), QStringLiteral("b"));
+    QCOMPARE(library.findChildren<model::Game*>().count(), 1);
+
+    // the same object is returned on later calls
+    QCOMPARE(games.get(1), game);
+    QCOMPARE(games.data(games.index(1), model::GameListModel::ModelData).value<model::Game*>(), game);
+    QCOMPARE(library.findChildren<model::Game*>().count(), 1);
+
+    QCOMPARE(games.get(2), static_cast<model::Game*>(nullptr));
+}
+
+void test_GameListModel::change_signals()
+{
+    model::GameLibrary library;
+    model::GameListModel games(library);
+    games.append({
+        library.add(modeldata::Game(QFileInfo("a"))),
+        library.add(modeldata::Game(QFileInfo("b"))),
+    });
+    model::Game* const game = games.get(1);
+
+    QSignalSpy spy_model(&games, &QAbstractItemModel::dataChanged);
+    QSignalSpy spy_object(game, &model::Game::favoriteChanged);
+    QSignalSpy spy_library(&library, &model::GameLibrary::favoriteChanged);
+    QVERIFY(spy_model.isValid() && spy_object.isValid() && spy_library.isValid());
+
+    // through the object, as QML would do it
+    game->setProperty("favorite", true);
+
+    QCOMPARE(spy_model.count(), 1);
+    QCOMPARE(spy_model.at(0).at(0).toModelIndex().row(), 1);
+    QCOMPARE(spy_object.count(), 1);
+    QCOMPARE(spy_library.count(), 1);
+    QCOMPARE(games.data(games.index(1), model::GameListModel::Favorite).toBool(), true);
+
+    // the rows may move
+    games.move(1, 0);
+    library.updatePlayStats(game->slot(), 10, QDateTime::currentDateTime());
+
+    QCOMPARE(spy_model.count(), 2);
+    QCOMPARE(spy_model.at(1).at(0).toModelIndex().row(), 0);
+    QCOMPARE(game->property("playCount").toInt(), 1);
+}
+
+void test_GameListModel::slot_reuse()
+{
+    model::GameLibrary library;
+    const model::GameSlot slot_a = library.add(modeldata::Game(QFileInfo("a")));
+    const model::GameSlot slot_b = library.add(modeldata::Game(QFileInfo("b")));
+
+    // the objects keep referring to the right assets when the storage grows
+    model::Game* const game_b = library.object(slot_b);
+    for (int i = 0; i < 100; i++)
+        library.add(modeldata::Game(QFileInfo(QString::number(i))));
+    QCOMPARE(game_b->title(), QStringLiteral("b"));
+    QCOMPARE(game_b->property("assets").value<model::GameAssets*>()->property("boxFront").toString(), QString());
+
+    library.remove(slot_a);
+    const model::GameSlot slot_c = library.add(modeldata::Game(QFileInfo("c")));
+    QCOMPARE(slot_c, slot_a);
+    QCOMPARE(library.at(slot_c).title, QStringLiteral("c"));
+    QCOMPARE(library.at(slot_b).title, QStringLiteral("b"));
+}
+
+void test_GameListModel::list_functions()
+{
+    model::GameLibrary library;
+    model::GameListModel games(library);
+    games.append({
+        library.add(modeldata::Game(QFileInfo("a"))),
+        library.add(modeldata::Game(QFileInfo("b"))),
+    });
+    const model::GameSlot other_slot = library.add(modeldata::Game(QFileInfo("c")));
+
+    // called the same way as from QML
+    int size = 0;
+    QVERIFY(QMetaObject::invokeMethod(&games, "size", Q_RETURN_ARG(int, size)));
+    QCOMPARE(size, 2);
+
+    bool empty = true;
+    QVERIFY(QMetaObject::invokeMethod(&games, "isEmpty", Q_RETURN_ARG(bool, empty)));
+    QCOMPARE(empty, false);
+
+    model::Game* first = nullptr;
+    model::Game* last = nullptr;
+    QVERIFY(QMetaObject::invokeMethod(&games, "getFirst", Q_RETURN_ARG(model::Game*, first)));
+    QVERIFY(QMetaObject::invokeMethod(&games, "getLast", Q_RETURN_ARG(model::Game*, last)));
+    QCOMPARE(first->title(), QStringLiteral("a"));
+    QCOMPARE(last->title(), QStringLiteral("b"));
+
+    QCOMPARE(games.indexOf(static_cast<QObject*>(last)), 1);
+    QVERIFY(games.contains(static_cast<QObject*>(first)));
+    QVERIFY(!games.contains(static_cast<QObject*>(library.object(other_slot))));
+    QVERIFY(!games.contains(static_cast<QObject*>(&games)));
+
+    const QVariantList array = games.toVarArray();
+    QCOMPARE(array.count(), 2);
+    QCOMPARE(array.at(1).value<model::Game*>(), last);
+
+    model::GameListModel empty_games(library);
+    QVERIFY(empty_games.isEmpty());
+    QCOMPARE(empty_games.getFirst(), static_cast<model::Game*>(nullptr));
+    QCOMPARE(empty_games.getLast(), static_cast<model::Game*>(nullptr));
+}
+
+
+QTEST_MAIN(test_GameListModel)
+#include "test_GameListModel.moc"
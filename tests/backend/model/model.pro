@@ -4,6 +4,7 @@ SUBDIRS += \
     collection \
     game \
     gameassets \
+    gamelistmodel \
     locales \
     memory \
     system \
@@ -0,0 +1,178 @@
+// Pegasus Frontend
+// Copyright (C) 2018  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <QtTest/QtTest>
+
+#include "filesystem/DirCache.h"
+#include "modeldata/gaming/GameData.h"
+#include "modeldata/gaming/GameStore.h"
+#include "providers/AssetResolver.h"
+#include "types/AssetType.h"
+
+#include <QTemporaryDir>
+
+
+using providers::AssetResolver;
+
+Q_DECLARE_METATYPE(AssetType)
+
+namespace {
+modeldata::GameId add_game(modeldata::GameStore& games, const QString& dir_path, const QString& file_name)
+{
+    const QString file_path = dir_path + QLatin1Char('/') + file_name;
+    modeldata::Game game { modeldata::GamePath(dir_path, file_name, file_path) };
+    return games.add(file_path, std::move(game));
+}
+} // namespace
+
+
+class test_AssetResolver : public QObject {
+    Q_OBJECT
+
+private slots:
+    void type_by_name_data();
+    void type_by_name();
+    void type_by_name_suffix_data();
+    void type_by_name_suffix();
+    void find_game();
+    void first_file_wins();
+    void mirrored_dirs();
+};
+
+void test_AssetResolver::type_by_name_data()
+{
+    QTest::addColumn<QString>("file_name");
+    QTest::addColumn<AssetType>("type");
+
+    QTest::newRow("image") << "boxFront.png" << AssetType::BOX_FRONT;
+    QTest::newRow("video") << "video.mp4" << AssetType::VIDEOS;
+    QTest::newRow("wrong extension") << "boxFront.mp4" << AssetType::UNKNOWN;
+    QTest::newRow("unknown name") << "something.png" << AssetType::UNKNOWN;
+    QTest::newRow("no extension") << "logo" << AssetType::UNKNOWN;
+}
+
+void test_AssetResolver::type_by_name()
+{
+    QFETCH(QString, file_name);
+    QFETCH(AssetType, type);
+
+    const filesystem::DirEntry entry { file_name, QString(), false };
+    QCOMPARE(AssetResolver::typeByName(entry.completeBaseNameRef(), entry.suffixRef()), type);
+}
+
+void test_AssetResolver::type_by_name_suffix_data()
+{
+    QTest::addColumn<QString>("file_name");
+    QTest::addColumn<AssetType>("type");
+    QTest::addColumn<QString>("game_basename");
+
+    QTest::newRow("with type") << "mygame-logo.png" << AssetType::LOGO << "mygame";
+    QTest::newRow("dashes in name") << "my-game-marquee.jpg" << AssetType::ARCADE_MARQUEE << "my-game";
+    QTest::newRow("by extension") << "mygame.webm" << AssetType::VIDEOS << "mygame";
+    QTest::newRow("unknown type") << "my-game.png" << AssetType::BOX_FRONT << "my-game";
+    QTest::newRow("wrong extension") << "mygame-video.png" << AssetType::UNKNOWN << "mygame";
+}
+
+void test_AssetResolver::type_by_name_suffix()
+{
+    QFETCH(QString, file_name);
+    QFETCH(AssetType, type);
+    QFETCH(QString, game_basename);
+
+    const filesystem::DirEntry entry { file_name, QString(), false };
+    QStringRef found_basename;
+    QCOMPARE(AssetResolver::typeByNameSuffix(entry, found_basename), type);
+    QCOMPARE(found_basename.toString(), game_basename);
+}
+
+void test_AssetResolver::find_game()
+{
+    modeldata::GameStore games;
+    const modeldata::GameId id_a = add_game(games, QStringLiteral("/roms"), QStringLiteral("a.bin"));
+    const modeldata::GameId id_b = add_game(games, QStringLiteral("/roms/sub"), QStringLiteral("b.tar.gz"));
+
+    // the names are looked up through references into longer strings
+    const QString file_a = QStringLiteral("a.png");
+    const QString file_b = QStringLiteral("b.tar.png");
+
+    AssetResolver resolver(games);
+    QCOMPARE(AssetResolver::findGame(resolver.findDir(QStringLiteral("/roms")), file_a.leftRef(1)), id_a);
+    QCOMPARE(AssetResolver::findGame(resolver.findDir(QStringLiteral("/roms/sub")), file_b.leftRef(5)), id_b);
+    QCOMPARE(AssetResolver::findGame(resolver.findDir(QStringLiteral("/roms")), file_b.leftRef(5)), modeldata::INVALID_GAMEID);
+    QVERIFY(resolver.findDir(QStringLiteral("/other")) == nullptr);
+
+    resolver.addAlias(QStringLiteral("snes"), id_b);
+    QCOMPARE(AssetResolver::findGame(resolver.findDir(QStringLiteral("snes")), file_b.leftRef(5)), id_b);
+
+    // the aliases are not shared with the other resolvers of the same search
+    AssetResolver other_resolver(games);
+    QVERIFY(other_resolver.findDir(QStringLiteral("snes")) == nullptr);
+    QVERIFY(games.pathIndex().findDir(QStringLiteral("snes")) == nullptr);
+}
+
+void test_AssetResolver::first_file_wins()
+{
+    modeldata::GameStore games;
+    const modeldata::GameId game_id = add_game(games, QStringLiteral("/roms"), QStringLiteral("a.bin"));
+
+    AssetResolver resolver(games);
+    QVERIFY(resolver.addFile(game_id, AssetType::LOGO, QStringLiteral("/media"), QStringLiteral("logo1.png")));
+    QVERIFY(!resolver.addFile(game_id, AssetType::LOGO, QStringLiteral("/media"), QStringLiteral("logo2.png")));
+    QVERIFY(!resolver.addFile(game_id, AssetType::UNKNOWN, QStringLiteral("/media"), QStringLiteral("x.txt")));
+    QVERIFY(!resolver.addFile(modeldata::INVALID_GAMEID, AssetType::LOGO, QStringLiteral("/media"), QStringLiteral("x.png")));
+    QVERIFY(resolver.addFile(game_id, AssetType::SCREENSHOTS, QStringLiteral("/media"), QStringLiteral("shot.png")));
+    QVERIFY(!resolver.addFile(game_id, AssetType::SCREENSHOTS, QStringLiteral("/media"), QStringLiteral("shot.png")));
+    QCOMPARE(resolver.addedCount(), static_cast<size_t>(2));
+
+    QCOMPARE(games.at(game_id).assets.single(AssetType::LOGO).url(),
+             QUrl::fromLocalFile(QStringLiteral("/media/logo1.png")).toString());
+}
+
+void test_AssetResolver::mirrored_dirs()
+{
+    QTemporaryDir tmp_dir;
+    QVERIFY(tmp_dir.isValid());
+
+    QDir root(tmp_dir.path());
+    QVERIFY(root.mkpath("games/sub"));
+    QVERIFY(root.mkpath("games/media/sub/mygame"));
+
+    const QString games_dir = QFileInfo(tmp_dir.path() + "/games").canonicalFilePath();
+    const QString media_dir = games_dir + "/media";
+
+    modeldata::GameStore games;
+    AssetResolver resolver(games);
+
+    QStringList found;
+    resolver.forEachMirroredDir(games_dir, media_dir,
+        [&](const QString& game_dir_path, const QString& dir_path, const filesystem::DirListing&){
+            QVERIFY(dir_path.startsWith(media_dir));
+            found << game_dir_path;
+        });
+    found.sort();
+
+    const QStringList expected {
+        games_dir,
+        games_dir + "/sub",
+        games_dir + "/sub/mygame",
+    };
+    QCOMPARE(found, expected);
+}
+
+
+QTEST_MAIN(test_AssetResolver)
+#include "test_AssetResolver.moc"
@@ -18,7 +18,8 @@
 #include <QtTest/QtTest>
 
 #include "model/gaming/Collection.h"
-#include "model/gaming/Game.h"
+#include "model/gaming/GameLibrary.h"
+#include "providers/ModelSync.h"
 #include "providers/pegasus_favorites/Favorites.h"
 #include "utils/HashMap.h"
 
@@ -35,17 +36,18 @@ private slots:
 
 void test_FavoriteDB::write()
 {
+    model::GameLibrary library;
     QVector<model::Collection*> collections = {
-        new model::Collection(modeldata::Collection("coll1"), this),
-        new model::Collection(modeldata::Collection("coll2"), this),
+        new model::Collection(modeldata::Collection("coll1"), library, &library),
+        new model::Collection(modeldata::Collection("coll2"), library, &library),
     };
-    QVector<model::Game*> games = {
-        new model::Game(modeldata::Game(QFileInfo(":/a/b/coll1dummy1")), this),
-        new model::Game(modeldata::Game(QFileInfo(":/coll1dummy2")), this),
-        new model::Game(modeldata::Game(QFileInfo(":/x/y/z/coll2dummy1")), this),
+    QVector<model::GameSlot> games = {
+        library.add(modeldata::Game(QFileInfo(":/a/b/coll1dummy1"))),
+        library.add(modeldata::Game(QFileInfo(":/coll1dummy2"))),
+        library.add(modeldata::Game(QFileInfo(":/x/y/z/coll2dummy1"))),
     };
-    games.at(1)->setFavorite(true);
-    games.at(2)->setFavorite(true);
+    library.setFavorite(games.at(1), true);
+    library.setFavorite(games.at(2), true);
 
     collections.at(0)->setGameList({ games.at(0), games.at(1) });
     collections.at(1)->setGameList({ games.at(2) });
@@ -65,7 +67,7 @@ void test_FavoriteDB::write()
     QVERIFY(spy_start.isValid());
     QVERIFY(spy_end.isValid());
 
-    favorite_db.onGameFavoriteChanged(games);
+    favorite_db.onGameFavoriteChanged(library, games);
 
     QVERIFY(spy_start.count() || spy_start.wait());
     QVERIFY(spy_end.count() || spy_end.wait());
@@ -93,14 +95,15 @@ void test_FavoriteDB::write()
 
 void test_FavoriteDB::rewrite_empty()
 {
+    model::GameLibrary library;
     QVector<model::Collection*> collections = {
-        new model::Collection(modeldata::Collection("coll1"), this),
-        new model::Collection(modeldata::Collection("coll2"), this),
+        new model::Collection(modeldata::Collection("coll1"), library, &library),
+        new model::Collection(modeldata::Collection("coll2"), library, &library),
     };
-    QVector<model::Game*> games = {
-        new model::Game(modeldata::Game(QFileInfo(":/a/b/coll1dummy1")), this),
-        new model::Game(modeldata::Game(QFileInfo(":/coll1dummy2")), this),
-        new model::Game(modeldata::Game(QFileInfo(":/x/y/z/coll2dummy1")), this),
+    QVector<model::GameSlot> games = {
+        library.add(modeldata::Game(QFileInfo(":/a/b/coll1dummy1"))),
+        library.add(modeldata::Game(QFileInfo(":/coll1dummy2"))),
+        library.add(modeldata::Game(QFileInfo(":/x/y/z/coll2dummy1"))),
     };
     collections.at(0)->setGameList({ games.at(0), games.at(1) });
     collections.at(1)->setGameList({ games.at(2) });
@@ -117,11 +120,11 @@ void test_FavoriteDB::rewrite_empty()
     QSignalSpy spy_end(&favorite_db, &providers::favorites::Favorites::finishedWriting);
     QVERIFY(spy_end.isValid());
 
-    games.at(1)->setFavorite(true);
-    favorite_db.onGameFavoriteChanged(games);
+    library.setFavorite(games.at(1), true);
+    favorite_db.onGameFavoriteChanged(library, games);
 
-    games.at(1)->setFavorite(false);
-    favorite_db.onGameFavoriteChanged(games);
+    library.setFavorite(games.at(1), false);
+    favorite_db.onGameFavoriteChanged(library, games);
 
     QVERIFY(spy_end.count() == 2 || spy_end.wait());
 
@@ -143,10 +146,11 @@ void test_FavoriteDB::rewrite_empty()
 
 void test_FavoriteDB::read()
 {
-    QVector<model::Game*> games = {
-        new model::Game(modeldata::Game(QFileInfo(":/a/b/coll1dummy1")), this),
-        new model::Game(modeldata::Game(QFileInfo(":/coll1dummy2")), this),
-        new model::Game(modeldata::Game(QFileInfo(":/x/y/z/coll2dummy1")), this),
+    model::GameLibrary library;
+    QVector<model::GameSlot> games = {
+        library.add(modeldata::Game(QFileInfo(":/a/b/coll1dummy1"))),
+        library.add(modeldata::Game(QFileInfo(":/coll1dummy2"))),
+        library.add(modeldata::Game(QFileInfo(":/x/y/z/coll2dummy1"))),
     };
 
     QTemporaryFile tmp_file;
@@ -155,8 +159,8 @@ void test_FavoriteDB::read()
     {
         QTextStream tmp_stream(&tmp_file);
         tmp_stream << QStringLiteral("# Favorite reader test") << endl;
-        tmp_stream << games[2]->data().fileinfo().canonicalFilePath() << endl;
-        tmp_stream << games[1]->data().fileinfo().canonicalFilePath() << endl;
+        tmp_stream << library.at(games[2]).path().canonicalFilePath() << endl;
+        tmp_stream << library.at(games[1]).path().canonicalFilePath() << endl;
         tmp_stream << QStringLiteral(":/somethingfake") << endl;
     }
     const QString db_path = tmp_file.fileName();
@@ -164,16 +168,18 @@ void test_FavoriteDB::read()
 
     providers::favorites::Favorites favorite_db(db_path);
 
-    QVector<model::Collection*> collections;
-    HashMap<QString, model::Game*> modelgame_map;
-    for (model::Game* const game : games)
-        modelgame_map.emplace(game->data().fileinfo().canonicalFilePath(), game);
+    HashMap<QString, model::GameSlot> slot_map;
+    for (const model::GameSlot slot : games)
+        slot_map.emplace(library.at(slot).path().canonicalFilePath(), slot);
 
-    favorite_db.findDynamicData(games, collections, modelgame_map);
+    providers::sync::DynamicData dynamic_data;
+    favorite_db.findDynamicData(dynamic_data, slot_map);
+    QCOMPARE(dynamic_data.favorites.size(), static_cast<size_t>(2));
+    providers::sync::apply_dynamic_data(dynamic_data, library);
 
-    QVERIFY(!games[0]->data().is_favorite);
-    QVERIFY(games[1]->data().is_favorite);
-    QVERIFY(games[2]->data().is_favorite);
+    QVERIFY(!library.at(games[0]).is_favorite);
+    QVERIFY(library.at(games[1]).is_favorite);
+    QVERIFY(library.at(games[2]).is_favorite);
 
     QFile::remove(db_path);
 }
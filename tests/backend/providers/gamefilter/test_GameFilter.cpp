@@ -0,0 +1,219 @@
+// Pegasus Frontend
+// Copyright (C) 2018  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <QtTest/QtTest>
+
+#include "providers/pegasus/PegasusFilter.h"
+
+
+using providers::pegasus::GameFilter;
+
+namespace {
+const QString FILTER_DIR = QStringLiteral("/games/snes");
+
+bool accepts(const GameFilter& filter, const QString& relative_path)
+{
+    const QString path = FILTER_DIR + QLatin1Char('/') + relative_path;
+    const int last_dot = path.lastIndexOf(QLatin1Char('.'));
+    const QStringRef suffix = last_dot < 0 ? QStringRef() : path.midRef(last_dot + 1);
+    return filter.accepts(FILTER_DIR, path, suffix);
+}
+} // namespace
+
+
+class test_GameFilter : public QObject {
+    Q_OBJECT
+
+private slots:
+    void extensions();
+    void files();
+    void globs_data();
+    void globs();
+    void bracketed_files();
+    void regex_data();
+    void regex();
+    void exclude();
+};
+
+void test_GameFilter::extensions()
+{
+    GameFilter filter(QStringLiteral("coll"), FILTER_DIR);
+    filter.include.extensions << QStringLiteral("sfc") << QStringLiteral("smc");
+    filter.compile();
+
+    QVERIFY(accepts(filter, QStringLiteral("game.sfc")));
+    QVERIFY(accepts(filter, QStringLiteral("sub/game.smc")));
+    QVERIFY(!accepts(filter, QStringLiteral("game.zip")));
+    QVERIFY(!accepts(filter, QStringLiteral("sfc")));
+}
+
+void test_GameFilter::files()
+{
+    GameFilter filter(QStringLiteral("coll"), FILTER_DIR);
+    for (int i = 0; i < 1000; i++)
+        filter.include.files << QStringLiteral("game %1.bin").arg(i);
+    filter.compile();
+
+    QVERIFY(accepts(filter, QStringLiteral("game 0.bin")));
+    QVERIFY(accepts(filter, QStringLiteral("game 999.bin")));
+    QVERIFY(!accepts(filter, QStringLiteral("game 1000.bin")));
+    QVERIFY(!accepts(filter, QStringLiteral("sub/game 1.bin")));
+}
+
+void test_GameFilter::globs_data()
+{
+    QTest::addColumn<QString>("glob");
+    QTest::addColumn<QString>("relative_path");
+    QTest::addColumn<bool>("result");
+
+    QTest::newRow("star") << "*.cue" << "game.cue" << true;
+    QTest::newRow("star, other ext") << "*.cue" << "game.bin" << false;
+    QTest::newRow("star, subdir") << "*.cue" << "sub/game.cue" << false;
+    QTest::newRow("double star") << "**/*.cue" << "a/b/game.cue" << true;
+    QTest::newRow("double star, no subdir") << "**/*.cue" << "game.cue" << true;
+    QTest::newRow("question mark") << "disc?.iso" << "disc1.iso" << true;
+    QTest::newRow("question mark, too long") << "disc?.iso" << "disc10.iso" << false;
+    QTest::newRow("set") << "disc[12].iso" << "disc2.iso" << true;
+    QTest::newRow("set, other") << "disc[12].iso" << "disc3.iso" << false;
+    QTest::newRow("negated set") << "disc[!12].iso" << "disc3.iso" << true;
+    QTest::newRow("regex chars") << "game (*).zip" << "game (USA).zip" << true;
+    QTest::newRow("regex chars, no match") << "game (*).zip" << "game USA.zip" << false;
+    QTest::newRow("tag") << "Game (USA) [!].zip" << "Game (USA) [!].zip" << true;
+    QTest::newRow("tag, other") << "Game (USA) [!].zip" << "Game (USA).zip" << false;
+    QTest::newRow("tag as set") << "Game [b].zip" << "Game b.zip" << true;
+    QTest::newRow("tag with star") << "Game (*) [!].zip" << "Game (USA) [!].zip" << true;
+    QTest::newRow("tag with star, no tag") << "Game (*) [!].zip" << "Game (USA).zip" << false;
+    QTest::newRow("unclosed bracket") << "Game [a.zip" << "Game [a.zip" << true;
+}
+
+void test_GameFilter::globs()
+{
+    QFETCH(QString, glob);
+    QFETCH(QString, relative_path);
+    QFETCH(bool, result);
+
+    GameFilter filter(QStringLiteral("coll"), FILTER_DIR);
+    filter.include.file_globs << glob;
+    filter.compile();
+
+    QCOMPARE(accepts(filter, relative_path), result);
+}
+
+void test_GameFilter::bracketed_files()
+{
+    GameFilter filter(QStringLiteral("coll"), FILTER_DIR);
+    filter.include.files
+        << QStringLiteral("Game (USA) [!].zip")
+        << QStringLiteral("Game (Europe) [b].zip")
+        << QStringLiteral("Zelda (U) [b1].nes")
+        << QStringLiteral("Zelda (E) [h1C].nes");
+    filter.include.file_globs
+        << QStringLiteral("*.cue")
+        << QStringLiteral("disc[12].iso");
+    filter.compile();
+
+    QVERIFY(accepts(filter, QStringLiteral("Game (USA) [!].zip")));
+    QVERIFY(accepts(filter, QStringLiteral("Game (Europe) [b].zip")));
+    QVERIFY(!accepts(filter, QStringLiteral("Game (Japan) [!].zip")));
+    // the plain file entries are not patterns
+    QVERIFY(!accepts(filter, QStringLiteral("Game (Europe) b.zip")));
+    QVERIFY(accepts(filter, QStringLiteral("Zelda (U) [b1].nes")));
+    QVERIFY(!accepts(filter, QStringLiteral("Zelda (U) b.nes")));
+    QVERIFY(!accepts(filter, QStringLiteral("Zelda (U) 1.nes")));
+    QVERIFY(accepts(filter, QStringLiteral("Zelda (E) [h1C].nes")));
+    QVERIFY(!accepts(filter, QStringLiteral("Zelda (E) h.nes")));
+
+    // the other globs of the group still work
+    QVERIFY(accepts(filter, QStringLiteral("game.cue")));
+    QVERIFY(accepts(filter, QStringLiteral("disc2.iso")));
+    QVERIFY(!accepts(filter, QStringLiteral("disc3.iso")));
+
+    // and neither are the excluded ones
+    GameFilter ignoring(QStringLiteral("coll"), FILTER_DIR);
+    ignoring.include.extensions << QStringLiteral("nes");
+    ignoring.exclude.files << QStringLiteral("Zelda (J) [a2].nes");
+    ignoring.compile();
+    QVERIFY(!accepts(ignoring, QStringLiteral("Zelda (J) [a2].nes")));
+    QVERIFY(accepts(ignoring, QStringLiteral("Zelda (J) a.nes")));
+    QVERIFY(accepts(ignoring, QStringLiteral("Zelda (J) 2.nes")));
+}
+
+void test_GameFilter::regex_data()
+{
+    QTest::addColumn<QString>("pattern");
+    QTest::addColumn<QString>("relative_path");
+    QTest::addColumn<bool>("result");
+
+    QTest::newRow("literal suffix") << "\\.zip$" << "game.zip" << true;
+    QTest::newRow("literal suffix, no match") << "\\.zip$" << "game.7z" << false;
+    QTest::newRow("optional char") << "disco?\\.bin" << "disc.bin" << true;
+    QTest::newRow("alternatives") << "\\.(zip|7z)$" << "game.7z" << true;
+    QTest::newRow("group") << "(USA)\\.zip$" << "game (USA).zip" << true;
+    QTest::newRow("set and literal") << "[0-9]+-disc" << "game 2-disc.bin" << true;
+    QTest::newRow("case insensitive") << "(?i)\\.ZIP$" << "game.zip" << true;
+    QTest::newRow("full path") << "^/games/snes/game" << "game.bin" << true;
+    QTest::newRow("counted set") << "\\(([0-9]{4})\\)" << "game (1994).zip" << true;
+    QTest::newRow("counted set, no match") << "\\(([0-9]{4})\\)" << "game (94).zip" << false;
+    QTest::newRow("counted char") << "ab{2}c" << "abbc.bin" << true;
+    QTest::newRow("counted char, no match") << "ab{2}c" << "abc.bin" << false;
+    QTest::newRow("counted range") << "disc-x{1,3}\\.bin" << "disc-xx.bin" << true;
+    QTest::newRow("counted range, zero") << "game-x{0,2}\\.bin" << "game-.bin" << true;
+    QTest::newRow("counted, open") << "[0-9]{2,} players" << "game 12 players.zip" << true;
+    QTest::newRow("literal brace") << "game{\\.bin" << "game{.bin" << true;
+    QTest::newRow("hex escape") << "\\x41BC" << "ABC.bin" << true;
+    QTest::newRow("hex escape, braces") << "\\x{41}BC" << "ABC.bin" << true;
+    QTest::newRow("control escape") << "\\cAfoo" << "\x01" "foo.bin" << true;
+    QTest::newRow("numbered reference") << "(ab)\\g1xyz" << "abab1xyz.bin" << false;
+    QTest::newRow("numbered reference, match") << "(ab)\\g1xyz" << "ababxyz.bin" << true;
+    QTest::newRow("named reference") << "(?<n>ab)\\k<n>xyz" << "ababxyz.bin" << true;
+    QTest::newRow("named character") << "\\N{U+41}BC" << "ABC.bin" << true;
+    QTest::newRow("property") << "\\p{Lu}BC" << "ABC.bin" << true;
+    QTest::newRow("negated property") << "\\P{Ll}BC" << "ABC.bin" << true;
+    QTest::newRow("octal escape") << "\\o{101}BC" << "ABC.bin" << true;
+    QTest::newRow("octal digits") << "\\012ab" << "\nab.bin" << true;
+    QTest::newRow("backreference digit") << "(ab)\\1xyz" << "ababxyz.bin" << true;
+}
+
+void test_GameFilter::regex()
+{
+    QFETCH(QString, pattern);
+    QFETCH(QString, relative_path);
+    QFETCH(bool, result);
+
+    GameFilter filter(QStringLiteral("coll"), FILTER_DIR);
+    filter.include.regex.setPattern(pattern);
+    filter.compile();
+
+    QCOMPARE(accepts(filter, relative_path), result);
+}
+
+void test_GameFilter::exclude()
+{
+    GameFilter filter(QStringLiteral("coll"), FILTER_DIR);
+    filter.include.extensions << QStringLiteral("bin");
+    filter.exclude.files << QStringLiteral("bios.bin");
+    filter.exclude.file_globs << QStringLiteral("**/test*.bin");
+    filter.compile();
+
+    QVERIFY(accepts(filter, QStringLiteral("game.bin")));
+    QVERIFY(!accepts(filter, QStringLiteral("bios.bin")));
+    QVERIFY(!accepts(filter, QStringLiteral("sub/test1.bin")));
+}
+
+
+QTEST_MAIN(test_GameFilter)
+#include "test_GameFilter.moc"
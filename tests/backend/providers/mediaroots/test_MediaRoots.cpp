@@ -0,0 +1,146 @@
+// Pegasus Frontend
+// Copyright (C) 2018  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#include <QtTest/QtTest>
+
+#include "TestFiles.h"
+#include "modeldata/gaming/GameAssetsData.h"
+#include "modeldata/gaming/GameData.h"
+#include "providers/MediaRoots.h"
+#include "types/AssetType.h"
+
+#include <QTemporaryDir>
+
+
+namespace {
+modeldata::GamePath game_path(const QString& dir_path, const QString& file_name)
+{
+    const QString file_path = dir_path + QLatin1Char('/') + file_name;
+    return modeldata::GamePath(dir_path, file_name, QFileInfo(file_path).canonicalFilePath());
+}
+
+QString file_url(const QString& path)
+{
+    return QUrl::fromLocalFile(path).toString();
+}
+} // namespace
+
+
+class test_MediaRoots : public QObject {
+    Q_OBJECT
+
+private slots:
+    void missing_dirs();
+    void named_root();
+    void typed_root();
+    void clear_index();
+};
+
+void test_MediaRoots::missing_dirs()
+{
+    QTemporaryDir tmp_dir;
+    QVERIFY(tmp_dir.isValid());
+
+    providers::MediaRoots roots;
+    roots.addNamedRoot(tmp_dir.path(), tmp_dir.path() + "/media");
+    roots.addTypedRoot(tmp_dir.path() + "/missing", tmp_dir.path(), AssetType::LOGO);
+    QVERIFY(roots.empty());
+}
+
+void test_MediaRoots::named_root()
+{
+    QTemporaryDir tmp_dir;
+    QVERIFY(tmp_dir.isValid());
+
+    QVERIFY(touch(tmp_dir.path() + "/games/sub/mygame.bin"));
+    QVERIFY(touch(tmp_dir.path() + "/games/sub/other.bin"));
+    QVERIFY(touch(tmp_dir.path() + "/games/media/sub/mygame/logo.png"));
+    QVERIFY(touch(tmp_dir.path() + "/games/media/sub/mygame/video.mp4"));
+    QVERIFY(touch(tmp_dir.path() + "/games/media/sub/mygame/notes.txt"));
+
+    const QString games_dir = QFileInfo(tmp_dir.path() + "/games").canonicalFilePath();
+    const QString media_dir = games_dir + "/media/sub/mygame";
+
+    providers::MediaRoots roots;
+    roots.addNamedRoot(games_dir, games_dir + "/media");
+    QCOMPARE(roots.size(), static_cast<size_t>(1));
+
+    modeldata::GameAssets assets;
+    roots.findAssets(game_path(games_dir + "/sub", QStringLiteral("mygame.bin")), assets);
+    QCOMPARE(assets.single(AssetType::LOGO).url(), file_url(media_dir + "/logo.png"));
+    QCOMPARE(assets.multi(AssetType::VIDEOS).size(), 1);
+    QCOMPARE(assets.multi(AssetType::VIDEOS).first().url(), file_url(media_dir + "/video.mp4"));
+
+    modeldata::GameAssets other_assets;
+    roots.findAssets(game_path(games_dir + "/sub", QStringLiteral("other.bin")), other_assets);
+    QVERIFY(other_assets.single(AssetType::LOGO).isEmpty());
+}
+
+void test_MediaRoots::typed_root()
+{
+    QTemporaryDir tmp_dir;
+    QVERIFY(tmp_dir.isValid());
+
+    QVERIFY(touch(tmp_dir.path() + "/games/mygame.bin"));
+    QVERIFY(touch(tmp_dir.path() + "/games/media/wheel/mygame.png"));
+    QVERIFY(touch(tmp_dir.path() + "/games/media/wheel/mygame2.png"));
+    QVERIFY(touch(tmp_dir.path() + "/games/media/wheelcarbon/mygame.png"));
+
+    const QString games_dir = QFileInfo(tmp_dir.path() + "/games").canonicalFilePath();
+
+    providers::MediaRoots roots;
+    roots.addTypedRoot(games_dir, games_dir + "/media/wheel", AssetType::LOGO);
+    roots.addTypedRoot(games_dir, games_dir + "/media/wheelcarbon", AssetType::LOGO);
+    QCOMPARE(roots.size(), static_cast<size_t>(2));
+
+    // the roots added first take priority
+    modeldata::GameAssets assets;
+    roots.findAssets(game_path(games_dir, QStringLiteral("mygame.bin")), assets);
+    QCOMPARE(assets.single(AssetType::LOGO).url(), file_url(games_dir + "/media/wheel/mygame.png"));
+}
+
+void test_MediaRoots::clear_index()
+{
+    QTemporaryDir tmp_dir;
+    QVERIFY(tmp_dir.isValid());
+
+    QVERIFY(touch(tmp_dir.path() + "/games/mygame.bin"));
+    QVERIFY(touch(tmp_dir.path() + "/games/media/wheel/other.png"));
+
+    const QString games_dir = QFileInfo(tmp_dir.path() + "/games").canonicalFilePath();
+
+    providers::MediaRoots roots;
+    roots.addTypedRoot(games_dir, games_dir + "/media/wheel", AssetType::LOGO);
+
+    modeldata::GameAssets assets;
+    roots.findAssets(game_path(games_dir, QStringLiteral("mygame.bin")), assets);
+    QVERIFY(assets.single(AssetType::LOGO).isEmpty());
+
+    // the directory is only read again after clearing the index
+    QVERIFY(touch(tmp_dir.path() + "/games/media/wheel/mygame.png"));
+    roots.findAssets(game_path(games_dir, QStringLiteral("mygame.bin")), assets);
+    QVERIFY(assets.single(AssetType::LOGO).isEmpty());
+
+    roots.clearIndex();
+    roots.findAssets(game_path(games_dir, QStringLiteral("mygame.bin")), assets);
+    QCOMPARE(assets.single(AssetType::LOGO).url(), file_url(games_dir + "/media/wheel/mygame.png"));
+}
+
+
+QTEST_MAIN(test_MediaRoots)
+#include "test_MediaRoots.moc"
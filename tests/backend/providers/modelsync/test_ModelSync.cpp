@@ -0,0 +1,302 @@
+// Pegasus Frontend
+// Copyright (C) 2018  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <QtTest/QtTest>
+
+#include "model/gaming/Collection.h"
+#include "model/gaming/Game.h"
+#include "model/gaming/GameLibrary.h"
+#include "model/gaming/GameListModel.h"
+#include "modeldata/gaming/GameStore.h"
+#include "providers/ModelSync.h"
+
+#include "QtQmlTricks/QQmlObjectListModel.h"
+
+
+namespace {
+void add_game(providers::sync::Library& library, const QString& coll_name, const QString& title)
+{
+    const QString path = QStringLiteral("/roms/") + title;
+
+    modeldata::Game game(QFileInfo{path});
+    game.title = title;
+    const modeldata::GameId game_id = library.games.add(path, std::move(game));
+
+    if (!library.collections.count(coll_name))
+        library.collections.emplace(coll_name, modeldata::Collection(coll_name));
+    library.collection_childs[coll_name].push_back(game_id);
+}
+
+modeldata::Game& game_by_key(providers::sync::Library& library, const QString& key)
+{
+    const modeldata::GameId game_id = library.games.find(key);
+    Q_ASSERT(game_id != modeldata::INVALID_GAMEID);
+    return library.games.at(game_id);
+}
+
+QStringList titles(const model::GameListModel& model)
+{
+    QStringList result;
+    for (const model::GameSlot slot : model.asList())
+        result << model.library().at(slot).title;
+    return result;
+}
+} // namespace
+
+
+class test_ModelSync : public QObject {
+    Q_OBJECT
+
+private:
+    model::GameLibrary* game_library;
+    model::GameListModel* game_model;
+    QQmlObjectListModel<model::Collection>* collection_model;
+    HashMap<QString, model::GameSlot> gameid_to_slot;
+
+private slots:
+    void init();
+    void cleanup();
+
+    void sort_library();
+    void merge_list_results();
+    void merge_list_results_data();
+    void add_missing();
+    void apply();
+    void apply_reorder();
+    void apply_reorder_data();
+    void remove_games();
+};
+
+void test_ModelSync::init()
+{
+    game_library = new model::GameLibrary();
+    game_model = new model::GameListModel(*game_library);
+    collection_model = new QQmlObjectListModel<model::Collection>();
+    gameid_to_slot.clear();
+}
+
+void test_ModelSync::cleanup()
+{
+    delete collection_model;
+    delete game_model;
+    delete game_library;
+}
+
+void test_ModelSync::sort_library()
+{
+    providers::sync::Library library;
+    add_game(library, QStringLiteral("coll"), QStringLiteral("c"));
+    add_game(library, QStringLiteral("coll"), QStringLiteral("a"));
+    add_game(library, QStringLiteral("coll"), QStringLiteral("b"));
+    // a duplicate and an invalid entry
+    library.collection_childs[QStringLiteral("coll")].push_back(library.games.find(QStringLiteral("/roms/a")));
+    library.collection_childs[QStringLiteral("coll")].push_back(modeldata::INVALID_GAMEID);
+
+    providers::sync::sort_library(library);
+
+    const std::vector<modeldata::GameId> expected {
+        library.games.find(QStringLiteral("/roms/a")),
+        library.games.find(QStringLiteral("/roms/b")),
+        library.games.find(QStringLiteral("/roms/c")),
+    };
+    QCOMPARE(library.game_order, expected);
+    QCOMPARE(library.collection_childs.at(QStringLiteral("coll")), expected);
+}
+
+void test_ModelSync::merge_list_results_data()
+{
+    QTest::addColumn<QStringList>("order");
+    QTest::addColumn<QString>("expected_cmd");
+
+    QTest::newRow("in order") << QStringList({"coll A", "coll B"}) << QStringLiteral("launch A");
+    QTest::newRow("reversed") << QStringList({"coll B", "coll A"}) << QStringLiteral("launch B");
+    QTest::newRow("unordered") << QStringList() << QStringLiteral("launch A");
+}
+
+void test_ModelSync::merge_list_results()
+{
+    QFETCH(QStringList, order);
+    QFETCH(QString, expected_cmd);
+
+    // a previous provider only set the launch command of one collection
+    modeldata::GameStore games;
+    HashMap<QString, modeldata::Collection> collections;
+    HashMap<QString, std::vector<modeldata::GameId>> collection_childs;
+    collections.emplace(QStringLiteral("coll B"), modeldata::Collection(QStringLiteral("coll B")));
+    collections.at(QStringLiteral("coll B")).launch_cmd = QStringLiteral("launch B");
+
+    // one game without a launch command, in two collections
+    providers::sync::ListResults results;
+    const modeldata::GameId game_id = results.games.add(QStringLiteral("/roms/game"),
+        modeldata::Game(QFileInfo(QStringLiteral("/roms/game"))));
+    for (const QString& coll_name : {QStringLiteral("coll A"), QStringLiteral("coll B")}) {
+        results.collections.emplace(coll_name, modeldata::Collection(coll_name));
+        results.collection_childs[coll_name].push_back(game_id);
+    }
+    results.collections.at(QStringLiteral("coll A")).launch_cmd = QStringLiteral("launch A");
+    for (const QString& coll_name : qAsConst(order))
+        results.collection_order.push_back(coll_name);
+
+    providers::sync::merge_list_results(results, games, collections, collection_childs);
+
+    QCOMPARE(games.size(), static_cast<size_t>(1));
+    QCOMPARE(games.at(games.find(QStringLiteral("/roms/game"))).launch_cmd, expected_cmd);
+    QCOMPARE(collection_childs.at(QStringLiteral("coll A")).size(), static_cast<size_t>(1));
+    QCOMPARE(collection_childs.at(QStringLiteral("coll B")).size(), static_cast<size_t>(1));
+}
+
+void test_ModelSync::add_missing()
+{
+    providers::sync::Library first;
+    add_game(first, QStringLiteral("coll A"), QStringLiteral("b"));
+    add_game(first, QStringLiteral("coll A"), QStringLiteral("d"));
+    providers::sync::sort_library(first);
+    providers::sync::add_missing(first, *game_model, *collection_model, gameid_to_slot);
+
+    const model::GameSlot game_b = game_model->at(0);
+    QCOMPARE(titles(*game_model), QStringList({"b", "d"}));
+
+    providers::sync::Library second;
+    add_game(second, QStringLiteral("coll B"), QStringLiteral("b"));
+    add_game(second, QStringLiteral("coll A"), QStringLiteral("a"));
+    add_game(second, QStringLiteral("coll A"), QStringLiteral("c"));
+    providers::sync::sort_library(second);
+    const QVector<model::GameSlot> new_games = providers::sync::add_missing(
+        second, *game_model, *collection_model, gameid_to_slot);
+
+    QCOMPARE(new_games.count(), 2);
+    QCOMPARE(game_model->at(1), game_b);
+    QCOMPARE(titles(*game_model), QStringList({"a", "b", "c", "d"}));
+    QCOMPARE(gameid_to_slot.size(), static_cast<size_t>(4));
+
+    QCOMPARE(collection_model->count(), 2);
+    QCOMPARE(collection_model->at(0)->name(), QStringLiteral("coll A"));
+    QCOMPARE(titles(collection_model->at(0)->games()), QStringList({"a", "b", "c", "d"}));
+    QCOMPARE(titles(collection_model->at(1)->games()), QStringList({"b"}));
+}
+
+void test_ModelSync::apply()
+{
+    providers::sync::Library first;
+    add_game(first, QStringLiteral("coll A"), QStringLiteral("a"));
+    add_game(first, QStringLiteral("coll A"), QStringLiteral("b"));
+    add_game(first, QStringLiteral("coll B"), QStringLiteral("c"));
+    providers::sync::sort_library(first);
+    providers::sync::add_missing(first, *game_model, *collection_model, gameid_to_slot);
+
+    const model::GameSlot slot_a = gameid_to_slot.at(QStringLiteral("/roms/a"));
+    model::Game* const game_a = game_library->object(slot_a);
+    model::Collection* const coll_a = collection_model->at(0);
+    QSignalSpy data_spy(game_a, &model::Game::dataChanged);
+    QSignalSpy insert_spy(game_model, &QAbstractItemModel::rowsInserted);
+    QSignalSpy reset_spy(game_model, &QAbstractItemModel::modelReset);
+    QSignalSpy row_data_spy(game_model, &QAbstractItemModel::dataChanged);
+
+    providers::sync::Library second;
+    add_game(second, QStringLiteral("coll A"), QStringLiteral("a"));
+    add_game(second, QStringLiteral("coll A"), QStringLiteral("d"));
+    game_by_key(second, QStringLiteral("/roms/a")).summary = QStringLiteral("summary");
+    providers::sync::sort_library(second);
+    const QVector<model::GameSlot> new_games = providers::sync::apply(
+        second, *game_model, *collection_model, gameid_to_slot);
+
+    QCOMPARE(new_games.count(), 1);
+    QCOMPARE(game_library->at(new_games.first()).title, QStringLiteral("d"));
+    QCOMPARE(game_model->at(0), slot_a);
+    QCOMPARE(game_library->object(slot_a), game_a);
+    QCOMPARE(game_a->summary(), QStringLiteral("summary"));
+    QCOMPARE(data_spy.count(), 1);
+    QCOMPARE(insert_spy.count(), 1);
+    QCOMPARE(reset_spy.count(), 0);
+    QVERIFY(row_data_spy.count() > 0);
+    QCOMPARE(titles(*game_model), QStringList({"a", "d"}));
+    QCOMPARE(gameid_to_slot.size(), static_cast<size_t>(2));
+
+    // the slots of the removed games are reused
+    game_library->add(modeldata::Game(QFileInfo("e")));
+    QCOMPARE(game_library->slotCount(), static_cast<size_t>(4));
+
+    QCOMPARE(collection_model->count(), 1);
+    QCOMPARE(collection_model->at(0), coll_a);
+    QCOMPARE(titles(coll_a->games()), QStringList({"a", "d"}));
+}
+
+void test_ModelSync::apply_reorder_data()
+{
+    QTest::addColumn<int>("game_count");
+    QTest::addColumn<int>("moved_count");
+
+    QTest::newRow("single") << 100 << 1;
+    QTest::newRow("few") << 100 << 10;
+    QTest::newRow("all") << 500 << 500;
+}
+
+void test_ModelSync::apply_reorder()
+{
+    QFETCH(int, game_count);
+    QFETCH(int, moved_count);
+
+    providers::sync::Library first;
+    for (int i = 0; i < game_count; i++)
+        add_game(first, QStringLiteral("coll"), QStringLiteral("%1").arg(i, 4, 10, QChar('0')));
+    providers::sync::sort_library(first);
+    providers::sync::add_missing(first, *game_model, *collection_model, gameid_to_slot);
+
+    // give new titles to some of the games, changing their order
+    providers::sync::Library second;
+    for (int i = 0; i < game_count; i++)
+        add_game(second, QStringLiteral("coll"), QStringLiteral("%1").arg(i, 4, 10, QChar('0')));
+    for (int i = 0; i < moved_count; i++) {
+        const QString key = QStringLiteral("/roms/%1").arg(i * (game_count / moved_count), 4, 10, QChar('0'));
+        game_by_key(second, key).title = QStringLiteral("x%1").arg(moved_count - i, 4, 10, QChar('0'));
+    }
+    providers::sync::sort_library(second);
+    providers::sync::apply(second, *game_model, *collection_model, gameid_to_slot);
+
+    const QStringList result = titles(*game_model);
+    QStringList expected = result;
+    std::sort(expected.begin(), expected.end());
+    QCOMPARE(result, expected);
+    QCOMPARE(result.count(), game_count);
+    QCOMPARE(titles(collection_model->at(0)->games()), expected);
+}
+
+void test_ModelSync::remove_games()
+{
+    providers::sync::Library library;
+    for (const QString& title : { "a", "b", "c", "d", "e", "f" })
+        add_game(library, QStringLiteral("coll"), title);
+    providers::sync::sort_library(library);
+    providers::sync::add_missing(library, *game_model, *collection_model, gameid_to_slot);
+
+    const QSet<model::GameSlot> removed {
+        game_model->at(1), game_model->at(2), game_model->at(3), game_model->at(5),
+    };
+
+    // one row change for every contiguous range
+    QSignalSpy spy(game_model, &QAbstractItemModel::rowsRemoved);
+    providers::sync::remove_games(*game_model, removed);
+    QCOMPARE(spy.count(), 2);
+    QCOMPARE(titles(*game_model), QStringList({"a", "e"}));
+
+    providers::sync::remove_games(*game_model, {});
+    QCOMPARE(spy.count(), 2);
+}
+
+
+QTEST_MAIN(test_ModelSync)
+#include "test_ModelSync.moc"
@@ -20,6 +20,7 @@
 #include "providers/pegasus/PegasusProvider.h"
 #include "modeldata/gaming/CollectionData.h"
 #include "modeldata/gaming/GameData.h"
+#include "modeldata/gaming/GameStore.h"
 #include "utils/HashMap.h"
 
 #include <QString>
@@ -39,9 +40,9 @@ private slots:
 
 void test_PegasusProvider::find_in_empty_dir()
 {
-    HashMap<QString, modeldata::Game> games;
+    modeldata::GameStore games;
     HashMap<QString, modeldata::Collection> collections;
-    HashMap<QString, std::vector<QString>> collection_childs;
+    HashMap<QString, std::vector<modeldata::GameId>> collection_childs;
 
     providers::pegasus::PegasusProvider provider({QStringLiteral(":/empty")});
     provider.findLists(games, collections, collection_childs);
@@ -53,9 +54,9 @@ void test_PegasusProvider::find_in_empty_dir()
 
 void test_PegasusProvider::find_in_filled_dir()
 {
-    HashMap<QString, modeldata::Game> games;
+    modeldata::GameStore games;
     HashMap<QString, modeldata::Collection> collections;
-    HashMap<QString, std::vector<QString>> collection_childs;
+    HashMap<QString, std::vector<modeldata::GameId>> collection_childs;
 
     QTest::ignoreMessage(QtInfoMsg, "Collections: found `:/filled/collections.txt`");
     providers::pegasus::PegasusProvider provider({QStringLiteral(":/filled")});
@@ -92,25 +93,25 @@ void test_PegasusProvider::find_in_filled_dir()
     const QStringList multi_paths {
         { ":/filled/9999-in-1.ext" },
     };
-    for (const QString& game_key : collection_childs.at(QStringLiteral("My Games"))) {
-        const modeldata::Game& game = games.at(game_key);
-        QCOMPARE(mygames_paths.contains(game.fileinfo().filePath()), true);
+    for (const modeldata::GameId game_id : collection_childs.at(QStringLiteral("My Games"))) {
+        const modeldata::Game& game = games.at(game_id);
+        QCOMPARE(mygames_paths.contains(game.path().filePath()), true);
     }
-    for (const QString& game_key : collection_childs.at(QStringLiteral("Favorite games"))) {
-        const modeldata::Game& game = games.at(game_key);
-        QCOMPARE(faves_paths.contains(game.fileinfo().filePath()), true);
+    for (const modeldata::GameId game_id : collection_childs.at(QStringLiteral("Favorite games"))) {
+        const modeldata::Game& game = games.at(game_id);
+        QCOMPARE(faves_paths.contains(game.path().filePath()), true);
     }
-    for (const QString& game_key : collection_childs.at(QStringLiteral("Multi-game ROMs"))) {
-        const modeldata::Game& game = games.at(game_key);
-        QCOMPARE(multi_paths.contains(game.fileinfo().filePath()), true);
+    for (const modeldata::GameId game_id : collection_childs.at(QStringLiteral("Multi-game ROMs"))) {
+        const modeldata::Game& game = games.at(game_id);
+        QCOMPARE(multi_paths.contains(game.path().filePath()), true);
     }
 }
 
 void test_PegasusProvider::enhance()
 {
-    HashMap<QString, modeldata::Game> games;
+    modeldata::GameStore games;
     HashMap<QString, modeldata::Collection> collections;
-    HashMap<QString, std::vector<QString>> collection_childs;
+    HashMap<QString, std::vector<modeldata::GameId>> collection_childs;
 
     QTest::ignoreMessage(QtInfoMsg, "Collections: found `:/with_meta/collections.txt`");
     QTest::ignoreMessage(QtInfoMsg, "Collections: found `:/with_meta/metadata.txt`");
@@ -126,36 +127,36 @@ void test_PegasusProvider::enhance()
     QCOMPARE(collections.at(collection_name).description, QStringLiteral("this is the description"));
 
     QVERIFY(games.size() == 4);
-    QString game_key;
-
-    game_key = QStringLiteral(":/with_meta/mygame1.ext");
-    QCOMPARE(games.count(game_key) > 0, true);
-    QCOMPARE(games.at(game_key).title, QStringLiteral("My Game 1"));
-    QCOMPARE(games.at(game_key).developers, QStringList({"Dev1", "Dev2"}));
-
-    game_key = QStringLiteral(":/with_meta/mygame2.ext");
-    QCOMPARE(games.count(game_key) > 0, true);
-    QCOMPARE(games.at(game_key).title, QStringLiteral("My Game 2"));
-    QCOMPARE(games.at(game_key).publishers, QStringList({"Publisher with Spaces", "Another Publisher"}));
-
-    game_key = QStringLiteral(":/with_meta/mygame3.ext");
-    QCOMPARE(games.count(game_key) > 0, true);
-    QCOMPARE(games.at(game_key).title, QStringLiteral("mygame3"));
-    QCOMPARE(games.at(game_key).genres, QStringList({"genre1", "genre2", "genre with spaces"}));
-    QCOMPARE(games.at(game_key).player_count, 4);
-
-    game_key = QStringLiteral(":/with_meta/subdir/game_in_subdir.ext");
-    QCOMPARE(games.count(game_key) > 0, true);
-    QCOMPARE(games.at(game_key).title, QStringLiteral("game_in_subdir"));
-    QCOMPARE(games.at(game_key).rating, 0.8f);
-    QCOMPARE(games.at(game_key).release_date, QDate(1998, 5, 1));
+    modeldata::GameId game_id = modeldata::INVALID_GAMEID;
+
+    game_id = games.find(QStringLiteral(":/with_meta/mygame1.ext"));
+    QVERIFY(game_id != modeldata::INVALID_GAMEID);
+    QCOMPARE(games.at(game_id).title, QStringLiteral("My Game 1"));
+    QCOMPARE(games.at(game_id).developers.toStringList(), QStringList({"Dev1", "Dev2"}));
+
+    game_id = games.find(QStringLiteral(":/with_meta/mygame2.ext"));
+    QVERIFY(game_id != modeldata::INVALID_GAMEID);
+    QCOMPARE(games.at(game_id).title, QStringLiteral("My Game 2"));
+    QCOMPARE(games.at(game_id).publishers.toStringList(), QStringList({"Publisher with Spaces", "Another Publisher"}));
+
+    game_id = games.find(QStringLiteral(":/with_meta/mygame3.ext"));
+    QVERIFY(game_id != modeldata::INVALID_GAMEID);
+    QCOMPARE(games.at(game_id).title, QStringLiteral("mygame3"));
+    QCOMPARE(games.at(game_id).genres.toStringList(), QStringList({"genre1", "genre2", "genre with spaces"}));
+    QCOMPARE(games.at(game_id).player_count, 4);
+
+    game_id = games.find(QStringLiteral(":/with_meta/subdir/game_in_subdir.ext"));
+    QVERIFY(game_id != modeldata::INVALID_GAMEID);
+    QCOMPARE(games.at(game_id).title, QStringLiteral("game_in_subdir"));
+    QCOMPARE(games.at(game_id).rating, 0.8f);
+    QCOMPARE(games.at(game_id).release_date, QDate(1998, 5, 1));
 }
 
 void test_PegasusProvider::asset_search()
 {
-    HashMap<QString, modeldata::Game> games;
+    modeldata::GameStore games;
     HashMap<QString, modeldata::Collection> collections;
-    HashMap<QString, std::vector<QString>> collection_childs;
+    HashMap<QString, std::vector<modeldata::GameId>> collection_childs;
 
     providers::pegasus::PegasusProvider provider({QStringLiteral(":/asset_search")});
 
@@ -168,31 +169,33 @@ void test_PegasusProvider::asset_search()
     QVERIFY(collections.count(collection_name) == 1);
     QVERIFY(games.size() == 4);
 
-    auto game_it = games.find(QStringLiteral(":/asset_search/mygame1.ext"));
-    QVERIFY(game_it != games.cend());
-    QCOMPARE(game_it->second.assets.single(AssetType::BOX_FRONT),
+    modeldata::GameId game_id = games.find(QStringLiteral(":/asset_search/mygame1.ext"));
+    QVERIFY(game_id != modeldata::INVALID_GAMEID);
+    QCOMPARE(games.at(game_id).assets.single(AssetType::BOX_FRONT).url(),
              QStringLiteral("file::/asset_search/media/mygame1/box_front.png"));
-    QCOMPARE(game_it->second.assets.multi(AssetType::VIDEOS),
-             { QStringLiteral("file::/asset_search/media/mygame1/video.mp4") });
-
-    game_it = games.find(QStringLiteral(":/asset_search/mygame3.ext"));
-    QVERIFY(game_it != games.cend());
-    QCOMPARE(game_it->second.assets.multi(AssetType::SCREENSHOTS),
-             { QStringLiteral("file::/asset_search/media/mygame3/screenshot.jpg") });
-    QCOMPARE(game_it->second.assets.single(AssetType::MUSIC),
+    QCOMPARE(games.at(game_id).assets.multi(AssetType::VIDEOS).size(), 1);
+    QCOMPARE(games.at(game_id).assets.multi(AssetType::VIDEOS).first().url(),
+             QStringLiteral("file::/asset_search/media/mygame1/video.mp4"));
+
+    game_id = games.find(QStringLiteral(":/asset_search/mygame3.ext"));
+    QVERIFY(game_id != modeldata::INVALID_GAMEID);
+    QCOMPARE(games.at(game_id).assets.multi(AssetType::SCREENSHOTS).size(), 1);
+    QCOMPARE(games.at(game_id).assets.multi(AssetType::SCREENSHOTS).first().url(),
+             QStringLiteral("file::/asset_search/media/mygame3/screenshot.jpg"));
+    QCOMPARE(games.at(game_id).assets.single(AssetType::MUSIC).url(),
              QStringLiteral("file::/asset_search/media/mygame3/music.mp3"));
 
-    game_it = games.find(QStringLiteral(":/asset_search/subdir/mygame4.ext"));
-    QVERIFY(game_it != games.cend());
-    QCOMPARE(game_it->second.assets.single(AssetType::BACKGROUND),
+    game_id = games.find(QStringLiteral(":/asset_search/subdir/mygame4.ext"));
+    QVERIFY(game_id != modeldata::INVALID_GAMEID);
+    QCOMPARE(games.at(game_id).assets.single(AssetType::BACKGROUND).url(),
              QStringLiteral("file::/asset_search/media/subdir/mygame4/background.png"));
 }
 
 void test_PegasusProvider::custom_assets()
 {
-    HashMap<QString, modeldata::Game> games;
+    modeldata::GameStore games;
     HashMap<QString, modeldata::Collection> collections;
-    HashMap<QString, std::vector<QString>> collection_childs;
+    HashMap<QString, std::vector<modeldata::GameId>> collection_childs;
 
     QTest::ignoreMessage(QtInfoMsg, "Collections: found `:/custom_assets/collections.txt`");
     QTest::ignoreMessage(QtInfoMsg, "Collections: found `:/custom_assets/metadata.txt`");
@@ -203,17 +206,17 @@ void test_PegasusProvider::custom_assets()
     QVERIFY(collections.size() == 1);
     QVERIFY(games.size() == 1);
 
-    const QString game_key = QStringLiteral(":/custom_assets/mygame1.ext");
-    QCOMPARE(games.count(game_key) > 0, true);
-    QCOMPARE(games.at(game_key).assets.single(AssetType::BOX_FRONT),
+    const modeldata::GameId game_id = games.find(QStringLiteral(":/custom_assets/mygame1.ext"));
+    QVERIFY(game_id != modeldata::INVALID_GAMEID);
+    QCOMPARE(games.at(game_id).assets.single(AssetType::BOX_FRONT).url(),
              QStringLiteral("file::/custom_assets/different_dir/whatever.png"));
 }
 
 void test_PegasusProvider::custom_directories()
 {
-    HashMap<QString, modeldata::Game> games;
+    modeldata::GameStore games;
     HashMap<QString, modeldata::Collection> collections;
-    HashMap<QString, std::vector<QString>> collection_childs;
+    HashMap<QString, std::vector<modeldata::GameId>> collection_childs;
 
     QTest::ignoreMessage(QtInfoMsg, "Collections: found `:/custom_dirs/coll/collections.txt`");
     providers::pegasus::PegasusProvider provider({QStringLiteral(":/custom_dirs/coll")});
@@ -238,13 +241,13 @@ void test_PegasusProvider::custom_directories()
         { ":/custom_dirs/coll/../b/mygame.y" },
     };
 
-    for (const QString& game_key : collection_childs.at(QStringLiteral("x-files"))) {
-        const modeldata::Game& game = games.at(game_key);
-        QCOMPARE(xfiles.contains(game.fileinfo().canonicalFilePath()), true);
+    for (const modeldata::GameId game_id : collection_childs.at(QStringLiteral("x-files"))) {
+        const modeldata::Game& game = games.at(game_id);
+        QCOMPARE(xfiles.contains(game.path().canonicalFilePath()), true);
     }
-    for (const QString& game_key : collection_childs.at(QStringLiteral("y-files"))) {
-        const modeldata::Game& game = games.at(game_key);
-        QCOMPARE(yfiles.contains(game.fileinfo().canonicalFilePath()), true);
+    for (const modeldata::GameId game_id : collection_childs.at(QStringLiteral("y-files"))) {
+        const modeldata::Game& game = games.at(game_id);
+        QCOMPARE(yfiles.contains(game.path().canonicalFilePath()), true);
     }
 }
 
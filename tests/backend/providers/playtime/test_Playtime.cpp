@@ -18,7 +18,8 @@
 #include <QtTest/QtTest>
 
 #include "model/gaming/Collection.h"
-#include "model/gaming/Game.h"
+#include "model/gaming/GameLibrary.h"
+#include "providers/ModelSync.h"
 #include "providers/pegasus_playtime/PlaytimeStats.h"
 
 #include <QSqlDatabase>
@@ -28,20 +29,20 @@ using PlaytimeStats = providers::playtime::PlaytimeStats;
 
 namespace {
 
-void create_dummy_data(QVector<model::Game*>& games,
+void create_dummy_data(model::GameLibrary& library,
+                       QVector<model::GameSlot>& games,
                        QVector<model::Collection*>& collections,
-                       HashMap<QString, model::Game*>& modelgame_map,
-                       QObject* parent)
+                       HashMap<QString, model::GameSlot>& slot_map)
 {
     collections = {
-        new model::Collection(modeldata::Collection("coll1"), parent),
-        new model::Collection(modeldata::Collection("coll2"), parent),
+        new model::Collection(modeldata::Collection("coll1"), library, &library),
+        new model::Collection(modeldata::Collection("coll2"), library, &library),
     };
     games = {
-        new model::Game(modeldata::Game(QFileInfo("dummy1")), parent),
-        new model::Game(modeldata::Game(QFileInfo("dummy2")), parent),
+        library.add(modeldata::Game(QFileInfo("dummy1"))),
+        library.add(modeldata::Game(QFileInfo("dummy2"))),
     };
-    modelgame_map = {
+    slot_map = {
         { "dummy1", games.at(0) },
         { "dummy2", games.at(1) },
     };
@@ -64,10 +65,11 @@ private slots:
 
 void test_Playtime::read()
 {
-    QVector<model::Game*> games;
+    model::GameLibrary library;
+    QVector<model::GameSlot> games;
     QVector<model::Collection*> collections;
-    HashMap<QString, model::Game*> modelgame_map;
-    create_dummy_data(games, collections, modelgame_map, this);
+    HashMap<QString, model::GameSlot> slot_map;
+    create_dummy_data(library, games, collections, slot_map);
 
     const QString db_path = QDir::tempPath() + QStringLiteral("/data.db");
     QFile::remove(db_path);
@@ -76,20 +78,23 @@ void test_Playtime::read()
 
     PlaytimeStats playtime(db_path);
 
-    playtime.findDynamicData(games, collections, modelgame_map);
+    providers::sync::DynamicData dynamic_data;
+    playtime.findDynamicData(dynamic_data, slot_map);
+    providers::sync::apply_dynamic_data(dynamic_data, library);
 
 
-    QCOMPARE(games.at(0)->data().playcount, 4);
-    QCOMPARE(games.at(0)->data().playtime, 35 /*sec*/);
-    QCOMPARE(games.at(0)->data().last_played, QDateTime::fromSecsSinceEpoch(1531755039));
+    QCOMPARE(library.at(games.at(0)).playcount, 4);
+    QCOMPARE(library.at(games.at(0)).playtime, 35 /*sec*/);
+    QCOMPARE(library.at(games.at(0)).last_played, QDateTime::fromSecsSinceEpoch(1531755039));
 }
 
 void test_Playtime::write()
 {
-    QVector<model::Game*> games;
+    model::GameLibrary library;
+    QVector<model::GameSlot> games;
     QVector<model::Collection*> collections;
-    HashMap<QString, model::Game*> modelgame_map;
-    create_dummy_data(games, collections, modelgame_map, this);
+    HashMap<QString, model::GameSlot> slot_map;
+    create_dummy_data(library, games, collections, slot_map);
 
     QTemporaryFile db_file;
     QVERIFY(db_file.open());
@@ -101,23 +106,24 @@ void test_Playtime::write()
     QSignalSpy spy_end(&playtime, &providers::playtime::PlaytimeStats::finishedWriting);
     QVERIFY(spy_start.isValid() && spy_end.isValid());
 
-    playtime.onGameLaunched(games.at(0));
-    playtime.onGameFinished(games.at(0));
+    playtime.onGameLaunched(library, games.at(0));
+    playtime.onGameFinished(library, games.at(0));
 
     QVERIFY(spy_start.count() || spy_start.wait());
     QVERIFY(spy_end.count() || spy_end.wait());
     QCOMPARE(spy_start.count(), 1);
     QCOMPARE(spy_end.count(), 1);
 
-    QCOMPARE(games.at(0)->property("playCount").toInt(), 1);
+    QCOMPARE(library.object(games.at(0))->property("playCount").toInt(), 1);
 }
 
 void test_Playtime::write_queue()
 {
-    QVector<model::Game*> games;
+    model::GameLibrary library;
+    QVector<model::GameSlot> games;
     QVector<model::Collection*> collections;
-    HashMap<QString, model::Game*> modelgame_map;
-    create_dummy_data(games, collections, modelgame_map, this);
+    HashMap<QString, model::GameSlot> slot_map;
+    create_dummy_data(library, games, collections, slot_map);
 
     QTemporaryFile db_file;
     QVERIFY(db_file.open());
@@ -130,14 +136,14 @@ void test_Playtime::write_queue()
     QVERIFY(spy_start.isValid() && spy_end.isValid());
 
 
-    playtime.onGameLaunched(games.at(0));
-    playtime.onGameFinished(games.at(0));
+    playtime.onGameLaunched(library, games.at(0));
+    playtime.onGameFinished(library, games.at(0));
 
-    playtime.onGameLaunched(games.at(0));
-    playtime.onGameFinished(games.at(0));
+    playtime.onGameLaunched(library, games.at(0));
+    playtime.onGameFinished(library, games.at(0));
 
-    playtime.onGameLaunched(games.at(0));
-    playtime.onGameFinished(games.at(0));
+    playtime.onGameLaunched(library, games.at(0));
+    playtime.onGameFinished(library, games.at(0));
 
 
     QVERIFY(spy_start.count() || spy_start.wait());
@@ -145,7 +151,7 @@ void test_Playtime::write_queue()
     QCOMPARE(spy_start.count(), 1);
     QCOMPARE(spy_end.count(), 1);
 
-    QCOMPARE(games.at(0)->property("playCount").toInt(), 3);
+    QCOMPARE(library.object(games.at(0))->property("playCount").toInt(), 3);
 }
 
 
@@ -4,3 +4,8 @@ SUBDIRS += \
     pegasus \
     favorites \
     playtime \
+    snapshot \
+    modelsync \
+    gamefilter \
+    assetresolver \
+    mediaroots \
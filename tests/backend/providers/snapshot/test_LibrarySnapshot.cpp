@@ -0,0 +1,188 @@
+// Pegasus Frontend
+// Copyright (C) 2018  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <QtTest/QtTest>
+
+#include "modeldata/gaming/CollectionData.h"
+#include "modeldata/gaming/GameData.h"
+#include "modeldata/gaming/GameStore.h"
+#include "providers/LibrarySnapshot.h"
+#include "utils/HashMap.h"
+
+
+class test_LibrarySnapshot : public QObject {
+    Q_OBJECT
+
+private:
+    modeldata::GameStore games;
+    HashMap<QString, modeldata::Collection> collections;
+    HashMap<QString, std::vector<modeldata::GameId>> collection_childs;
+
+    QString tmp_path();
+
+private slots:
+    void init();
+
+    void roundtrip();
+    void deterministic();
+    void corrupt();
+    void missing();
+};
+
+QString test_LibrarySnapshot::tmp_path()
+{
+    QTemporaryFile tmp_file;
+    tmp_file.setAutoRemove(false);
+    if (!tmp_file.open())
+        return QString();
+
+    return tmp_file.fileName();
+}
+
+void test_LibrarySnapshot::init()
+{
+    games.clear();
+    collections.clear();
+    collection_childs.clear();
+
+    modeldata::Collection coll(QStringLiteral("My Games"));
+    coll.setShortName(QStringLiteral("mygames"));
+    coll.launch_cmd = QStringLiteral("emu {file.path}");
+    coll.default_assets.addUrlMaybe(AssetType::BACKGROUND, QStringLiteral("file:///bg.png"));
+    collections.emplace(QStringLiteral("My Games"), std::move(coll));
+
+    modeldata::Game game_a(QFileInfo(QStringLiteral("/roms/a.bin")));
+    game_a.title = QStringLiteral("Game A");
+    game_a.player_count = 4;
+    game_a.rating = 0.5f;
+    game_a.release_date = QDate(1999, 12, 31);
+    game_a.developers << QStringLiteral("Dev 1") << QStringLiteral("Dev 2");
+    game_a.setExtra(QStringLiteral("gog.id"), QStringLiteral("1234"));
+    game_a.assets.addUrlMaybe(AssetType::BOX_FRONT, QStringLiteral("file:///a.png"));
+    game_a.assets.addUrlMaybe(AssetType::SCREENSHOTS, QStringLiteral("file:///a1.png"));
+    game_a.assets.addUrlMaybe(AssetType::SCREENSHOTS, QStringLiteral("file:///a2.png"));
+    const modeldata::GameId id_a = games.add(QStringLiteral("/roms/a.bin"), std::move(game_a));
+
+    const modeldata::GameId id_b = games.add(QStringLiteral("/roms/b.bin"),
+                                             modeldata::Game(QFileInfo(QStringLiteral("/roms/b.bin"))));
+
+    collection_childs[QStringLiteral("My Games")] = { id_b, id_a };
+}
+
+void test_LibrarySnapshot::roundtrip()
+{
+    const QString path = tmp_path();
+    QVERIFY(!path.isEmpty());
+
+    const QByteArray payload = providers::snapshot::serialize(games, collections, collection_childs);
+    QVERIFY(providers::snapshot::write(path, payload));
+
+    modeldata::GameStore read_games;
+    HashMap<QString, modeldata::Collection> read_collections;
+    HashMap<QString, std::vector<modeldata::GameId>> read_childs;
+    const QByteArray checksum = providers::snapshot::read(path, read_games, read_collections, read_childs);
+    QFile::remove(path);
+
+    QCOMPARE(checksum, providers::snapshot::checksum(payload));
+    QCOMPARE(read_games.size(), games.size());
+    QCOMPARE(read_collections.size(), collections.size());
+    QCOMPARE(read_childs.size(), collection_childs.size());
+
+    const modeldata::Collection& coll = read_collections.at(QStringLiteral("My Games"));
+    QCOMPARE(coll.shortName(), QStringLiteral("mygames"));
+    QCOMPARE(coll.launch_cmd, QStringLiteral("emu {file.path}"));
+
+    const modeldata::GameId game_id = read_games.find(QStringLiteral("/roms/a.bin"));
+    QVERIFY(game_id != modeldata::INVALID_GAMEID);
+    const modeldata::Game& game = read_games.at(game_id);
+    QCOMPARE(game.path().filePath(), QStringLiteral("/roms/a.bin"));
+    QCOMPARE(game.title, QStringLiteral("Game A"));
+    QCOMPARE(game.player_count, 4);
+    QCOMPARE(game.rating, 0.5f);
+    QCOMPARE(game.release_date, QDate(1999, 12, 31));
+    QCOMPARE(game.developers.toStringList(), QStringList({ QStringLiteral("Dev 1"), QStringLiteral("Dev 2") }));
+    QCOMPARE(game.extra(QStringLiteral("gog.id")), QStringLiteral("1234"));
+    QCOMPARE(game.assets.single(AssetType::BOX_FRONT).url(), QStringLiteral("file:///a.png"));
+    QCOMPARE(game.assets.multi(AssetType::SCREENSHOTS).size(), 2);
+
+    // the order of children should be kept
+    QCOMPARE(read_childs.at(QStringLiteral("My Games")), collection_childs.at(QStringLiteral("My Games")));
+
+    // and the reread data should produce the same output
+    QCOMPARE(providers::snapshot::serialize(read_games, read_collections, read_childs), payload);
+}
+
+void test_LibrarySnapshot::deterministic()
+{
+    const QByteArray payload = providers::snapshot::serialize(games, collections, collection_childs);
+
+    // the same games, added in a different order
+    modeldata::GameStore games_copy;
+    HashMap<QString, std::vector<modeldata::GameId>> childs_copy;
+    std::vector<modeldata::GameId> new_ids(games.size());
+    for (modeldata::GameId game_id = games.size(); game_id-- > 0;)
+        new_ids[game_id] = games_copy.add(games.key(game_id), std::move(games.at(game_id)));
+    for (const auto& entry : collection_childs) {
+        std::vector<modeldata::GameId>& childs = childs_copy[entry.first];
+        for (const modeldata::GameId game_id : entry.second)
+            childs.push_back(new_ids[game_id]);
+    }
+
+    QCOMPARE(providers::snapshot::serialize(games_copy, collections, childs_copy), payload);
+}
+
+void test_LibrarySnapshot::corrupt()
+{
+    const QString path = tmp_path();
+    QVERIFY(!path.isEmpty());
+
+    const QByteArray payload = providers::snapshot::serialize(games, collections, collection_childs);
+    QVERIFY(providers::snapshot::write(path, payload));
+    {
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::ReadWrite));
+        QVERIFY(file.seek(file.size() - 4));
+        file.write("XXXX");
+    }
+
+    modeldata::GameStore read_games;
+    HashMap<QString, modeldata::Collection> read_collections;
+    HashMap<QString, std::vector<modeldata::GameId>> read_childs;
+    const QByteArray checksum = providers::snapshot::read(path, read_games, read_collections, read_childs);
+    QFile::remove(path);
+
+    QVERIFY(checksum.isEmpty());
+    QVERIFY(read_games.empty());
+    QVERIFY(read_collections.empty());
+    QVERIFY(read_childs.empty());
+}
+
+void test_LibrarySnapshot::missing()
+{
+    modeldata::GameStore read_games;
+    HashMap<QString, modeldata::Collection> read_collections;
+    HashMap<QString, std::vector<modeldata::GameId>> read_childs;
+    const QByteArray checksum = providers::snapshot::read(QStringLiteral(":/nonexistent"),
+                                                          read_games, read_collections, read_childs);
+
+    QVERIFY(checksum.isEmpty());
+    QVERIFY(read_games.empty());
+}
+
+
+QTEST_MAIN(test_LibrarySnapshot)
+#include "test_LibrarySnapshot.moc"
@@ -0,0 +1,112 @@
+// Pegasus Frontend
+// Copyright (C) 2018  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <QtTest/QtTest>
+
+#include "Trace.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+
+class test_Trace : public QObject {
+    Q_OBJECT
+
+private:
+    QJsonArray read_events(const QString& path);
+
+private slots:
+    void disabled();
+    void scopes_and_counters();
+};
+
+QJsonArray test_Trace::read_events(const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return {};
+
+    return QJsonDocument::fromJson(file.readAll()).object().value(QStringLiteral("traceEvents")).toArray();
+}
+
+void test_Trace::disabled()
+{
+    QVERIFY(!Trace::enabled());
+
+    TRACE_SCOPE("nothing");
+    TRACE_COUNT("nothing", 1);
+
+    // the detail should not be built at all
+    bool detail_built = false;
+    const auto make_detail = [&detail_built]{ detail_built = true; return QStringLiteral("detail"); };
+    TRACE_SCOPE("nothing", make_detail());
+    QVERIFY(!detail_built);
+
+    // finishing without starting should not write anything
+    Trace::finish();
+}
+
+void test_Trace::scopes_and_counters()
+{
+    QTemporaryDir tmp_dir;
+    QVERIFY(tmp_dir.isValid());
+    const QString path = tmp_dir.path() + QStringLiteral("/trace.json");
+
+    Trace::start(path);
+    QVERIFY(Trace::enabled());
+    {
+        TRACE_SCOPE("outer");
+        TRACE_SCOPE("inner", QStringLiteral("some detail"));
+        TRACE_COUNT("items", 2);
+        TRACE_COUNT("items", 3);
+    }
+    Trace::finish();
+    QVERIFY(!Trace::enabled());
+
+    const QJsonArray events = read_events(path);
+    QVERIFY(!events.isEmpty());
+
+    QStringList complete_names;
+    QVector<qint64> counter_values;
+    for (const QJsonValue& value : events) {
+        const QJsonObject event = value.toObject();
+        const QString phase = event.value(QStringLiteral("ph")).toString();
+
+        if (phase == QLatin1String("X")) {
+            complete_names << event.value(QStringLiteral("name")).toString();
+            QVERIFY(event.value(QStringLiteral("dur")).toDouble() >= 0.0);
+        }
+        if (phase == QLatin1String("C")) {
+            QCOMPARE(event.value(QStringLiteral("name")).toString(), QStringLiteral("items"));
+            counter_values << static_cast<qint64>(event.value(QStringLiteral("args")).toObject()
+                                                  .value(QStringLiteral("value")).toDouble());
+        }
+        if (event.value(QStringLiteral("name")).toString() == QLatin1String("inner")) {
+            QCOMPARE(event.value(QStringLiteral("args")).toObject().value(QStringLiteral("detail")).toString(),
+                     QStringLiteral("some detail"));
+        }
+    }
+
+    // the inner scope ends first
+    QCOMPARE(complete_names, QStringList({"inner", "outer"}));
+    QCOMPARE(counter_values, QVector<qint64>({2, 5}));
+}
+
+
+QTEST_MAIN(test_Trace)
+#include "test_Trace.moc"
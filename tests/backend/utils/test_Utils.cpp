@@ -17,7 +17,11 @@
 
 #include <QtTest/QtTest>
 
+#include "utils/Collation.h"
+#include "utils/MemoryUsage.h"
+#include "utils/MonotonicArena.h"
 #include "utils/PathCheck.h"
+#include "utils/StringIntern.h"
 
 
 class test_Utils : public QObject
@@ -27,6 +31,16 @@ class test_Utils : public QObject
 private slots:
     void validExtPath_data();
     void validExtPath();
+
+    void collation_sort();
+    void collation_keys_parallel();
+
+    void heap_size_strings();
+    void heap_size_containers();
+
+    void interned_string_list();
+
+    void monotonic_arena();
 };
 
 void test_Utils::validExtPath_data()
@@ -49,6 +63,137 @@ void test_Utils::validExtPath()
     QCOMPARE(::validExtPath(path), result);
 }
 
+void test_Utils::collation_sort()
+{
+    const QLocale old_locale;
+    QLocale::setDefault(QLocale(QLocale::English, QLocale::UnitedStates));
+
+    // numbers first, then letters regardless of their case, with the accented
+    // ones right after their base letter
+    QStringList items { "Z", QStringLiteral("\u00e9"), "a", "2", "B", "e", "1", "f" };
+    ::collation_sort(items, [](const QString& str){ return str; });
+
+    QLocale::setDefault(old_locale);
+
+    const QStringList expected { "1", "2", "a", "B", "e", QStringLiteral("\u00e9"), "f", "Z" };
+    QCOMPARE(items, expected);
+}
+
+void test_Utils::collation_keys_parallel()
+{
+    // large enough to be split between threads
+    std::vector<QString> texts;
+    for (int i = 9999; i >= 0; i--)
+        texts.push_back(QStringLiteral("title %1").arg(i, 4, 10, QChar('0')));
+
+    const std::vector<QCollatorSortKey> keys = ::collation_keys(texts);
+    QCOMPARE(keys.size(), texts.size());
+
+    const std::vector<size_t> order = ::collation_order(keys);
+    for (size_t i = 0; i < order.size(); i++)
+        QCOMPARE(order[i], texts.size() - 1 - i);
+}
+
+void test_Utils::heap_size_strings()
+{
+    QCOMPARE(::heap_size(QString()), static_cast<size_t>(0));
+    QCOMPARE(::heap_size(QStringLiteral("literal")), static_cast<size_t>(0));
+
+    const QString text(100, QChar('a'));
+    QVERIFY(::heap_size(text) >= 100 * sizeof(QChar));
+    QCOMPARE(::heap_size(QVariant(text)), ::heap_size(text));
+
+    const QStringList list { text, text.left(50) };
+    QVERIFY(::heap_size(list) > ::heap_size(list.first()) + ::heap_size(list.last()));
+}
+
+void test_Utils::heap_size_containers()
+{
+    HashMap<QString, QString> map;
+    const size_t empty_size = ::hashmap_heap_size(map);
+    map.emplace(QStringLiteral("a"), QStringLiteral("b"));
+    QVERIFY(::hashmap_heap_size(map) > empty_size);
+
+    const QString text(100, QChar('a'));
+    const QVariantMap vmap {
+        { QStringLiteral("key"), text },
+        { QStringLiteral("number"), 5 },
+    };
+    QVERIFY(::heap_size(vmap) > ::heap_size(text));
+    QVERIFY(::heap_size(QVariant(vmap)) == ::heap_size(vmap));
+}
+
+void test_Utils::interned_string_list()
+{
+    const StringId id = ::string_id(QStringLiteral("Some Developer"));
+    QCOMPARE(::string_id(QStringLiteral("Some Developer")), id);
+    QVERIFY(::string_id(QStringLiteral("Other Developer")) != id);
+    QCOMPARE(::string_by_id(id), QStringLiteral("Some Developer"));
+
+    InternedStringList list;
+    list << QStringLiteral("Some Developer") << QString() << QStringLiteral("Other Developer");
+    QCOMPARE(list.count(), 2);
+    QVERIFY(list.contains(id));
+    QCOMPARE(list.toStringList(), QStringList({ "Some Developer", "Other Developer" }));
+    QCOMPARE(list.join(QStringLiteral(", ")), QStringLiteral("Some Developer, Other Developer"));
+
+    QByteArray bytes;
+    {
+        QDataStream out(&bytes, QIODevice::WriteOnly);
+        out << list;
+    }
+    InternedStringList copy;
+    {
+        QDataStream in(bytes);
+        in >> copy;
+    }
+    QCOMPARE(copy, list);
+
+    // only the strings of the passed lists are kept, with new IDs
+    InternedStringList kept;
+    kept << QStringLiteral("Other Developer");
+    ::string_id(QStringLiteral("Unused Developer"));
+    ::compact_string_table({ &kept });
+    QCOMPARE(kept.toStringList(), QStringList({ "Other Developer" }));
+    QCOMPARE(kept.ids().first(), static_cast<StringId>(0));
+    QCOMPARE(::string_id(QStringLiteral("Other Developer")), static_cast<StringId>(0));
+    QCOMPARE(::string_id(QStringLiteral("Unused Developer")), static_cast<StringId>(1));
+}
+
+void test_Utils::monotonic_arena()
+{
+    MonotonicArena arena(256);
+    QCOMPARE(arena.allocatedSize(), static_cast<size_t>(0));
+
+    for (size_t alignment : { 1, 2, 8, 16 }) {
+        const void* const ptr = arena.allocate(3, alignment);
+        QCOMPARE(reinterpret_cast<std::uintptr_t>(ptr) % alignment, static_cast<std::uintptr_t>(0));
+    }
+    QCOMPARE(arena.allocatedSize(), static_cast<size_t>(256));
+
+    // larger than a block
+    arena.allocate(1000, 8);
+    QVERIFY(arena.allocatedSize() >= 256 + 1000);
+
+    {
+        auto map = arena_hashmap<QString, int>(arena);
+        for (int i = 0; i < 100; i++)
+            map.emplace(QString::number(i), i);
+
+        QCOMPARE(map.size(), static_cast<size_t>(100));
+        QCOMPARE(map.at(QStringLiteral("42")), 42);
+    }
+
+    arena.release();
+    QCOMPARE(arena.allocatedSize(), static_cast<size_t>(0));
+
+    // the padding for the alignment doesn't fit in the rest of the block
+    MonotonicArena small_arena(64);
+    small_arena.allocate(49, 1);
+    small_arena.allocate(1, 32);
+    QCOMPARE(small_arena.allocatedSize(), static_cast<size_t>(128));
+}
+
 
 QTEST_MAIN(test_Utils)
 #include "test_Utils.moc"
@@ -2,4 +2,6 @@ TEMPLATE = subdirs
 
 SUBDIRS += \
     configfile \
+    game_filter \
+    library_scan \
     pegasus_provider \
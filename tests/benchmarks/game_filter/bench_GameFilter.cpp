@@ -0,0 +1,112 @@
+// Pegasus Frontend
+// Copyright (C) 2018  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <QtTest/QtTest>
+
+#include "providers/pegasus/PegasusFilter.h"
+
+
+using providers::pegasus::GameFilter;
+
+namespace {
+const QString FILTER_DIR = QStringLiteral("/games/arcade");
+
+// every second file is listed in the filter
+QStringList listed_files(int count)
+{
+    QStringList files;
+    files.reserve(count);
+    for (int i = 0; i < count; i++)
+        files << QStringLiteral("game%1.zip").arg(i * 2);
+
+    return files;
+}
+
+QStringList candidate_paths(int count)
+{
+    QStringList paths;
+    paths.reserve(count);
+    for (int i = 0; i < count; i++)
+        paths << FILTER_DIR + QStringLiteral("/game%1.zip").arg(i);
+
+    return paths;
+}
+
+int count_accepted(const GameFilter& filter, const QStringList& paths)
+{
+    int accepted = 0;
+    for (const QString& path : paths) {
+        const QStringRef suffix = path.midRef(path.lastIndexOf(QLatin1Char('.')) + 1);
+        if (filter.accepts(FILTER_DIR, path, suffix))
+            accepted++;
+    }
+    return accepted;
+}
+} // namespace
+
+
+class bench_GameFilter : public QObject {
+    Q_OBJECT
+
+private slots:
+    void explicit_files_data();
+    void explicit_files();
+    void globs_and_regex();
+};
+
+void bench_GameFilter::explicit_files_data()
+{
+    QTest::addColumn<int>("file_count");
+
+    QTest::newRow("100 files") << 100;
+    QTest::newRow("5000 files") << 5000;
+    QTest::newRow("50000 files") << 50000;
+}
+
+void bench_GameFilter::explicit_files()
+{
+    QFETCH(int, file_count);
+
+    GameFilter filter(QStringLiteral("arcade"), FILTER_DIR);
+    filter.include.files = listed_files(file_count);
+    filter.compile();
+
+    const QStringList paths = candidate_paths(file_count * 2);
+    int accepted = 0;
+    QBENCHMARK {
+        accepted = count_accepted(filter, paths);
+    }
+    QCOMPARE(accepted, file_count);
+}
+
+void bench_GameFilter::globs_and_regex()
+{
+    GameFilter filter(QStringLiteral("arcade"), FILTER_DIR);
+    filter.include.file_globs << QStringLiteral("game1*.zip") << QStringLiteral("**/disc[12].cue");
+    filter.include.regex.setPattern(QStringLiteral("game\\d*5\\.zip$"));
+    filter.exclude.regex.setPattern(QStringLiteral("\\(bios\\)"));
+    filter.compile();
+
+    const QStringList paths = candidate_paths(50000);
+    QBENCHMARK {
+        count_accepted(filter, paths);
+    }
+}
+
+
+QTEST_MAIN(bench_GameFilter)
+#include "bench_GameFilter.moc"
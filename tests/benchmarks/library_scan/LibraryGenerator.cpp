@@ -0,0 +1,370 @@
+// Pegasus Frontend
+// Copyright (C) 2018  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#include "LibraryGenerator.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QStringBuilder>
+#include <QStringList>
+#include <QTextStream>
+#include <algorithm>
+#include <random>
+
+
+namespace {
+const QStringList TITLE_WORDS_A {
+    QStringLiteral("Super"), QStringLiteral("Mega"), QStringLiteral("Final"), QStringLiteral("Dark"),
+    QStringLiteral("Legend of"), QStringLiteral("Return to"), QStringLiteral("Space"), QStringLiteral("Street"),
+    QStringLiteral("Ultimate"), QStringLiteral("Tiny"), QStringLiteral("Crystal"), QStringLiteral("Électro"),
+    QStringLiteral("The"), QStringLiteral("Neo"), QStringLiteral("Zombie"), QStringLiteral("Äther"),
+};
+const QStringList TITLE_WORDS_B {
+    QStringLiteral("Fighter"), QStringLiteral("Quest"), QStringLiteral("Racer"), QStringLiteral("Kart"),
+    QStringLiteral("Warriors"), QStringLiteral("Island"), QStringLiteral("Dungeon"), QStringLiteral("Soccer"),
+    QStringLiteral("Invaders"), QStringLiteral("Pinball"), QStringLiteral("Tactics"), QStringLiteral("Ninja"),
+    QStringLiteral("Odyssey"), QStringLiteral("Golf"), QStringLiteral("Chronicles"), QStringLiteral("Blaster"),
+};
+const QStringList TITLE_SUFFIXES {
+    QString(), QString(), QString(), QStringLiteral(" II"), QStringLiteral(" III"),
+    QStringLiteral(" 64"), QStringLiteral(": Turbo Edition"), QStringLiteral(" (USA)"), QStringLiteral(" (Europe)"),
+};
+const QStringList GENRES {
+    QStringLiteral("Action"), QStringLiteral("Platform"), QStringLiteral("Racing"), QStringLiteral("Puzzle"),
+    QStringLiteral("Shooter"), QStringLiteral("Sports"), QStringLiteral("Strategy"), QStringLiteral("RPG"),
+};
+const QString DESCRIPTION = QStringLiteral(
+    "An exciting adventure full of challenges, secrets and hidden worlds to discover. "
+    "Play alone or with friends, collect the treasures and defeat the final boss. "
+    "Features dozens of levels, multiple endings and a memorable soundtrack.");
+
+
+class Generator {
+public:
+    Generator(const QString& root, const LibrarySpec& spec, LibraryStats& stats)
+        : m_root(root)
+        , m_spec(spec)
+        , m_stats(stats)
+        , m_rng(20180601)
+        , m_ok(true)
+    {}
+
+    bool run();
+
+private:
+    const QString m_root;
+    const LibrarySpec& m_spec;
+    LibraryStats& m_stats;
+    std::minstd_rand m_rng;
+    bool m_ok;
+
+    int random(int min, int max) { return std::uniform_int_distribution<int>(min, max)(m_rng); }
+    template<typename T> const T& pick(const QList<T>& list) { return list.at(random(0, list.size() - 1)); }
+    QString random_title();
+
+    void make_dir(const QString& path);
+    void write_file(const QString& path, const QString& content);
+    void touch(const QString& path);
+
+    void generate_pegasus(int game_count);
+    void generate_pegasus_dir(const QString& dir_path, int coll_idx, int game_count, int first_game_no);
+    void generate_es2(int game_count);
+    void generate_steam(int game_count);
+};
+
+QString Generator::random_title()
+{
+    return pick(TITLE_WORDS_A) % ' ' % pick(TITLE_WORDS_B) % pick(TITLE_SUFFIXES);
+}
+
+void Generator::make_dir(const QString& path)
+{
+    if (!QDir().mkpath(path)) {
+        qWarning().noquote() << QStringLiteral("could not create `%1`").arg(path);
+        m_ok = false;
+    }
+}
+
+void Generator::write_file(const QString& path, const QString& content)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(content.toUtf8()) < 0) {
+        qWarning().noquote() << QStringLiteral("could not write `%1`").arg(path);
+        m_ok = false;
+        return;
+    }
+    m_stats.file_count++;
+}
+
+void Generator::touch(const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning().noquote() << QStringLiteral("could not create `%1`").arg(path);
+        m_ok = false;
+        return;
+    }
+    m_stats.file_count++;
+}
+
+bool Generator::run()
+{
+    if (!QDir(m_root).removeRecursively()) {
+        qWarning().noquote() << QStringLiteral("could not clear `%1`").arg(m_root);
+        return false;
+    }
+
+    make_dir(m_root % QStringLiteral("/home"));
+    make_dir(m_root % QStringLiteral("/config/pegasus-frontend"));
+    make_dir(m_root % QStringLiteral("/cache/pegasus-frontend"));
+    make_dir(m_root % QStringLiteral("/data"));
+
+    const int es2_games = m_spec.game_count * m_spec.es2_percent / 100;
+    const int steam_games = m_spec.game_count * m_spec.steam_percent / 100;
+    const int pegasus_games = m_spec.game_count - es2_games - steam_games;
+
+    generate_pegasus(pegasus_games);
+    generate_es2(es2_games);
+    generate_steam(steam_games);
+
+    return m_ok;
+}
+
+void Generator::generate_pegasus(const int game_count)
+{
+    const int coll_count = std::max(1, m_spec.pegasus_collections);
+
+    QString game_dirs;
+    int first_game_no = 0;
+    for (int coll_idx = 0; coll_idx < coll_count; coll_idx++) {
+        const int coll_games = game_count * (coll_idx + 1) / coll_count - game_count * coll_idx / coll_count;
+        const QString dir_path = m_root % QStringLiteral("/library/pegasus/coll%1").arg(coll_idx, 3, 10, QChar('0'));
+
+        generate_pegasus_dir(dir_path, coll_idx, coll_games, first_game_no);
+        game_dirs += dir_path % '\n';
+        first_game_no += coll_games;
+    }
+
+    write_file(m_root % QStringLiteral("/config/pegasus-frontend/game_dirs.txt"), game_dirs);
+    m_stats.pegasus_games += game_count;
+    m_stats.collection_count += coll_count;
+}
+
+void Generator::generate_pegasus_dir(const QString& dir_path, const int coll_idx,
+                                     const int game_count, const int first_game_no)
+{
+    make_dir(dir_path);
+
+    write_file(dir_path % QStringLiteral("/collections.txt"), QStringLiteral(
+        "collection: Collection %1\n"
+        "shortname: coll%1\n"
+        "extensions: bin, iso\n"
+        "ignore-extensions: sav\n"
+        "launch: emulator --fullscreen {file.path}\n").arg(coll_idx));
+
+    QString metadata;
+    QTextStream meta_stream(&metadata);
+
+    QString curr_subdir;
+    for (int i = 0; i < game_count; i++) {
+        // nested directories, eg. `part03/disk12`
+        const int dir_no = i / std::max(1, m_spec.files_per_dir);
+        const QString rel_dir = QStringLiteral("part%1/disk%2")
+            .arg(dir_no / 16, 2, 10, QChar('0'))
+            .arg(dir_no % 16, 2, 10, QChar('0'));
+        if (rel_dir != curr_subdir) {
+            make_dir(dir_path % '/' % rel_dir);
+            curr_subdir = rel_dir;
+        }
+
+        const QString basename = QStringLiteral("game%1").arg(first_game_no + i, 7, 10, QChar('0'));
+        const QString rel_path = rel_dir % '/' % basename % QStringLiteral(".bin");
+        touch(dir_path % '/' % rel_path);
+
+        // some non-game files too
+        if (i % 10 == 0)
+            touch(dir_path % '/' % rel_dir % '/' % basename % QStringLiteral(".sav"));
+
+        if (m_spec.media_every > 0 && i % m_spec.media_every == 0) {
+            const QString media_dir = dir_path % QStringLiteral("/media/") % rel_dir % '/' % basename;
+            make_dir(media_dir);
+            touch(media_dir % QStringLiteral("/boxFront.png"));
+            touch(media_dir % QStringLiteral("/logo.png"));
+            touch(media_dir % QStringLiteral("/screenshot.jpg"));
+        }
+
+        meta_stream << "file: " << rel_path << '\n'
+                    << "title: " << random_title() << '\n'
+                    << "developer: Studio " << random(1, 500) << '\n'
+                    << "publisher: Publisher " << random(1, 100) << '\n'
+                    << "genre: " << pick(GENRES) << ", " << pick(GENRES) << '\n'
+                    << "players: 1-" << random(1, 4) << '\n'
+                    << "release: " << random(1980, 2018) << '-' << random(1, 12) << '-' << random(1, 28) << '\n'
+                    << "rating: " << random(0, 100) << "%\n"
+                    << "description: " << DESCRIPTION << "\n\n";
+    }
+
+    meta_stream.flush();
+    write_file(dir_path % QStringLiteral("/metadata.txt"), metadata);
+}
+
+void Generator::generate_es2(const int game_count)
+{
+    const int system_count = std::max(1, m_spec.es2_systems);
+    const QString es_dir = m_root % QStringLiteral("/home/.emulationstation");
+    make_dir(es_dir);
+
+    QString systems;
+    QTextStream systems_stream(&systems);
+    systems_stream << "<?xml version=\"1.0\"?>\n<systemList>\n";
+
+    for (int sys_idx = 0; sys_idx < system_count; sys_idx++) {
+        const int sys_games = game_count * (sys_idx + 1) / system_count - game_count * sys_idx / system_count;
+        const QString shortname = QStringLiteral("sys%1").arg(sys_idx, 2, 10, QChar('0'));
+        const QString dir_path = m_root % QStringLiteral("/library/es2/") % shortname;
+        make_dir(dir_path % QStringLiteral("/images"));
+
+        systems_stream << "  <system>\n"
+                       << "    <name>" << shortname << "</name>\n"
+                       << "    <fullname>System " << sys_idx << "</fullname>\n"
+                       << "    <path>" << dir_path << "</path>\n"
+                       << "    <extension>.zip .ZIP .7z</extension>\n"
+                       << "    <command>emulator %ROM%</command>\n"
+                       << "  </system>\n";
+
+        QString gamelist;
+        QTextStream gamelist_stream(&gamelist);
+        gamelist_stream << "<?xml version=\"1.0\"?>\n<gameList>\n";
+
+        for (int i = 0; i < sys_games; i++) {
+            const QString basename = QStringLiteral("rom%1").arg(i, 6, 10, QChar('0'));
+            touch(dir_path % '/' % basename % QStringLiteral(".zip"));
+
+            gamelist_stream << "  <game>\n"
+                            << "    <path>./" << basename << ".zip</path>\n"
+                            << "    <name>" << random_title() << "</name>\n"
+                            << "    <desc>" << DESCRIPTION << "</desc>\n"
+                            << "    <rating>0." << random(0, 9) << "</rating>\n"
+                            << "    <releasedate>" << random(1980, 2018) << "0101T000000</releasedate>\n"
+                            << "    <developer>Studio " << random(1, 500) << "</developer>\n"
+                            << "    <publisher>Publisher " << random(1, 100) << "</publisher>\n"
+                            << "    <genre>" << pick(GENRES) << "</genre>\n"
+                            << "    <players>" << random(1, 4) << "</players>\n";
+            if (m_spec.media_every > 0 && i % m_spec.media_every == 0) {
+                const QString image_name = basename % QStringLiteral("-image.png");
+                touch(dir_path % QStringLiteral("/images/") % image_name);
+                gamelist_stream << "    <image>./images/" << image_name << "</image>\n";
+            }
+            gamelist_stream << "  </game>\n";
+        }
+
+        gamelist_stream << "</gameList>\n";
+        gamelist_stream.flush();
+        write_file(dir_path % QStringLiteral("/gamelist.xml"), gamelist);
+    }
+
+    systems_stream << "</systemList>\n";
+    systems_stream.flush();
+    write_file(es_dir % QStringLiteral("/es_systems.cfg"), systems);
+
+    m_stats.es2_games += game_count;
+    m_stats.collection_count += system_count;
+}
+
+void Generator::generate_steam(const int game_count)
+{
+    if (game_count <= 0)
+        return;
+
+    const QString apps_dir = m_root % QStringLiteral("/data/Steam/steamapps");
+    const QString cache_dir = m_root % QStringLiteral("/cache/pegasus-frontend/steam");
+    make_dir(apps_dir);
+    make_dir(cache_dir);
+
+    for (int i = 0; i < game_count; i++) {
+        const QString appid = QString::number(100000 + i);
+        const QString title = random_title();
+
+        write_file(apps_dir % QStringLiteral("/appmanifest_") % appid % QStringLiteral(".acf"), QStringLiteral(
+            "\"AppState\"\n"
+            "{\n"
+            "\t\"appid\"\t\t\"%1\"\n"
+            "\t\"Universe\"\t\t\"1\"\n"
+            "\t\"name\"\t\t\"%2\"\n"
+            "\t\"StateFlags\"\t\t\"4\"\n"
+            "}\n").arg(appid, title));
+
+        // the same format as the Steam store API
+        write_file(cache_dir % '/' % appid % QStringLiteral(".json"), QStringLiteral(
+            "{\"%1\": {\"success\": true, \"data\": {"
+            "\"name\": \"%2\", "
+            "\"short_description\": \"%3\", "
+            "\"about_the_game\": \"%3\", "
+            "\"header_image\": \"https://example.com/%1/header.jpg\", "
+            "\"developers\": [\"Studio %4\"], "
+            "\"publishers\": [\"Publisher %4\"], "
+            "\"release_date\": {\"date\": \"1 Jan, 2015\"}"
+            "}}}\n").arg(appid, title, DESCRIPTION, QString::number(i % 100)));
+    }
+
+    m_stats.steam_games += game_count;
+    m_stats.collection_count += 1;
+}
+} // namespace
+
+
+LibrarySpec::LibrarySpec(int game_count)
+    : game_count(game_count)
+    , pegasus_collections(std::max(1, game_count / 5000))
+    , es2_systems(std::max(1, std::min(50, game_count / 2000)))
+    , es2_percent(15)
+    , steam_percent(game_count >= 1000 ? 1 : 0)
+    , files_per_dir(250)
+    , media_every(4)
+{}
+
+LibraryStats::LibraryStats()
+    : pegasus_games(0)
+    , es2_games(0)
+    , steam_games(0)
+    , collection_count(0)
+    , file_count(0)
+{}
+
+
+namespace library_generator {
+
+bool generate(const QString& root, const LibrarySpec& spec, LibraryStats& stats)
+{
+    stats = LibraryStats();
+    return Generator(root, spec, stats).run();
+}
+
+void redirect_paths(const QString& root)
+{
+    qputenv("PEGASUS_HOME", QFile::encodeName(root % QStringLiteral("/home")));
+    qputenv("HOME", QFile::encodeName(root % QStringLiteral("/home")));
+    qputenv("XDG_CONFIG_HOME", QFile::encodeName(root % QStringLiteral("/config")));
+    qputenv("XDG_CONFIG_DIRS", QFile::encodeName(root % QStringLiteral("/config")));
+    qputenv("XDG_DATA_HOME", QFile::encodeName(root % QStringLiteral("/data")));
+    qputenv("XDG_DATA_DIRS", QFile::encodeName(root % QStringLiteral("/data")));
+    qputenv("XDG_CACHE_HOME", QFile::encodeName(root % QStringLiteral("/cache")));
+}
+
+} // namespace library_generator
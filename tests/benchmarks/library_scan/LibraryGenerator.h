@@ -0,0 +1,74 @@
+// Pegasus Frontend
+// Copyright (C) 2018  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#pragma once
+
+#include <QString>
+
+
+/// The shape of a generated game library
+struct LibrarySpec {
+    int game_count;
+    /// Number of Pegasus game directories, each with its own collection
+    int pegasus_collections;
+    /// Number of ES2 systems
+    int es2_systems;
+    /// Percentage of the games in the ES2 systems and in Steam; the rest is Pegasus
+    int es2_percent;
+    int steam_percent;
+    /// A new subdirectory is started after this many game files
+    int files_per_dir;
+    /// Every Nth game gets media files
+    int media_every;
+
+    /// Reasonable defaults for the number of games
+    explicit LibrarySpec(int game_count);
+};
+
+struct LibraryStats {
+    int pegasus_games;
+    int es2_games;
+    int steam_games;
+    int collection_count;
+    int file_count;
+
+    LibraryStats();
+};
+
+
+/// Generates realistic on-disk game libraries for benchmarking. Everything is created under
+/// a root directory, with the following structure:
+///
+/// - `home/`: the home directory, containing the ES2 config in `.emulationstation`
+/// - `config/pegasus-frontend/`: the config directory, with the list of game directories
+/// - `data/Steam/`: the Steam installation, with the app manifests
+/// - `cache/pegasus-frontend/`: the cached Steam metadata, so nothing is downloaded
+/// - `library/`: the games, with media files and metadata files
+///
+/// The generated content only depends on the spec, so the runs are reproducible.
+namespace library_generator {
+
+/// Replaces the contents of `root` with a new library. Returns false on failure.
+bool generate(const QString& root, const LibrarySpec&, LibraryStats&);
+
+/// Sets the environment so the program would look for its config, the
+/// game directories and the third party launchers under `root`.
+/// Has to be called before any of the paths are used.
+void redirect_paths(const QString& root);
+
+} // namespace library_generator
@@ -0,0 +1,157 @@
+// Pegasus Frontend
+// Copyright (C) 2018  Mátyás Mustoha
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#include <QtTest/QtTest>
+
+#include "LibraryGenerator.h"
+#include "model/gaming/Collection.h"
+#include "model/gaming/GameLibrary.h"
+#include "model/gaming/GameListModel.h"
+#include "providers/ProviderManager.h"
+
+#include "QtQmlTricks/QQmlObjectListModel.h"
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+#include <atomic>
+
+
+namespace {
+constexpr int SEARCH_TIMEOUT_MS = 30 * 60 * 1000;
+
+// Makes the next peak memory reading relative to the current usage (Linux only)
+void reset_peak_rss()
+{
+    QFile file(QStringLiteral("/proc/self/clear_refs"));
+    if (file.open(QIODevice::WriteOnly))
+        file.write("5");
+}
+
+// The peak resident memory of the process in KiB, or -1 if unknown (Linux only)
+qint64 peak_rss_kib()
+{
+    QFile file(QStringLiteral("/proc/self/status"));
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+        return -1;
+
+    while (!file.atEnd()) {
+        const QByteArray line = file.readLine();
+        if (line.startsWith("VmHWM:"))
+            return line.mid(6).trimmed().split(' ').first().toLongLong();
+    }
+    return -1;
+}
+} // namespace
+
+
+class bench_LibraryScan : public QObject {
+    Q_OBJECT
+
+private:
+    QTemporaryDir m_tmp_dir;
+    QString root() const { return m_tmp_dir.path() + QStringLiteral("/root"); }
+
+private slots:
+    void initTestCase();
+
+    void search_data();
+    void search();
+};
+
+void bench_LibraryScan::initTestCase()
+{
+#ifndef Q_OS_LINUX
+    QSKIP("The program can be pointed to the generated library only on Linux");
+#endif
+    QVERIFY(m_tmp_dir.isValid());
+
+    // the generated config and cache dirs use the real application name
+    QCoreApplication::setOrganizationName(QStringLiteral("pegasus-frontend"));
+    QCoreApplication::setApplicationName(QStringLiteral("pegasus-frontend"));
+    library_generator::redirect_paths(root());
+}
+
+void bench_LibraryScan::search_data()
+{
+    QTest::addColumn<int>("game_count");
+
+    QTest::newRow("10k games") << 10000;
+
+    // these take a lot of time and disk space to generate
+    if (qEnvironmentVariableIsSet("PEGASUS_BENCH_LARGE")) {
+        QTest::newRow("100k games") << 100000;
+        QTest::newRow("1M games") << 1000000;
+    }
+}
+
+void bench_LibraryScan::search()
+{
+    QFETCH(int, game_count);
+
+    LibraryStats stats;
+    QVERIFY(library_generator::generate(root(), LibrarySpec(game_count), stats));
+    qInfo().noquote() << QStringLiteral("generated %1 files").arg(stats.file_count);
+
+    reset_peak_rss();
+
+    model::GameLibrary game_library;
+    model::GameListModel game_model(game_library);
+    QQmlObjectListModel<model::Collection> collection_model;
+    ProviderManager providerman(this);
+    providerman.setCachesEnabled(false);
+    // the whole library is built at once in `build_ui_layer`
+    providerman.setStreamingEnabled(false);
+
+    // the phases run on a background thread
+    QElapsedTimer timer;
+    std::atomic<qint64> first_phase_ms(0);
+    std::atomic<qint64> second_phase_ms(0);
+    std::atomic<qint64> second_phase_end(0);
+    std::atomic<qint64> ui_layer_end(0);
+    connect(&providerman, &ProviderManager::firstPhaseComplete,
+            [&](qint64 ms){ first_phase_ms = ms; });
+    connect(&providerman, &ProviderManager::secondPhaseComplete,
+            [&](qint64 ms){ second_phase_ms = ms; second_phase_end = timer.elapsed(); });
+    connect(&providerman, &ProviderManager::staticDataReady,
+            [&](){ ui_layer_end = timer.elapsed(); });
+    QSignalSpy finished_spy(&providerman, &ProviderManager::thirdPhaseComplete);
+
+    timer.start();
+    providerman.startSearch(game_model, collection_model);
+    QTRY_VERIFY_WITH_TIMEOUT(!finished_spy.isEmpty(), SEARCH_TIMEOUT_MS);
+    const qint64 total_ms = timer.elapsed();
+    const qint64 third_phase_ms = finished_spy.first().first().toLongLong();
+    const qint64 peak_kib = peak_rss_kib();
+
+    QCOMPARE(game_model.count(), stats.pegasus_games + stats.es2_games + stats.steam_games);
+    QCOMPARE(collection_model.count(), stats.collection_count);
+
+    qInfo().noquote() << QStringLiteral(
+        "first phase: %1 ms, second phase: %2 ms, build_ui_layer (with the snapshot serialization): %3 ms, "
+        "third phase: %4 ms, total: %5 ms")
+        .arg(QString::number(first_phase_ms.load()), QString::number(second_phase_ms.load()),
+             QString::number(ui_layer_end.load() - second_phase_end.load()),
+             QString::number(third_phase_ms), QString::number(total_ms));
+    if (peak_kib >= 0)
+        qInfo().noquote() << QStringLiteral("peak memory: %1 MiB").arg(peak_kib / 1024);
+
+    QTest::setBenchmarkResult(total_ms, QTest::WalltimeMilliseconds);
+}
+
+
+QTEST_MAIN(bench_LibraryScan)
+#include "bench_LibraryScan.moc"
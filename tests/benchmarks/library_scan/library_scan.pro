@@ -0,0 +1,14 @@
+CONFIG += testcase no_testcase_installs
+
+QT += qml testlib
+CONFIG += c++11 warn_on exceptions_off
+
+TARGET = bench_LibraryScan
+SOURCES = \
+    $${TARGET}.cpp \
+    LibraryGenerator.cpp
+HEADERS = \
+    LibraryGenerator.h
+DEFINES *= $${COMMON_DEFINES}
+
+include($${TOP_SRCDIR}/src/link_to_backend.pri)
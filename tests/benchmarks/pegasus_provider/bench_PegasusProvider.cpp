@@ -20,6 +20,7 @@
 #include "providers/pegasus/PegasusProvider.h"
 #include "modeldata/gaming/CollectionData.h"
 #include "modeldata/gaming/GameData.h"
+#include "modeldata/gaming/GameStore.h"
 
 #include <QString>
 
@@ -34,9 +35,9 @@ private slots:
 
 void bench_PegasusProvider::find_in_empty_dir()
 {
-    HashMap<QString, modeldata::Game> games;
+    modeldata::GameStore games;
     HashMap<QString, modeldata::Collection> collections;
-    HashMap<QString, std::vector<QString>> collection_childs;
+    HashMap<QString, std::vector<modeldata::GameId>> collection_childs;
 
     providers::pegasus::PegasusProvider provider({QStringLiteral(":/empty")});
 
@@ -47,9 +48,9 @@ void bench_PegasusProvider::find_in_empty_dir()
 
 void bench_PegasusProvider::find_in_filled_dir()
 {
-    HashMap<QString, modeldata::Game> games;
+    modeldata::GameStore games;
     HashMap<QString, modeldata::Collection> collections;
-    HashMap<QString, std::vector<QString>> collection_childs;
+    HashMap<QString, std::vector<modeldata::GameId>> collection_childs;
 
     providers::pegasus::PegasusProvider provider({QStringLiteral(":/filled")});
 
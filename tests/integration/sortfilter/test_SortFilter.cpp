@@ -19,6 +19,8 @@
 
 #include "model/gaming/Collection.h"
 #include "model/gaming/Game.h"
+#include "model/gaming/GameLibrary.h"
+#include "model/gaming/GameListModel.h"
 
 #include "SortFilterProxyModel/qqmlsortfilterproxymodel.h"
 #include "SortFilterProxyModel/filters/filtersqmltypes.h"
@@ -46,6 +48,7 @@ public slots:
     }
 
 private:
+    model::GameLibrary m_library;
     QQmlObjectListModel<model::Collection> m_collection_model;
 
     void register_api() {
@@ -55,6 +58,7 @@ private:
         qmlRegisterUncreatableType<model::Collection>(api, 1, 0, "Collection", err);
         qmlRegisterUncreatableType<model::Game>(api, 1, 0, "Game", err);
         qmlRegisterUncreatableType<model::GameAssets>(api, 1, 0, "GameAssets", err);
+        qmlRegisterUncreatableType<model::GameListModel>(api, 1, 0, "GameListModel", err);
 
         qqsfpm::registerSorterTypes();
         qqsfpm::registerFiltersTypes();
@@ -63,12 +67,12 @@ private:
     }
 
     void create_model() {
-        QVector<model::Game*> games = {
-            new model::Game(modeldata::Game(QFileInfo("ccc"))),
-            new model::Game(modeldata::Game(QFileInfo("aaa"))),
-            new model::Game(modeldata::Game(QFileInfo("bbb"))),
+        QVector<model::GameSlot> games = {
+            m_library.add(modeldata::Game(QFileInfo("ccc"))),
+            m_library.add(modeldata::Game(QFileInfo("aaa"))),
+            m_library.add(modeldata::Game(QFileInfo("bbb"))),
         };
-        auto collection = new model::Collection(modeldata::Collection("test"), this);
+        auto collection = new model::Collection(modeldata::Collection("test"), m_library, this);
         collection->setGameList(std::move(games));
 
         m_collection_model.append(collection);